@@ -0,0 +1,116 @@
+/**
+ * @file   BitArena.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe BitArena.
+ */
+
+#ifndef BITARENA_HPP_
+#define BITARENA_HPP_
+
+#include "./ModelFile.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Classe responsável por armazenar, com um bit por endereço, as memórias densas de todos os
+	 * discriminadores de uma rede não cumulativa.
+	 * Cada discriminador ocupa uma posição (slot) do bloco. Os bits de todos os slots para o endereço
+	 * addr da memória ram ficam lado a lado, em getStrideBytes() bytes a partir de (ram * ramSize + addr) * getStrideBytes(),
+	 * de forma que uma única leitura obtém o bit de todos os discriminadores para aquele endereço.
+	 * A largura de cada endereço (1, 2, 4 ou um múltiplo de 8 bytes) cresce, para o bloco inteiro, quando
+	 * um novo slot deixa de caber.
+	 */
+	class BitArena
+	{
+		public:
+			/**
+			 * @brief Construtor da classe. Cria o bloco sem nenhum slot.
+			 * @param numRams Quantidade de memórias de cada discriminador.
+			 * @param ramSize Quantidade de endereços de cada memória.
+			 */
+			BitArena(int numRams, long long ramSize);
+
+			/**
+			 * @brief Adiciona um slot, com todos os bits zerados, alargando o bloco se necessário.
+			 * @return Índice do novo slot.
+			 */
+			int addSlot(void);
+
+			/**
+			 * @brief Retorna o bit de um slot em um endereço de uma memória.
+			 * @param slot Índice do slot.
+			 * @param ram Índice da memória.
+			 * @param addr Endereço
+			 */
+			inline bool get(int slot, int ram, long long addr) const
+			{
+				return (getSlots(ram, addr)[slot >> 3] >> (slot & 7)) & 1;
+			}
+
+			/**
+			 * @brief Ativa o bit de um slot em um endereço de uma memória.
+			 * @param slot Índice do slot.
+			 * @param ram Índice da memória.
+			 * @param addr Endereço
+			 */
+			inline void set(int slot, int ram, long long addr)
+			{
+				bits[((size_t) ram * (size_t) ramSize + (size_t) addr) * (size_t) strideBytes + (size_t) (slot >> 3)] |= (uint8_t) (1 << (slot & 7));
+			}
+
+			/**
+			 * @brief Retorna os bits de todos os slots em um endereço de uma memória: o bit do slot s
+			 * é o bit (s % 8) do byte (s / 8).
+			 * @param ram Índice da memória.
+			 * @param addr Endereço
+			 */
+			inline const uint8_t *getSlots(int ram, long long addr) const
+			{
+				return bits.data() + ((size_t) ram * (size_t) ramSize + (size_t) addr) * (size_t) strideBytes;
+			}
+
+			/** @brief Retorna a quantidade de slots. */
+			int getNumSlots(void) const;
+			/** @brief Retorna a quantidade de bytes ocupados pelos bits de cada endereço. */
+			int getStrideBytes(void) const;
+			/** @brief Retorna a quantidade de memórias de cada discriminador. */
+			int getNumRams(void) const;
+			/** @brief Retorna a quantidade de endereços de cada memória. */
+			long long getRamSize(void) const;
+			/** @brief Retorna a quantidade de bytes do bloco. */
+			long long getBytes(void) const;
+
+			/**
+			 * @brief Escreve o bloco em um arquivo de modelo.
+			 * @param writer Arquivo de modelo.
+			 */
+			void write(ModelWriter &writer) const;
+
+			/**
+			 * @brief Lê o conteúdo escrito por write, substituindo o conteúdo atual. O bloco lido deve
+			 * ter a mesma quantidade de memórias, de endereços e de slots.
+			 * @param reader Arquivo de modelo.
+			 * @return Falso caso o arquivo seja inválido ou não corresponda ao bloco.
+			 */
+			bool read(ModelReader &reader);
+
+		private:
+			/** Bits de todos os slots, agrupados por endereço.*/
+			std::vector<uint8_t> bits;
+			/** Quantidade de memórias de cada discriminador.*/
+			int numRams;
+			/** Quantidade de endereços de cada memória.*/
+			long long ramSize;
+			/** Quantidade de slots.*/
+			int numSlots;
+			/** Quantidade de bytes ocupados pelos bits de cada endereço.*/
+			int strideBytes;
+	};
+}
+
+#endif /* BITARENA_HPP_ */
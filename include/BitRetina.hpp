@@ -0,0 +1,91 @@
+/**
+ * @file   BitRetina.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe BitRetina.
+ */
+
+#ifndef BITRETINA_HPP_
+#define BITRETINA_HPP_
+
+#include <vector>
+#include <stdint.h>
+
+
+namespace wann
+{
+	/**
+	 * Classe que representa uma retina com um bit por posição, empacotada em palavras de 64 bits.
+	 * A posição p da retina corresponde ao bit (p % 64) da palavra (p / 64).
+	 */
+	class BitRetina
+	{
+		public:
+			/**
+			 * @brief Construtor de uma retina vazia.
+			 */
+			BitRetina(void);
+
+			/**
+			 * @brief Construtor de uma retina com todas as posições zeradas.
+			 * @param length Comprimento da retina.
+			 */
+			explicit BitRetina(int length);
+
+			/**
+			 * @brief Construtor a partir de uma retina representada por inteiros.
+			 * @param retina Vetor de inteiros, toda posição diferente de zero é considerada ativa.
+			 */
+			explicit BitRetina(const std::vector<int> &retina);
+
+			/**
+			 * @brief Retorna o comprimento da retina.
+			 */
+			int size(void) const;
+
+			/**
+			 * @brief Retorna o bit de uma posição da retina.
+			 * @param position Posição da retina.
+			 */
+			inline bool get(int position) const
+			{
+				return (words[position >> 6] >> (position & 63)) & 1ULL;
+			}
+
+			/**
+			 * @brief Altera o bit de uma posição da retina.
+			 * @param position Posição da retina.
+			 * @param value Novo valor do bit.
+			 */
+			inline void set(int position, bool value)
+			{
+				if(value)
+					words[position >> 6] |= (1ULL << (position & 63));
+				else
+					words[position >> 6] &= ~(1ULL << (position & 63));
+			}
+
+			/**
+			 * @brief Retorna as palavras de 64 bits que armazenam a retina.
+			 */
+			const uint64_t *data(void) const;
+
+			/**
+			 * @brief Retorna as palavras de 64 bits que armazenam a retina, para escrita.
+			 */
+			uint64_t *data(void);
+
+			/**
+			 * @brief Retorna a quantidade de palavras de 64 bits utilizadas pela retina.
+			 */
+			int numWords(void) const;
+
+		private:
+			/** Palavras que armazenam os bits da retina.*/
+			std::vector<uint64_t> words;
+			/** Comprimento da retina.*/
+			int length;
+	};
+}
+
+#endif /* BITRETINA_HPP_ */
@@ -0,0 +1,137 @@
+/**
+ * @file   BoundedQueue.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração e implementação da classe BoundedQueue.
+ */
+
+#ifndef BOUNDEDQUEUE_HPP_
+#define BOUNDEDQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+
+namespace wann
+{
+	/**
+	 * Fila de capacidade fixa, sem bloqueios, para vários produtores e vários consumidores.
+	 * Cada posição do vetor circular possui um número de sequência, que indica se ela pode ser
+	 * escrita pelo produtor ou lida pelo consumidor da sua volta no vetor; produtores e
+	 * consumidores reservam posições apenas com compare-and-swap sobre as suas posições globais.
+	 */
+	template<typename T>
+	class BoundedQueue
+	{
+		public:
+			/**
+			 * @brief Construtor da classe.
+			 * @param capacity Quantidade mínima de elementos, arredondada para a próxima potência de 2.
+			 */
+			explicit BoundedQueue(size_t capacity)
+			:enqueuePos(0), dequeuePos(0)
+			{
+				size_t size = 2;
+				while(size < capacity)
+					size *= 2;
+				mask = size - 1;
+
+				cells.reset(new Cell[size]);
+				for(size_t i = 0; i < size; i++)
+					cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+
+			/**
+			 * @brief Insere um elemento no final da fila.
+			 * @param value Elemento.
+			 * @return Falso caso a fila esteja cheia.
+			 */
+			bool push(const T &value)
+			{
+				size_t pos = enqueuePos.load(std::memory_order_relaxed);
+				while(true)
+				{
+					Cell &cell = cells[pos & mask];
+					size_t sequence = cell.sequence.load(std::memory_order_acquire);
+					ptrdiff_t diff = (ptrdiff_t) sequence - (ptrdiff_t) pos;
+
+					if(diff == 0)
+					{
+						if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						{
+							cell.value = value;
+							cell.sequence.store(pos + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if(diff < 0)
+						return false;
+					else
+						pos = enqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+
+			/**
+			 * @brief Remove o elemento do início da fila.
+			 * @param value Saída com o elemento removido.
+			 * @return Falso caso a fila esteja vazia.
+			 */
+			bool pop(T &value)
+			{
+				size_t pos = dequeuePos.load(std::memory_order_relaxed);
+				while(true)
+				{
+					Cell &cell = cells[pos & mask];
+					size_t sequence = cell.sequence.load(std::memory_order_acquire);
+					ptrdiff_t diff = (ptrdiff_t) sequence - (ptrdiff_t) (pos + 1);
+
+					if(diff == 0)
+					{
+						if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+						{
+							value = cell.value;
+							cell.sequence.store(pos + mask + 1, std::memory_order_release);
+							return true;
+						}
+					}
+					else if(diff < 0)
+						return false;
+					else
+						pos = dequeuePos.load(std::memory_order_relaxed);
+				}
+			}
+
+			/** @brief Retorna a quantidade de elementos que a fila comporta. */
+			size_t getCapacity(void) const
+			{
+				return mask + 1;
+			}
+
+		private:
+			/**
+			 * Posição do vetor circular.
+			 */
+			struct Cell
+			{
+				/** Posição global que pode utilizar a célula: pos para o produtor, pos + 1 para o consumidor.*/
+				std::atomic<size_t> sequence;
+				/** Elemento armazenado.*/
+				T value;
+			};
+
+			/** Vetor circular, com uma quantidade de posições potência de 2.*/
+			std::unique_ptr<Cell[]> cells;
+			/** Quantidade de posições menos 1.*/
+			size_t mask;
+			/** Próxima posição global a ser escrita, em uma linha de cache própria.*/
+			alignas(64) std::atomic<size_t> enqueuePos;
+			/** Próxima posição global a ser lida, em uma linha de cache própria.*/
+			alignas(64) std::atomic<size_t> dequeuePos;
+
+			BoundedQueue(const BoundedQueue &);
+			BoundedQueue &operator=(const BoundedQueue &);
+	};
+}
+
+#endif /* BOUNDEDQUEUE_HPP_ */
@@ -0,0 +1,105 @@
+/**
+ * @file   CompressedBitmap.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe CompressedBitmap.
+ */
+
+#ifndef COMPRESSEDBITMAP_HPP_
+#define COMPRESSEDBITMAP_HPP_
+
+#include "./ModelFile.hpp"
+
+#include <stdint.h>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Conjunto de endereços não negativos, utilizado pelas memórias não cumulativas largas demais para
+	 * um bit por endereço. Os endereços são agrupados pelos seus bits acima dos 16 menos significativos;
+	 * cada grupo guarda os 16 bits restantes em um vetor ordenado de até ARRAY_MAX_SIZE valores, que é
+	 * convertido em um mapa de 2^16 bits quando fica maior que isso (como nos Roaring bitmaps).
+	 */
+	class CompressedBitmap
+	{
+		public:
+			/** Maior quantidade de valores de um grupo armazenado como vetor ordenado.*/
+			static const int ARRAY_MAX_SIZE = 4096;
+
+			/**
+			 * @brief Retorna verdadeiro caso o endereço pertença ao conjunto.
+			 * @param value Endereço.
+			 */
+			bool contains(long long value) const;
+
+			/**
+			 * @brief Insere um endereço no conjunto.
+			 * @param value Endereço.
+			 */
+			void insert(long long value);
+
+			/** @brief Retorna a quantidade de endereços do conjunto. */
+			long long size(void) const;
+
+			/**
+			 * @brief Chama function(value) para cada endereço do conjunto, em ordem crescente.
+			 * @param function Função a ser chamada.
+			 */
+			template<typename Function>
+			void forEach(Function function) const
+			{
+				for(size_t i = 0; i < keys.size(); i++)
+				{
+					const Container &container = containers[i];
+					long long high = keys[i] << 16;
+					for(size_t k = 0; k < container.values.size(); k++)
+						function(high | container.values[k]);
+					for(size_t w = 0; w < container.words.size(); w++)
+					{
+						for(uint64_t word = container.words[w]; word != 0; word &= word - 1)
+							function(high | (long long) (w * 64 + __builtin_ctzll(word)));
+					}
+				}
+			}
+
+			/** @brief Retorna a quantidade de bytes ocupados pelos grupos. */
+			long long getBytes(void) const;
+
+			/**
+			 * @brief Escreve o conjunto em um arquivo de modelo.
+			 * @param writer Arquivo de modelo.
+			 */
+			void write(ModelWriter &writer) const;
+
+			/**
+			 * @brief Lê o conjunto escrito por write, substituindo o conteúdo atual.
+			 * @param reader Arquivo de modelo.
+			 * @param maxValue Maior endereço válido.
+			 * @return Falso caso o arquivo seja inválido.
+			 */
+			bool read(ModelReader &reader, long long maxValue);
+
+		private:
+			/**
+			 * Endereços que compartilham os bits acima dos 16 menos significativos.
+			 */
+			struct Container
+			{
+				/** 16 bits menos significativos de cada endereço, em ordem crescente (vazio quando há mapa).*/
+				std::vector<uint16_t> values;
+				/** Mapa de 2^16 bits (vazio enquanto o grupo é um vetor ordenado).*/
+				std::vector<uint64_t> words;
+				/** Quantidade de endereços do grupo.*/
+				int cardinality;
+			};
+
+			/** Bits acima dos 16 menos significativos de cada grupo, em ordem crescente.*/
+			std::vector<long long> keys;
+			/** Grupos, na ordem de keys.*/
+			std::vector<Container> containers;
+	};
+}
+
+#endif /* COMPRESSEDBITMAP_HPP_ */
@@ -0,0 +1,81 @@
+/**
+ * @file   DataLoader.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe DataLoader.
+ */
+
+#ifndef DATALOADER_HPP_
+#define DATALOADER_HPP_
+
+#include "BitRetina.hpp"
+
+#include <string>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Classe responsável por carregar conjuntos de dados: retinas em CSV (uma retina por linha,
+	 * valores inteiros separados por vírgula), rótulos em CSV (separados por vírgula) e retinas
+	 * em formato binário. Os arquivos são mapeados em memória e lidos sem cópias intermediárias.
+	 */
+	class DataLoader
+	{
+		public:
+			/**
+			 * @brief Carrega retinas de um arquivo CSV.
+			 * @param path Caminho do arquivo.
+			 * @param X Vetor de saída, uma retina por linha não vazia do arquivo.
+			 * @return Falso caso o arquivo não possa ser lido ou contenha um valor não inteiro.
+			 */
+			static bool loadCsv(const std::string &path, std::vector<std::vector<int>> &X);
+
+			/**
+			 * @brief Carrega retinas de um arquivo CSV diretamente em retinas de bits.
+			 * Todo valor diferente de zero é considerado ativo (mesma convenção de BitRetina).
+			 * @param path Caminho do arquivo.
+			 * @param X Vetor de saída, uma retina por linha não vazia do arquivo.
+			 * @return Falso caso o arquivo não possa ser lido ou contenha um valor não inteiro.
+			 */
+			static bool loadCsv(const std::string &path, std::vector<BitRetina> &X);
+
+			/**
+			 * @brief Carrega rótulos separados por vírgula (quebras de linha também separam rótulos).
+			 * @param path Caminho do arquivo.
+			 * @param y Vetor de saída com os rótulos.
+			 * @return Falso caso o arquivo não possa ser lido.
+			 */
+			static bool loadLabels(const std::string &path, std::vector<std::string> &y);
+
+			/**
+			 * @brief Salva retinas de bits em formato binário.
+			 * Todas as retinas devem ter o mesmo comprimento, maior que zero.
+			 * @param path Caminho do arquivo.
+			 * @param X Retinas a serem salvas.
+			 * @return Falso caso as retinas sejam vazias, tenham comprimentos diferentes ou a escrita falhe.
+			 */
+			static bool saveRetinas(const std::string &path, const std::vector<BitRetina> &X);
+
+			/**
+			 * @brief Carrega retinas salvas por saveRetinas.
+			 * @param path Caminho do arquivo.
+			 * @param X Vetor de saída com as retinas.
+			 * @return Falso caso o arquivo não exista, esteja corrompido ou seja de outra versão.
+			 */
+			static bool loadRetinas(const std::string &path, std::vector<BitRetina> &X);
+
+		private:
+			/**
+			 * @brief Percorre as linhas não vazias de um CSV de inteiros.
+			 * @param path Caminho do arquivo.
+			 * @param onValue Chamada para cada valor, com o índice da linha e da coluna.
+			 * @param onRow Chamada ao início de cada linha, com o índice da linha e sua quantidade de valores.
+			 */
+			template<typename ValueFunction, typename RowFunction>
+			static bool parseCsv(const std::string &path, ValueFunction onValue, RowFunction onRow);
+	};
+}
+
+#endif /* DATALOADER_HPP_ */
@@ -9,7 +9,10 @@
 #define DISCRIMINATOR_HPP_
 
 #include "./Memory.hpp"
+#include "./BitRetina.hpp"
+#include "./TupleMapping.hpp"
 #include <vector>
+#include <memory>
  
 
 namespace wann
@@ -32,12 +35,20 @@ namespace wann
 		    * @param memoryAddressMapping Vetor auxiliar, utilizado para auxiliar o endereçamento das retinas.
 		    * @param isCummulative Flag para sinalizar se o conteúdo das memórias associdas ao discriminador é cumulativo.
 		    * @param ignoreZeroAddr Flag para sinalizar se o primeiro enedereço das memórias deve ser omitido na análise.
+		    * @param hash Família de hash H3 das memórias com hash (nula para memórias exatas). Só é utilizada
+		    * se a tabela de hash for menor que os 2^numBits endereços de cada memória.
+		    * @param bits Bloco de bits compartilhado pelos discriminadores de uma rede não cumulativa (pode ser nulo).
+		    * Caso as memórias não sejam cumulativas nem utilizem hash, o discriminador ocupa um novo slot do bloco, e
+		    * cada memória guarda um bit por endereço: no bloco, caso ele comporte os seus endereços, ou em um
+		    * CompressedBitmap próprio.
 		    */
 			Discriminator(int retinaLength, 
 						  int numBits, 
 						  std::vector<int> memoryAddressMapping, 
 						  bool isCummulative = true, 
-						  bool ignoreZeroAddr = false);
+						  bool ignoreZeroAddr = false,
+						  std::shared_ptr<const H3Hash> hash = std::shared_ptr<const H3Hash>(),
+						  std::shared_ptr<BitArena> bits = std::shared_ptr<BitArena>());
 
 			/**
 			 * @brief Destrutor da classe.
@@ -50,6 +61,51 @@ namespace wann
 			 */
 			void addTrainning(const std::vector<int> &retina);
 
+			/**
+			 * @brief Treina o discriminador com uma entrada retina empacotada.
+			 * @param retina Retina empacotada associada a mesma label do discriminador.
+			 */
+			void addTrainning(const BitRetina &retina);
+
+			/**
+			 * @brief Treina o discriminador a partir dos endereços já calculados de cada memória.
+			 * @param addresses Vetor com o endereço de cada memória, calculado por um TupleMapping equivalente.
+			 */
+			void addTrainning(const long long *addresses);
+
+			/**
+			 * @brief Treina apenas as memórias [memBegin, memEnd) a partir dos endereços já calculados.
+			 * Chamadas concorrentes com intervalos disjuntos são seguras, desde que reserveTrainings
+			 * tenha sido chamado antes com a quantidade de entradas a serem treinadas.
+			 * @param addresses Vetor com o endereço de cada memória, calculado por um TupleMapping equivalente.
+			 * @param memBegin Primeira memória.
+			 * @param memEnd Memória seguinte à última.
+			 */
+			void addTrainning(const long long *addresses, int memBegin, int memEnd);
+
+			/**
+			 * @brief Registra que numSamples entradas serão treinadas através de addTrainning por intervalos,
+			 * e prepara os contadores densos para comportá-las sem realocação.
+			 * @param numSamples Quantidade de entradas a serem treinadas.
+			 */
+			void reserveTrainings(long long numSamples);
+
+			/**
+			 * @brief Soma às memórias do discriminador o conteúdo das memórias de outro discriminador, criado com
+			 * o mesmo mapeamento da entrada e o mesmo número de bits. O resultado é o mesmo de treinar este
+			 * discriminador também com as entradas treinadas pelo outro.
+			 * @param other Discriminador a ser somado.
+			 * @return Falso caso as memórias não sejam compatíveis.
+			 */
+			bool merge(const Discriminator &other);
+
+			/**
+			 * @brief Cria uma cópia independente do discriminador, copiando em bloco os seus contadores.
+			 * @param bits Cópia do bloco de bits da rede, com os mesmos slots (nulo caso o discriminador não o utilize).
+			 * @return Discriminador copiado, a ser deletado pelo chamador.
+			 */
+			Discriminator *clone(std::shared_ptr<BitArena> bits) const;
+
 			/**
 			 * @brief Recebe uma retina e a partir dela, retorna um vetor com os conteúdos das memórias associadas.
 			 * @param retina Vetor de bits a ser utilizado para endereçamento pelo discriminador.
@@ -57,6 +113,80 @@ namespace wann
 			 */
 			std::vector<int> predict(const std::vector<int> &retina);
 
+			/**
+			 * @brief Recebe uma retina empacotada e a partir dela, retorna um vetor com os conteúdos das memórias associadas.
+			 * @param retina Retina empacotada a ser utilizada para endereçamento pelo discriminador.
+			 * @return Vetor com o conteúdo de cada memória, endereçado por uma porção de bits da retina.
+			 */
+			std::vector<int> predict(const BitRetina &retina);
+
+			/**
+			 * @brief Obtém o conteúdo das memórias a partir dos endereços já calculados de cada memória.
+			 * @param addresses Vetor com o endereço de cada memória, calculado por um TupleMapping equivalente.
+			 * @param result Vetor de saída, com uma posição para cada memória.
+			 */
+			void predict(const long long *addresses, int *result) const;
+
+			/**
+			 * @brief Obtém o conteúdo das memórias [memBegin, memEnd) a partir dos endereços já calculados.
+			 * @param addresses Vetor com o endereço de cada memória, calculado por um TupleMapping equivalente.
+			 * @param result Vetor de saída; o conteúdo da memória m é escrito em result[m].
+			 * @param memBegin Primeira memória.
+			 * @param memEnd Memória seguinte à última.
+			 */
+			void predict(const long long *addresses, int *result, int memBegin, int memEnd) const;
+
+			/**
+			 * @brief Obtém o conteúdo apenas das memórias listadas, a partir dos endereços já calculados.
+			 * @param addresses Vetor com o endereço de cada memória, calculado por um TupleMapping equivalente.
+			 * @param result Vetor de saída; o conteúdo da memória m é escrito em result[m].
+			 * @param memIndices Índices das memórias.
+			 * @param numIndices Quantidade de índices.
+			 */
+			void predict(const long long *addresses, int *result, const int *memIndices, int numIndices) const;
+
+			/**
+			 * @brief Retorna o slot do discriminador no bloco de bits, caso todas as suas memórias estejam no bloco,
+			 * ou -1 caso contrário.
+			 */
+			int getBitSlot(void) const;
+
+			/**
+			 * @brief Retorna a ocupação de cada memória e do discriminador como um todo.
+			 */
+			DiscriminatorStats getStats(void) const;
+
+			/**
+			 * @brief Escreve o conteúdo do discriminador em um arquivo de modelo.
+			 * @param writer Arquivo de modelo.
+			 */
+			void write(ModelWriter &writer) const;
+
+			/**
+			 * @brief Lê um discriminador escrito por write.
+			 * @param reader Arquivo de modelo.
+			 * @param retinaLength Comprimento da retina.
+			 * @param numBits Número de bits a ser utilizado para endereçamento.
+			 * @param memoryAddressMapping Vetor auxiliar, utilizado para auxiliar o endereçamento das retinas.
+			 * @param isCummulative Flag para sinalizar se o conteúdo das memórias associdas ao discriminador é cumulativo.
+			 * @param ignoreZeroAddr Flag para sinalizar se o primeiro enedereço das memórias deve ser omitido na análise.
+			 * @param file Arquivo mapeado de onde reader lê. Se não for nulo, os contadores densos
+			 * são utilizados diretamente a partir do arquivo.
+			 * @param hash Família de hash H3 das memórias com hash (nula para memórias exatas).
+			 * @param bits Bloco de bits compartilhado pelos discriminadores da rede (pode ser nulo). O seu conteúdo
+			 * não faz parte do discriminador e é lido separadamente.
+			 * @return Discriminador lido, ou nulo caso o arquivo seja inválido.
+			 */
+			static Discriminator *read(ModelReader &reader,
+									   int retinaLength,
+									   int numBits,
+									   const std::vector<int> &memoryAddressMapping,
+									   bool isCummulative,
+									   bool ignoreZeroAddr,
+									   std::shared_ptr<MappedFile> file,
+									   std::shared_ptr<const H3Hash> hash = std::shared_ptr<const H3Hash>(),
+									   std::shared_ptr<BitArena> bits = std::shared_ptr<BitArena>());
+
 		private:
 			/** Comprimento da retina.*/
 			int retinaLength;
@@ -64,15 +194,77 @@ namespace wann
 			int numBitsAddr;
 			/** Número de memorias utilizadas pelo discriminador.*/
 			int numMemories;
+			/** Quantidade de entradas treinadas (ou registradas por reserveTrainings).*/
+			long long numTrainings;
 			/** Flag para sinalizar se o conteúdo das memórias associdas ao discriminador é cumulativo.*/
 			bool isCummulative;
 			/** Flag para sinalizar se o primeiro enedereço das memórias deve ser omitido na análise.*/
 			bool ignoreZeroAddr;
-			/** Vetor de objetos Memory associados ao objeto Discriminator*/
-			std::vector<Memory *> memories;
-			/** Vetor auxiliar, utilizado para auxiliar o endereçamento das retinas.*/
-			std::vector<int> memoryAddressMapping;
+			/** Vetor de objetos Memory associados ao objeto Discriminator, armazenados de forma contígua.*/
+			std::vector<Memory> memories;
+			/** Bloco com os contadores das memórias densas ou das tabelas de hash (nulo quando as memórias são esparsas).*/
+			std::shared_ptr<RamArena> arena;
+			/** Família de hash H3 das memórias (nula quando as memórias não utilizam hash).*/
+			std::shared_ptr<const H3Hash> hash;
+			/** Flag para sinalizar se todas as memórias são densas e lidas diretamente do membro interno arena.*/
+			bool denseCounters;
+			/** Bloco de bits compartilhado pela rede (nulo quando as memórias não guardam um bit por endereço).*/
+			std::shared_ptr<BitArena> bits;
+			/** Slot do discriminador no membro interno bits.*/
+			int bitSlot;
+			/** Flag para sinalizar se todas as memórias estão no membro interno bits.*/
+			bool denseBits;
+			/** Objeto que transforma as retinas nos endereços de cada memória.*/
+			TupleMapping tupleMapping;
 			//Memory * getMemory(int addr);
+
+			/**
+			 * @brief Construtor utilizado na leitura, que utiliza um bloco de contadores já lido em vez de alocar um novo.
+			 * Os demais parâmetros são os do construtor público.
+			 * @param counters Bloco de contadores lido do arquivo (pode ser nulo). É utilizado se a configuração
+			 * prevê um bloco com as mesmas dimensões; caso contrário, um bloco vazio é alocado, se previsto.
+			 */
+			Discriminator(int retinaLength,
+						  int numBits,
+						  const std::vector<int> &memoryAddressMapping,
+						  bool isCummulative,
+						  bool ignoreZeroAddr,
+						  std::shared_ptr<const H3Hash> hash,
+						  std::shared_ptr<BitArena> bits,
+						  std::shared_ptr<RamArena> counters);
+
+			/**
+			 * @brief Cria as memórias do discriminador, utilizando o membro interno arena, se houver.
+			 */
+			void buildMemories(void);
+
+			/**
+			 * @brief Atualiza o membro interno denseCounters a partir da representação de cada memória.
+			 */
+			void updateDenseCounters(void);
+
+			/**
+			 * @brief Obtém o conteúdo de cada memória do intervalo diretamente do bloco de contadores, com a largura
+			 * CounterType. Só deve ser utilizado quando o membro interno denseCounters é verdadeiro.
+			 * @param addresses Vetor com o endereço de cada memória.
+			 * @param result Vetor de saída, com uma posição para cada memória.
+			 * @param memBegin Primeira memória.
+			 * @param memEnd Memória seguinte à última.
+			 */
+			template<typename CounterType>
+			void predictDense(const long long *addresses, int *result, int memBegin, int memEnd) const;
+
+			/**
+			 * @brief Incrementa diretamente no bloco de contadores, com a largura CounterType, o endereço de
+			 * cada memória do intervalo. Só deve ser utilizado quando o membro interno denseCounters é
+			 * verdadeiro e o bloco não é mapeado.
+			 * @param addresses Vetor com o endereço de cada memória.
+			 * @param memBegin Primeira memória.
+			 * @param memEnd Memória seguinte à última.
+			 * @return Primeira memória cujo contador não comporta o incremento, ou memEnd.
+			 */
+			template<typename CounterType>
+			int addDense(const long long *addresses, int memBegin, int memEnd);
 	};
 
 }
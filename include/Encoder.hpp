@@ -0,0 +1,149 @@
+/**
+ * @file   Encoder.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe Encoder.
+ */
+
+#ifndef ENCODER_HPP_
+#define ENCODER_HPP_
+
+#include "./BitRetina.hpp"
+
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Classe que descreve como um vetor de atributos numéricos é transformado em uma retina.
+	 * Cada posição p da retina é associada a um atributo e a um intervalo [lower, upper):
+	 * o bit da posição está ativo se, e somente se, lower <= atributo < upper.
+	 * As posições de cada atributo são consecutivas; o atributo f ocupa as posições
+	 * [f * níveis, (f + 1) * níveis).
+	 */
+	class Encoder
+	{
+		public:
+			/**
+			 * @brief Construtor de um codificador vazio, sem posições.
+			 */
+			Encoder(void);
+
+			/**
+			 * @brief Codificação termômetro: o nível k de um atributo fica ativo quando o atributo é maior
+			 * ou igual a minimum + (k + 1) * (maximum - minimum) / (levels + 1).
+			 * @param numFeatures Quantidade de atributos.
+			 * @param levels Quantidade de bits por atributo.
+			 * @param minimum Menor valor de cada atributo.
+			 * @param maximum Maior valor de cada atributo.
+			 */
+			static Encoder thermometer(int numFeatures, int levels, float minimum, float maximum);
+
+			/**
+			 * @brief Codificação termômetro com um intervalo diferente para cada atributo.
+			 * @param levels Quantidade de bits por atributo.
+			 * @param minimum Menor valor de cada atributo (um por atributo).
+			 * @param maximum Maior valor de cada atributo (um por atributo).
+			 */
+			static Encoder thermometer(int levels, const std::vector<float> &minimum, const std::vector<float> &maximum);
+
+			/**
+			 * @brief Codificação one-hot: [minimum, maximum) é dividido em numBins faixas de mesmo tamanho
+			 * e apenas a faixa que contém o atributo fica ativa. Valores abaixo de minimum ativam a
+			 * primeira faixa e valores a partir de maximum ativam a última.
+			 * @param numFeatures Quantidade de atributos.
+			 * @param numBins Quantidade de bits por atributo.
+			 * @param minimum Menor valor de cada atributo.
+			 * @param maximum Maior valor de cada atributo.
+			 */
+			static Encoder oneHot(int numFeatures, int numBins, float minimum, float maximum);
+
+			/**
+			 * @brief Codificação one-hot com um intervalo diferente para cada atributo.
+			 * @param numBins Quantidade de bits por atributo.
+			 * @param minimum Menor valor de cada atributo (um por atributo).
+			 * @param maximum Maior valor de cada atributo (um por atributo).
+			 */
+			static Encoder oneHot(int numBins, const std::vector<float> &minimum, const std::vector<float> &maximum);
+
+			/**
+			 * @brief Codificação por limiar: um bit por atributo, ativo quando o atributo é maior que threshold.
+			 * Com threshold igual a zero, é a codificação por sinal (1 ativo, -1 e 0 inativos).
+			 * @param numFeatures Quantidade de atributos.
+			 * @param threshold Limiar comum a todos os atributos.
+			 */
+			static Encoder threshold(int numFeatures, float threshold=0.0);
+
+			/**
+			 * @brief Codificação por limiar com um limiar diferente para cada atributo.
+			 * @param thresholds Limiar de cada atributo (um por atributo).
+			 */
+			static Encoder threshold(const std::vector<float> &thresholds);
+
+			/**
+			 * @brief Retorna o comprimento da retina produzida pelo codificador.
+			 */
+			int getRetinaLength(void) const;
+
+			/**
+			 * @brief Retorna a quantidade de atributos esperada em cada entrada.
+			 */
+			int getNumFeatures(void) const;
+
+			/**
+			 * @brief Retorna o atributo associado a uma posição da retina.
+			 * @param position Posição da retina.
+			 */
+			int getFeature(int position) const;
+
+			/**
+			 * @brief Retorna o início (inclusivo) do intervalo de uma posição da retina.
+			 * @param position Posição da retina.
+			 */
+			float getLower(int position) const;
+
+			/**
+			 * @brief Retorna o fim (exclusivo) do intervalo de uma posição da retina.
+			 * @param position Posição da retina.
+			 */
+			float getUpper(int position) const;
+
+			/**
+			 * @brief Retorna o bit de uma posição da retina, sem que a retina seja montada.
+			 * @param features Atributos da entrada.
+			 * @param position Posição da retina.
+			 */
+			inline bool get(const float *features, int position) const
+			{
+				float value = features[positionFeatures[position]];
+				return value >= lowerBounds[position] && value < upperBounds[position];
+			}
+
+			/**
+			 * @brief Monta a retina completa de uma entrada.
+			 * @param features Atributos da entrada, com getNumFeatures() posições.
+			 */
+			BitRetina encode(const std::vector<float> &features) const;
+
+		private:
+			/** Quantidade de atributos esperada em cada entrada.*/
+			int numFeatures;
+			/** Atributo associado a cada posição da retina.*/
+			std::vector<int> positionFeatures;
+			/** Início (inclusivo) do intervalo de cada posição da retina.*/
+			std::vector<float> lowerBounds;
+			/** Fim (exclusivo) do intervalo de cada posição da retina.*/
+			std::vector<float> upperBounds;
+
+			/**
+			 * @brief Acrescenta uma posição à retina.
+			 * @param feature Atributo da posição.
+			 * @param lower Início (inclusivo) do intervalo.
+			 * @param upper Fim (exclusivo) do intervalo.
+			 */
+			void addPosition(int feature, float lower, float upper);
+	};
+}
+
+#endif /* ENCODER_HPP_ */
@@ -0,0 +1,88 @@
+/**
+ * @file   H3Hash.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe H3Hash.
+ */
+
+#ifndef H3HASH_HPP_
+#define H3HASH_HPP_
+
+#include <vector>
+#include <stdint.h>
+
+
+namespace wann
+{
+	/**
+	 * Família de funções de hash H3, utilizada pelas memórias com hash (count-min sketch).
+	 * A função r associa a cada bit i do endereço um valor aleatório q[r][i]; o hash de um endereço é
+	 * o ou-exclusivo dos valores de seus bits ativos. Para que o cálculo não dependa da quantidade de
+	 * bits ativos, os valores são pré-combinados por byte do endereço (tabelas de 256 posições).
+	 * O hash r é reduzido a uma célula de [0, numCells) e deslocado para a linha r da tabela de contadores,
+	 * que possui numHashes * numCells contadores.
+	 */
+	class H3Hash
+	{
+		public:
+			/** Maior quantidade de funções de hash (linhas) suportada.*/
+			static const int MAX_HASHES = 16;
+
+			/**
+			 * @brief Construtor da classe.
+			 * @param numHashes Quantidade de funções de hash (linhas da tabela), entre 1 e MAX_HASHES.
+			 * @param numCells Quantidade de células (contadores) por linha.
+			 * @param numBits Número de bits dos endereços.
+			 * @param seed Semente dos valores aleatórios; a mesma semente gera sempre as mesmas funções.
+			 */
+			H3Hash(int numHashes, int numCells, int numBits, unsigned seed);
+
+			/** @brief Retorna a quantidade de funções de hash. */
+			int getNumHashes(void) const;
+			/** @brief Retorna a quantidade de células por linha. */
+			int getNumCells(void) const;
+			/** @brief Retorna o número de bits dos endereços. */
+			int getNumBits(void) const;
+			/** @brief Retorna a semente das funções de hash. */
+			unsigned getSeed(void) const;
+			/** @brief Retorna a quantidade total de contadores da tabela (numHashes * numCells). */
+			long long getTableSize(void) const;
+
+			/**
+			 * @brief Calcula a posição, na tabela de contadores, da célula de cada linha para um endereço.
+			 * @param addr Endereço.
+			 * @param cells Vetor de saída, com getNumHashes() posições.
+			 */
+			inline void computeCells(long long addr, long long *cells) const
+			{
+				const uint32_t *table = tables.data();
+				for(int r = 0; r < numHashes; r++)
+				{
+					uint32_t hash = 0;
+					uint64_t bytes = (uint64_t) addr;
+					for(int k = 0; k < numBytes; k++, bytes >>= 8)
+						hash ^= table[k * 256 + (bytes & 255)];
+					table += numBytes * 256;
+
+					// multiply-shift reduction of the 32-bit hash to [0, numCells)
+					cells[r] = (long long) r * numCells + (long long) (((uint64_t) hash * (uint64_t) numCells) >> 32);
+				}
+			}
+
+		private:
+			/** Quantidade de funções de hash.*/
+			int numHashes;
+			/** Quantidade de células por linha.*/
+			int numCells;
+			/** Número de bits dos endereços.*/
+			int numBits;
+			/** Quantidade de bytes dos endereços ((numBits + 7) / 8).*/
+			int numBytes;
+			/** Semente das funções de hash.*/
+			unsigned seed;
+			/** Tabelas pré-combinadas, indexadas por [linha][byte do endereço][valor do byte].*/
+			std::vector<uint32_t> tables;
+	};
+}
+
+#endif /* H3HASH_HPP_ */
@@ -0,0 +1,164 @@
+/**
+ * @file   InferenceEngine.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe InferenceEngine.
+ */
+
+#ifndef INFERENCEENGINE_HPP_
+#define INFERENCEENGINE_HPP_
+
+#include "./WiSARD.hpp"
+#include "./BoundedQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Latências das requisições atendidas por um InferenceEngine, obtidas por getLatencyStats.
+	 * Os percentis são calculados sobre as últimas LATENCY_WINDOW requisições de cada thread.
+	 */
+	struct LatencyStats
+	{
+		/** Requisições atendidas.*/
+		long long numRequests;
+		/** Lotes executados.*/
+		long long numBatches;
+		/** Quantidade média de requisições por lote.*/
+		double meanBatchSize;
+		/** Mediana, em segundos, do tempo entre submit e a disponibilidade da label.*/
+		double p50Seconds;
+		/** Percentil 99, em segundos, do mesmo tempo.*/
+		double p99Seconds;
+		/** Maior tempo, em segundos.*/
+		double maxSeconds;
+	};
+
+	/**
+	 * Classe responsável por classificar requisições de uma única entrada com baixa latência.
+	 * As requisições são colocadas em uma fila sem bloqueios (BoundedQueue) e agrupadas, por threads
+	 * próprias, em lotes de até maxBatchSize entradas, que são classificados através do membro
+	 * WiSARD::predict. Um lote é executado quando fica cheio ou quando a requisição mais antiga
+	 * aguarda há maxDelay segundos, o que limita a latência sob carga baixa e aproveita os lotes
+	 * sob rajadas.
+	 * A rede não deve ser treinada enquanto o objeto existir.
+	 */
+	class InferenceEngine
+	{
+		public:
+			/** Quantidade de latências mantidas por thread para o cálculo dos percentis.*/
+			static const int LATENCY_WINDOW = 65536;
+
+			/**
+			 * @brief Construtor da classe. Inicia as threads que executam os lotes.
+			 * @param wisard Rede utilizada na classificação, que deve existir enquanto o objeto existir.
+			 * @param numWorkers Quantidade de threads que executam lotes. Valores menores que 1
+			 * utilizam a quantidade de núcleos da máquina.
+			 * @param maxBatchSize Maior quantidade de entradas de um lote.
+			 * @param maxDelay Maior tempo, em segundos, que uma requisição aguarda pelo preenchimento do seu lote.
+			 * @param queueCapacity Quantidade de requisições que a fila comporta; submit aguarda enquanto ela está cheia.
+			 */
+			InferenceEngine(WiSARD &wisard,
+							int numWorkers=1,
+							int maxBatchSize=64,
+							double maxDelay=0.0002,
+							int queueCapacity=4096);
+
+			/**
+			 * @brief Destrutor da classe. Atende as requisições pendentes e encerra as threads.
+			 */
+			~InferenceEngine(void);
+
+			/**
+			 * @brief Submete uma entrada para classificação.
+			 * @param retina Vetor de bits a ser classificado pela rede.
+			 * @return Label selecionada pela rede, disponível quando o lote da entrada for executado. Caso a
+			 * classificação do lote lance uma exceção, a future a lança em get.
+			 */
+			std::future<std::string> submit(const std::vector<int> &retina);
+
+			/**
+			 * @brief Retorna a quantidade de requisições, de lotes e as latências das requisições atendidas.
+			 */
+			LatencyStats getLatencyStats(void) const;
+
+		private:
+			/**
+			 * Requisição de classificação de uma entrada.
+			 */
+			struct Request
+			{
+				/** Entrada a ser classificada.*/
+				std::vector<int> retina;
+				/** Label selecionada.*/
+				std::promise<std::string> result;
+				/** Instante da submissão.*/
+				std::chrono::steady_clock::time_point submitted;
+			};
+
+			/**
+			 * Latências registradas por uma thread.
+			 */
+			struct WorkerStats
+			{
+				/** Protege os membros da estrutura, lidos por getLatencyStats.*/
+				mutable std::mutex mutex;
+				/** Últimas LATENCY_WINDOW latências, em segundos, em um vetor circular.*/
+				std::vector<double> latencies;
+				/** Requisições atendidas pela thread.*/
+				long long numRequests;
+				/** Lotes executados pela thread.*/
+				long long numBatches;
+			};
+
+			/** Rede utilizada na classificação.*/
+			WiSARD &wisard;
+			/** Maior quantidade de entradas de um lote.*/
+			int maxBatchSize;
+			/** Maior tempo que uma requisição aguarda pelo preenchimento do seu lote.*/
+			std::chrono::steady_clock::duration maxDelay;
+			/** Requisições ainda não atribuídas a um lote.*/
+			BoundedQueue<Request *> queue;
+			/** Quantidade aproximada de requisições na fila.*/
+			std::atomic<int> numQueued;
+			/** Quantidade de threads aguardando por requisições.*/
+			std::atomic<int> numSleeping;
+			/** Flag para sinalizar o encerramento das threads.*/
+			std::atomic<bool> stopping;
+			/** Protege a espera das threads ociosas.*/
+			std::mutex sleepMutex;
+			/** Sinaliza às threads ociosas que há requisições ou que devem encerrar.*/
+			std::condition_variable requestAvailable;
+			/** Latências de cada thread.*/
+			std::vector<std::unique_ptr<WorkerStats>> stats;
+			/** Threads que executam os lotes.*/
+			std::vector<std::thread> workers;
+
+			/**
+			 * @brief Laço principal de uma thread: monta e executa lotes até o encerramento.
+			 * @param worker Índice da thread.
+			 */
+			void workerLoop(int worker);
+
+			/**
+			 * @brief Classifica as entradas de um lote, entrega as labels e registra as latências.
+			 * @param batch Requisições do lote, deletadas ao final.
+			 * @param worker Índice da thread.
+			 */
+			void runBatch(std::vector<Request *> &batch, int worker);
+
+			InferenceEngine(const InferenceEngine &);
+			InferenceEngine &operator=(const InferenceEngine &);
+	};
+}
+
+#endif /* INFERENCEENGINE_HPP_ */
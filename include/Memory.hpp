@@ -8,18 +8,36 @@
 #ifndef MEMORY_CPP_
 #define MEMORY_CPP_
 
+#include "./RamArena.hpp"
+#include "./H3Hash.hpp"
+#include "./Stats.hpp"
+#include "./BitArena.hpp"
+#include "./CompressedBitmap.hpp"
+
 #include <unordered_map>
+#include <memory>
 
 
 namespace wann
 {
 	/**
 	 * Classe responsável por simular e gerenciar acesso às memórias associdas a objetos do tipo Discriminator.
-	 * Cada memória é mapeada em uma estrutura do tipo unordered_map.
+	 * Memórias com até DENSE_MAX_BITS bits de endereçamento são mapeadas em uma faixa densa de 2^numBits
+	 * contadores de um objeto RamArena, que pode ser próprio ou compartilhado com outras memórias.
+	 * As demais são mapeadas em uma estrutura do tipo unordered_map, ou, caso sejam criadas com uma
+	 * família de hash H3, em uma tabela de tamanho fixo (count-min sketch) de numHashes linhas de
+	 * numCells contadores, também armazenada em uma faixa de um objeto RamArena. Nesse caso, o conteúdo
+	 * retornado é o menor contador entre as linhas, que nunca é inferior ao conteúdo exato.
+	 * Memórias não cumulativas também podem guardar apenas um bit por endereço: em um slot de um objeto
+	 * BitArena, compartilhado pelos discriminadores da rede, ou em um objeto CompressedBitmap, quando são
+	 * largas demais para o bloco.
 	 */
 	class Memory
 	{
 		public:
+			/** Maior número de bits de endereçamento para o qual a memória é representada de forma densa.*/
+			static const int DENSE_MAX_BITS = 16;
+
 			/**
 			 * @brief Construtor da Classe
 			 * @param numBits Número de bits a ser usado para se endereçar a memória.
@@ -28,6 +46,47 @@ namespace wann
 			 */
 			Memory(int numBits, bool isCummulative, bool ignoreZeroAddr);
 
+			/**
+			 * @brief Construtor de uma memória densa cujos contadores ficam em um bloco compartilhado.
+			 * @param numBits Número de bits a ser usado para se endereçar a memória.
+			 * @param isCummulative Flag para sinalizar se o conteúdo da memória deve ser cumulativo.
+			 * @param ignoreZeroAddr Flag para sinalizar se a primeira posição da memória deve ser ignorada.
+			 * @param arena Bloco de contadores, cujas memórias devem possuir ao menos 2^numBits endereços.
+			 * @param ramIndex Índice da memória dentro do bloco.
+			 */
+			Memory(int numBits, bool isCummulative, bool ignoreZeroAddr,
+				   std::shared_ptr<RamArena> arena, int ramIndex);
+
+			/**
+			 * @brief Construtor de uma memória com hash, cuja tabela de contadores fica em um bloco compartilhado.
+			 * @param numBits Número de bits a ser usado para se endereçar a memória.
+			 * @param isCummulative Flag para sinalizar se o conteúdo da memória deve ser cumulativo.
+			 * @param ignoreZeroAddr Flag para sinalizar se a primeira posição da memória deve ser ignorada.
+			 * @param arena Bloco de contadores, cujas memórias devem possuir ao menos hash->getTableSize() endereços.
+			 * @param ramIndex Índice da memória dentro do bloco.
+			 * @param hash Família de funções de hash, que define o tamanho da tabela.
+			 */
+			Memory(int numBits, bool isCummulative, bool ignoreZeroAddr,
+				   std::shared_ptr<RamArena> arena, int ramIndex, std::shared_ptr<const H3Hash> hash);
+
+			/**
+			 * @brief Construtor de uma memória não cumulativa com um bit por endereço, em um slot de um bloco de bits.
+			 * @param numBits Número de bits a ser usado para se endereçar a memória.
+			 * @param ignoreZeroAddr Flag para sinalizar se a primeira posição da memória deve ser ignorada.
+			 * @param bits Bloco de bits, cujas memórias devem possuir ao menos 2^numBits endereços.
+			 * @param ramIndex Índice da memória dentro do bloco.
+			 * @param slot Slot do discriminador dono da memória.
+			 */
+			Memory(int numBits, bool ignoreZeroAddr, std::shared_ptr<BitArena> bits, int ramIndex, int slot);
+
+			/**
+			 * @brief Construtor de uma memória não cumulativa cujos endereços utilizados ficam em um mapa de bits comprimido.
+			 * @param numBits Número de bits a ser usado para se endereçar a memória.
+			 * @param ignoreZeroAddr Flag para sinalizar se a primeira posição da memória deve ser ignorada.
+			 * @param bitmap Mapa de bits, de uso exclusivo da memória.
+			 */
+			Memory(int numBits, bool ignoreZeroAddr, std::shared_ptr<CompressedBitmap> bitmap);
+
 			/**
 			 * Destrutor da Classe
 			 */
@@ -43,11 +102,76 @@ namespace wann
 			 * @brief A partir de um endereço, retorna o conteúdo associado.
 			 * @param addr Endereço
 			 */
-			int getValue(const long long addr);
+			int getValue(const long long addr) const;
+
+			/**
+			 * @brief Soma o conteúdo de outra memória, de mesma largura, ao conteúdo desta. Caso a memória não
+			 * seja cumulativa, apenas ativa os endereços ativados na outra. Memórias com hash só podem receber
+			 * o conteúdo de memórias com a mesma família de hash, cujas tabelas são somadas célula a célula.
+			 * @param other Memória a ser somada.
+			 * @return Falso caso as memórias não sejam compatíveis; nesse caso, nada é alterado.
+			 */
+			bool merge(const Memory &other);
+
+			/**
+			 * @brief Substitui os blocos referenciados por esta memória, copiada de outra, por cópias, de forma
+			 * que as duas não compartilhem conteúdo. A família de hash, imutável, continua compartilhada.
+			 * @param sharedArena Bloco compartilhado pelas memórias do dono da memória original (pode ser nulo).
+			 * @param arenaCopy Cópia de sharedArena, utilizada caso a memória esteja nele.
+			 * @param bitsCopy Cópia do bloco de bits da memória original, com os mesmos slots (pode ser nulo).
+			 */
+			void copyStorage(const RamArena *sharedArena, std::shared_ptr<RamArena> arenaCopy,
+							 std::shared_ptr<BitArena> bitsCopy);
+
+			/**
+			 * @brief Retorna verdadeiro caso a memória seja densa e seus contadores estejam no bloco recebido.
+			 * @param arena Bloco de contadores.
+			 */
+			bool isStoredIn(const RamArena *arena) const;
+
+			/**
+			 * @brief Retorna verdadeiro caso a memória guarde os seus bits no bloco recebido.
+			 * @param bits Bloco de bits.
+			 */
+			bool isStoredIn(const BitArena *bits) const;
+
+			/**
+			 * @brief Retorna a ocupação da memória: contadores utilizados, bytes e histograma dos conteúdos.
+			 * Os bytes de uma memória em um bloco compartilhado são os da sua faixa do bloco.
+			 */
+			MemoryStats getStats(void) const;
+
+			/**
+			 * @brief Escreve o conteúdo da memória em um arquivo de modelo.
+			 * Os contadores de um bloco compartilhado não são escritos, pois pertencem ao dono do bloco.
+			 * @param writer Arquivo de modelo.
+			 * @param sharedArena Bloco compartilhado pelas memórias do dono desta memória (pode ser nulo).
+			 */
+			void write(ModelWriter &writer, const RamArena *sharedArena) const;
+
+			/**
+			 * @brief Lê o conteúdo da memória escrito por write, substituindo o conteúdo atual.
+			 * @param reader Arquivo de modelo.
+			 * @param file Arquivo mapeado de onde reader lê, ou nulo para copiar os contadores.
+			 * @return Falso caso o arquivo seja inválido.
+			 */
+			bool read(ModelReader &reader, std::shared_ptr<MappedFile> file);
 
 		private:
-			/** Estrutura de dados utilizada para simular uma memória.*/
+			/** Estrutura de dados utilizada para simular uma memória esparsa.*/
 			std::unordered_map<long long, int> data;
+			/** Bloco que contém os contadores da memória densa (nulo quando a memória é esparsa).*/
+			std::shared_ptr<RamArena> arena;
+			/** Família de funções de hash (nula quando a memória não utiliza hash).*/
+			std::shared_ptr<const H3Hash> hash;
+			/** Bloco de bits da memória não cumulativa (nulo quando a memória não utiliza um bit por endereço no bloco).*/
+			std::shared_ptr<BitArena> bits;
+			/** Mapa de bits comprimido da memória não cumulativa (nulo quando não é utilizado).*/
+			std::shared_ptr<CompressedBitmap> bitmap;
+			/** Índice da memória dentro do bloco arena, ou do bloco bits.*/
+			int ramIndex;
+			/** Slot do discriminador dono da memória, dentro do bloco bits.*/
+			int slot;
 			/** Quantidade de endereços de memória utilizados*/
 			long long numAddrs;
 			/** Número de bits a ser usado para se endereçar a memória.*/
@@ -56,6 +180,26 @@ namespace wann
 			bool isCummulative;
 			/** Flag para sinalizar se a primeira posição da memória deve ser ignorada.*/
 			bool ignoreZeroAddr;
+
+			/**
+			 * @brief Incrementa o conteúdo associado a um endereço em uma memória com hash.
+			 * @param addr Endereço
+			 * @param value Valor
+			 */
+			void addHashedValue(const long long addr, int value);
+
+			/**
+			 * @brief Converte a memória densa em uma memória esparsa.
+			 */
+			void convertToSparse(void);
+
+			/**
+			 * @brief Chama function(addr, value) para cada endereço com conteúdo não nulo, em qualquer
+			 * representação exceto a tabela de hash.
+			 * @param function Função a ser chamada.
+			 */
+			template<typename Function>
+			void forEachValue(Function function) const;
 	};
 
 }
@@ -0,0 +1,193 @@
+/**
+ * @file   ModelFile.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração das classes MappedFile, ModelWriter e ModelReader,
+ * utilizadas para salvar e carregar modelos em formato binário.
+ */
+
+#ifndef MODELFILE_HPP_
+#define MODELFILE_HPP_
+
+#include <fstream>
+#include <string>
+#include <stddef.h>
+#include <string.h>
+
+
+namespace wann
+{
+	/**
+	 * Arquivo mapeado em memória, somente para leitura, durante o tempo de vida do objeto.
+	 */
+	class MappedFile
+	{
+		public:
+			/**
+			 * @brief Construtor da classe. Mapeia o arquivo inteiro em memória.
+			 * @param path Caminho do arquivo.
+			 */
+			explicit MappedFile(const std::string &path);
+
+			/**
+			 * @brief Destrutor da classe. Desfaz o mapeamento.
+			 */
+			~MappedFile(void);
+
+			/** @brief Retorna verdadeiro caso o arquivo tenha sido mapeado. */
+			bool isOpen(void) const;
+			/** @brief Retorna o início do conteúdo mapeado. */
+			const char *data(void) const;
+			/** @brief Retorna o tamanho, em bytes, do conteúdo mapeado. */
+			size_t size(void) const;
+
+		private:
+			/** Início do conteúdo mapeado (nulo caso o mapeamento tenha falhado).*/
+			const char *content;
+			/** Tamanho, em bytes, do conteúdo mapeado.*/
+			size_t length;
+
+			MappedFile(const MappedFile &);
+			MappedFile &operator=(const MappedFile &);
+	};
+
+	/**
+	 * Escreve valores binários em um arquivo, mantendo a posição corrente para alinhamentos.
+	 * O conteúdo é escrito em um arquivo temporário (path + ".tmp"), que só substitui o arquivo de
+	 * destino em commit, através de rename. Assim, um arquivo mapeado por MappedFile (por exemplo,
+	 * o de uma rede carregada com useMmap) nunca é truncado enquanto o mapeamento existe: o
+	 * mapeamento continua referenciando o conteúdo anterior.
+	 */
+	class ModelWriter
+	{
+		public:
+			/**
+			 * @brief Construtor da classe. Cria (ou sobrescreve) o arquivo temporário.
+			 * @param path Caminho do arquivo de destino.
+			 */
+			explicit ModelWriter(const std::string &path);
+
+			/**
+			 * @brief Destrutor da classe. Remove o arquivo temporário caso commit não tenha sido chamado.
+			 */
+			~ModelWriter(void);
+
+			/**
+			 * @brief Escreve um valor com sua representação em memória.
+			 * @param value Valor a ser escrito.
+			 */
+			template<typename T>
+			void write(const T &value)
+			{
+				writeBytes(&value, sizeof(T));
+			}
+
+			/**
+			 * @brief Escreve uma sequência de bytes.
+			 * @param bytes Início da sequência.
+			 * @param numBytes Quantidade de bytes.
+			 */
+			void writeBytes(const void *bytes, size_t numBytes);
+
+			/**
+			 * @brief Escreve uma string, precedida de seu comprimento.
+			 * @param value String a ser escrita.
+			 */
+			void writeString(const std::string &value);
+
+			/**
+			 * @brief Completa com zeros até que a posição corrente seja múltipla de alignment.
+			 * @param alignment Alinhamento, em bytes.
+			 */
+			void align(size_t alignment);
+
+			/** @brief Retorna verdadeiro caso todas as escritas tenham sido bem sucedidas. */
+			bool good(void) const;
+
+			/**
+			 * @brief Fecha o arquivo temporário e o renomeia para o caminho de destino.
+			 * @return Falso, com o arquivo temporário removido, caso alguma escrita ou a renomeação falhe.
+			 */
+			bool commit(void);
+
+		private:
+			/** Caminho do arquivo de destino.*/
+			std::string path;
+			/** Caminho do arquivo temporário.*/
+			std::string tmpPath;
+			/** Arquivo de saída.*/
+			std::ofstream output;
+			/** Quantidade de bytes já escritos.*/
+			size_t position;
+			/** Flag para sinalizar se o arquivo temporário já foi renomeado.*/
+			bool committed;
+
+			ModelWriter(const ModelWriter &);
+			ModelWriter &operator=(const ModelWriter &);
+	};
+
+	/**
+	 * Lê valores binários de um bloco de memória, verificando os limites do bloco.
+	 * Após a primeira leitura inválida, todas as leituras seguintes falham.
+	 */
+	class ModelReader
+	{
+		public:
+			/**
+			 * @brief Construtor da classe.
+			 * @param data Início do bloco.
+			 * @param size Tamanho, em bytes, do bloco.
+			 */
+			ModelReader(const char *data, size_t size);
+
+			/**
+			 * @brief Lê um valor escrito por ModelWriter::write.
+			 * @param value Variável de saída.
+			 * @return Falso caso o bloco tenha terminado.
+			 */
+			template<typename T>
+			bool read(T &value)
+			{
+				const char *bytes = readBytes(sizeof(T));
+				if(bytes == NULL)
+					return false;
+				memcpy(&value, bytes, sizeof(T));
+				return true;
+			}
+
+			/**
+			 * @brief Avança sobre uma sequência de bytes.
+			 * @param numBytes Quantidade de bytes.
+			 * @return Início da sequência no bloco, ou nulo caso o bloco tenha terminado.
+			 */
+			const char *readBytes(size_t numBytes);
+
+			/**
+			 * @brief Lê uma string escrita por ModelWriter::writeString.
+			 * @param value Variável de saída.
+			 * @return Falso caso o bloco tenha terminado.
+			 */
+			bool readString(std::string &value);
+
+			/**
+			 * @brief Avança até que a posição corrente seja múltipla de alignment.
+			 * @param alignment Alinhamento, em bytes.
+			 */
+			void align(size_t alignment);
+
+			/** @brief Retorna verdadeiro caso todas as leituras tenham sido bem sucedidas. */
+			bool good(void) const;
+
+		private:
+			/** Início do bloco.*/
+			const char *data;
+			/** Tamanho, em bytes, do bloco.*/
+			size_t size;
+			/** Posição corrente.*/
+			size_t position;
+			/** Flag para sinalizar se alguma leitura falhou.*/
+			bool failed;
+	};
+}
+
+#endif /* MODELFILE_HPP_ */
@@ -0,0 +1,180 @@
+/**
+ * @file   ModelHandle.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe ModelHandle.
+ */
+
+#ifndef MODELHANDLE_HPP_
+#define MODELHANDLE_HPP_
+
+#include "./WiSARD.hpp"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Classe responsável por permitir o treinamento de uma rede enquanto ela é utilizada na predição.
+	 * A rede é mantida em versões imutáveis: leitores obtêm a versão corrente através de acquire, sem
+	 * bloqueios, e a utilizam apenas para predição; o escritor treina uma cópia da versão corrente e a
+	 * publica atomicamente como uma nova versão (como no RCU). Cada leitor anuncia a versão que utiliza
+	 * em uma posição própria (hazard pointer), e uma versão substituída só é deletada quando nenhuma
+	 * posição a anuncia.
+	 * As versões publicadas não utilizam ThreadPool, cujo parallelFor serializaria os leitores: o
+	 * ThreadPool da rede inicial passa a ser utilizado apenas pelo escritor, no treinamento das cópias.
+	 */
+	class ModelHandle
+	{
+		private:
+			/** Versão publicada da rede, definida em ModelHandle.cpp.*/
+			struct Version;
+
+		public:
+			/** Maior quantidade de objetos Snapshot existentes ao mesmo tempo; acquire aguarda acima disso.*/
+			static const int MAX_READERS = 128;
+
+			/**
+			 * Versão da rede em uso por um leitor. Enquanto o objeto existir, a versão não é deletada.
+			 * Não deve ser compartilhado entre threads.
+			 */
+			class Snapshot
+			{
+				public:
+					/**
+					 * @brief Transfere a versão de outro objeto, que deixa de referenciá-la.
+					 * @param other Objeto de origem.
+					 */
+					Snapshot(Snapshot &&other);
+
+					/**
+					 * @brief Destrutor da classe. Libera a posição do leitor.
+					 */
+					~Snapshot(void);
+
+					/**
+					 * @brief Retorna a rede da versão. Apenas os membros de predição podem ser utilizados.
+					 */
+					WiSARD *operator->(void) const;
+
+					/**
+					 * @brief Retorna a rede da versão. Apenas os membros de predição podem ser utilizados.
+					 */
+					WiSARD &operator*(void) const;
+
+					/**
+					 * @brief Retorna o número da versão, a partir de 0 para a rede recebida na construção do ModelHandle.
+					 */
+					long long getVersion(void) const;
+
+				private:
+					friend class ModelHandle;
+
+					/** Objeto de origem da versão.*/
+					const ModelHandle *handle;
+					/** Posição do leitor em handle->hazards.*/
+					int slot;
+					/** Versão utilizada.*/
+					Version *version;
+
+					Snapshot(const ModelHandle *handle, int slot, Version *version);
+					Snapshot(const Snapshot &);
+					Snapshot &operator=(const Snapshot &);
+			};
+
+			/**
+			 * @brief Construtor da classe.
+			 * @param model Rede inicial (versão 0), cuja posse passa a ser do objeto. O seu ThreadPool
+			 * é retirado da rede e utilizado pelo escritor.
+			 */
+			explicit ModelHandle(WiSARD *model);
+
+			/**
+			 * @brief Destrutor da classe. Deleta todas as versões; não deve existir nenhum objeto Snapshot.
+			 */
+			~ModelHandle(void);
+
+			/**
+			 * @brief Obtém a versão corrente da rede, sem bloqueios.
+			 */
+			Snapshot acquire(void) const;
+
+			/**
+			 * @brief Retorna o número da versão corrente.
+			 */
+			long long getVersion(void) const;
+
+			/**
+			 * @brief Treina uma cópia da versão corrente e a publica como nova versão. Escritores
+			 * concorrentes são serializados; leitores continuam utilizando as versões anteriores.
+			 * @param train Função que altera a cópia (por exemplo, chamando partialFit).
+			 * @return Número da versão publicada.
+			 */
+			long long update(const std::function<void(WiSARD &model)> &train);
+
+			/**
+			 * @brief Treina uma cópia da versão corrente com as entradas X e a publica como nova versão.
+			 * @param X Matriz de inteiros, cada linha é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 * @return Número da versão publicada.
+			 */
+			long long partialFit(const std::vector< std::vector<int> > &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Publica uma rede como nova versão, por exemplo uma rede carregada ou somada por WiSARD::reduce.
+			 * @param model Rede, cuja posse passa a ser do objeto. O seu ThreadPool é descartado.
+			 * @return Número da versão publicada.
+			 */
+			long long publish(WiSARD *model);
+
+			/**
+			 * @brief Deleta as versões substituídas que não estão mais em uso. É chamado a cada publicação.
+			 * @return Quantidade de versões substituídas que continuam em uso.
+			 */
+			int reclaim(void);
+
+		private:
+			/** Versão corrente.*/
+			std::atomic<Version *> current;
+			/** Número da versão corrente.*/
+			std::atomic<long long> currentNumber;
+			/** Versão anunciada por cada leitor (nula quando a posição está livre ou ainda não anunciou).*/
+			mutable std::atomic<Version *> hazards[MAX_READERS];
+			/** Flag de ocupação de cada posição de leitor.*/
+			mutable std::atomic<bool> slotsInUse[MAX_READERS];
+			/** Versões substituídas ainda não deletadas.*/
+			std::vector<Version *> retired;
+			/** Serializa os escritores.*/
+			std::mutex writerMutex;
+			/** ThreadPool utilizado no treinamento das cópias (nulo quando serial).*/
+			std::shared_ptr<ThreadPool> threadPool;
+
+			/**
+			 * @brief Publica uma versão, com o escritor já serializado.
+			 * @param model Rede da nova versão.
+			 * @return Número da versão publicada.
+			 */
+			long long publishLocked(WiSARD *model);
+
+			/**
+			 * @brief Implementação do membro reclaim, com o escritor já serializado.
+			 */
+			int reclaimLocked(void);
+
+			/**
+			 * @brief Libera a posição de um leitor.
+			 * @param slot Posição.
+			 */
+			void release(int slot) const;
+
+			ModelHandle(const ModelHandle &);
+			ModelHandle &operator=(const ModelHandle &);
+	};
+}
+
+#endif /* MODELHANDLE_HPP_ */
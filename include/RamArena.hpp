@@ -0,0 +1,162 @@
+/**
+ * @file   RamArena.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe RamArena.
+ */
+
+#ifndef RAMARENA_HPP_
+#define RAMARENA_HPP_
+
+#include "./ModelFile.hpp"
+
+#include <memory>
+#include <stdint.h>
+
+
+namespace wann
+{
+	/**
+	 * Classe responsável por armazenar, em um único bloco contíguo, os contadores
+	 * de um conjunto de memórias densas de mesmo tamanho.
+	 * O contador do endereço addr da memória ram fica na posição ram * ramSize + addr.
+	 * Todos os contadores do bloco possuem a mesma largura (8, 16 ou 32 bits), que
+	 * cresce, para o bloco inteiro, quando algum valor deixa de caber.
+	 * O bloco pode também apontar diretamente para um arquivo de modelo mapeado em memória;
+	 * nesse caso, ele é copiado para memória própria apenas na primeira escrita.
+	 */
+	class RamArena
+	{
+		public:
+			/**
+			 * @brief Construtor da classe. Aloca o bloco com contadores de 8 bits zerados.
+			 * @param numRams Quantidade de memórias armazenadas no bloco.
+			 * @param ramSize Quantidade de endereços de cada memória.
+			 */
+			RamArena(int numRams, long long ramSize);
+
+			/**
+			 * @brief Construtor de um bloco cujos contadores estão em um arquivo mapeado em memória.
+			 * @param mappedCounters Início dos contadores no arquivo mapeado.
+			 * @param counterBytes Largura, em bytes, de cada contador.
+			 * @param numRams Quantidade de memórias armazenadas no bloco.
+			 * @param ramSize Quantidade de endereços de cada memória.
+			 * @param file Arquivo mapeado, mantido aberto enquanto o bloco o referenciar.
+			 */
+			RamArena(const void *mappedCounters, int counterBytes, int numRams, long long ramSize,
+					 std::shared_ptr<MappedFile> file);
+
+			/**
+			 * @brief Construtor de cópia. Copia integralmente o bloco de contadores.
+			 * @param other Bloco a ser copiado.
+			 */
+			RamArena(const RamArena &other);
+
+			/**
+			 * @brief Destrutor da classe. Libera o bloco de contadores.
+			 */
+			~RamArena(void);
+
+			/**
+			 * @brief Retorna o contador de um endereço de uma memória.
+			 * @param ram Índice da memória no bloco.
+			 * @param addr Endereço
+			 */
+			inline long long getValue(int ram, long long addr) const
+			{
+				long long pos = (long long) ram * ramSize + addr;
+				switch(counterBytes)
+				{
+					case 1:  return ((const uint8_t *) counters)[pos];
+					case 2:  return ((const uint16_t *) counters)[pos];
+					default: return ((const uint32_t *) counters)[pos];
+				}
+			}
+
+			/**
+			 * @brief Escreve o contador de um endereço de uma memória, alargando os contadores do bloco se necessário.
+			 * @param ram Índice da memória no bloco.
+			 * @param addr Endereço
+			 * @param value Novo conteúdo
+			 * @return Falso caso value seja negativo ou maior que INT_MAX, e portanto não representável.
+			 */
+			bool setValue(int ram, long long addr, long long value);
+
+			/**
+			 * @brief Alarga, se necessário, os contadores do bloco para que comportem maxValue.
+			 * Após a chamada, escritas de valores até maxValue não realocam o bloco, podendo
+			 * ser feitas concorrentemente em memórias distintas.
+			 * @param maxValue Maior valor a ser escrito.
+			 */
+			void reserveValue(long long maxValue);
+
+			/**
+			 * @brief Zera todos os contadores de uma memória.
+			 * @param ram Índice da memória no bloco.
+			 */
+			void clearRam(int ram);
+
+			/**
+			 * @brief Escreve o bloco em um arquivo de modelo. Os contadores são alinhados em 64 bytes,
+			 * para que possam ser utilizados diretamente a partir do arquivo mapeado.
+			 * @param writer Arquivo de modelo.
+			 */
+			void write(ModelWriter &writer) const;
+
+			/**
+			 * @brief Lê um bloco escrito por write.
+			 * @param reader Arquivo de modelo.
+			 * @param file Arquivo mapeado de onde reader lê. Se não for nulo, os contadores
+			 * não são copiados e passam a ser lidos diretamente do arquivo.
+			 * @return Bloco lido, ou nulo caso o arquivo seja inválido.
+			 */
+			static std::shared_ptr<RamArena> read(ModelReader &reader, std::shared_ptr<MappedFile> file);
+
+			/** @brief Retorna verdadeiro caso os contadores sejam lidos diretamente de um arquivo mapeado. */
+			bool isMapped(void) const;
+
+			/** @brief Retorna a largura, em bytes, dos contadores. */
+			int getCounterBytes(void) const;
+			/**
+			 * @brief Retorna o bloco de contadores, com getCounterBytes() bytes por contador; o contador do
+			 * endereço addr da memória ram fica na posição ram * getRamSize() + addr.
+			 * O ponteiro deixa de ser válido quando o bloco é alargado ou deixa de ser mapeado.
+			 */
+			const void *getCounters(void) const;
+			/**
+			 * @brief Retorna o bloco de contadores para escrita direta, que não pode ser feita em um bloco mapeado.
+			 */
+			void *getCounters(void);
+			/** @brief Retorna a quantidade de memórias armazenadas no bloco. */
+			int getNumRams(void) const;
+			/** @brief Retorna a quantidade de endereços de cada memória. */
+			long long getRamSize(void) const;
+
+		private:
+			/** Bloco contíguo de contadores.*/
+			void *counters;
+			/** Arquivo mapeado que contém os contadores (nulo quando o bloco é próprio).*/
+			std::shared_ptr<MappedFile> mappedFile;
+			/** Largura, em bytes, de cada contador.*/
+			int counterBytes;
+			/** Quantidade de memórias armazenadas no bloco.*/
+			int numRams;
+			/** Quantidade de endereços de cada memória.*/
+			long long ramSize;
+
+			/**
+			 * @brief Copia os contadores de um arquivo mapeado para memória própria.
+			 */
+			void detach(void);
+
+			/**
+			 * @brief Realoca o bloco com contadores de maior largura, preservando seus valores.
+			 * @param newCounterBytes Nova largura, em bytes, dos contadores.
+			 */
+			void widenCounters(int newCounterBytes);
+
+			RamArena &operator=(const RamArena &);
+	};
+}
+
+#endif /* RAMARENA_HPP_ */
@@ -0,0 +1,125 @@
+/**
+ * @file   ScoringSession.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe ScoringSession.
+ */
+
+#ifndef SCORINGSESSION_HPP_
+#define SCORINGSESSION_HPP_
+
+#include "./WiSARD.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Classe responsável por classificar uma sequência de entradas em que cada entrada difere da anterior
+	 * em poucas posições, como em fluxos e janelas deslizantes.
+	 * A sessão mantém os endereços das tuplas da entrada corrente, o conteúdo das memórias de cada label
+	 * nesses endereços e a quantidade de memórias ativadas de cada label. Ao inverter algumas posições
+	 * (flip), apenas as tuplas que as utilizam são endereçadas e lidas novamente, através do mapeamento
+	 * inverso de TupleMapping, e as quantidades são corrigidas; o custo é proporcional à quantidade de
+	 * posições invertidas, e não ao comprimento da retina (exceto pelo bleaching, que percorre o conteúdo
+	 * de todas as memórias). As porcentagens são as mesmas de WiSARD::predictProba para a entrada corrente.
+	 * A rede não deve ser treinada enquanto a sessão é utilizada; após um treinamento, a sessão deve ser
+	 * reiniciada por reset.
+	 * Não deve ser compartilhada entre threads.
+	 */
+	class ScoringSession
+	{
+		public:
+			/**
+			 * @brief Construtor da classe. A entrada corrente é a retina com todas as posições zeradas.
+			 * @param wisard Rede utilizada na classificação, que deve existir enquanto o objeto existir.
+			 */
+			explicit ScoringSession(const WiSARD &wisard);
+
+			/**
+			 * @brief Substitui a entrada corrente, endereçando e lendo todas as memórias.
+			 * @param retina Vetor de bits, toda posição diferente de zero é considerada ativa.
+			 */
+			void reset(const std::vector<int> &retina);
+
+			/**
+			 * @brief Substitui a entrada corrente por uma retina empacotada.
+			 * @param retina Retina empacotada.
+			 */
+			void reset(const BitRetina &retina);
+
+			/**
+			 * @brief Substitui a entrada corrente por uma retina esparsa.
+			 * @param retina Retina esparsa.
+			 */
+			void reset(const SparseRetina &retina);
+
+			/**
+			 * @brief Inverte posições da entrada corrente, atualizando apenas as tuplas que as utilizam.
+			 * Uma posição listada duas vezes volta ao valor original.
+			 * @param positions Posições invertidas, entre 0 e retinaLength - 1.
+			 */
+			void flip(const std::vector<int> &positions);
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada label da entrada corrente.
+			 * @param scores Vetor de saída, com getNumLabels() posições, na ordem dos índices das labels.
+			 */
+			void predictScores(float *scores);
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada label da entrada corrente.
+			 * @return Unordered_map contendo a porcentagem de memórias ativadas para cada label.
+			 */
+			std::unordered_map<std::string, float> predictProba(void);
+
+			/**
+			 * @brief Seleciona o índice da label com maior porcentagem de memórias ativadas na entrada corrente.
+			 * @return Índice da label selecionada (-1 caso a rede não possua labels).
+			 */
+			int predictLabelIndex(void);
+
+			/**
+			 * @brief Seleciona a label com maior porcentagem de memórias ativadas na entrada corrente.
+			 * @return Label selecionada (string vazia caso a rede não possua labels).
+			 */
+			std::string predict(void);
+
+		private:
+			/** Rede utilizada na classificação.*/
+			const WiSARD &wisard;
+			/** Quantidade de labels da rede na última chamada a reset.*/
+			int numLabels;
+			/** Endereços das tuplas, conteúdo das memórias de cada label e quantidade de memórias ativadas
+			 * de cada label para a entrada corrente.*/
+			WiSARD::ScoringBuffers buffers;
+			/** Tuplas alteradas pela última inversão, possivelmente repetidas.*/
+			std::vector<int> touched;
+			/** Tuplas alteradas pela última inversão, sem repetições.*/
+			std::vector<int> changed;
+			/** Flag de cada tupla, para sinalizar se já está em changed.*/
+			std::vector<char> isChanged;
+			/** Conteúdo anterior das tuplas alteradas, para uma label.*/
+			std::vector<int> previous;
+			/** Porcentagens de cada label.*/
+			std::vector<float> rowScores;
+
+			/**
+			 * @brief Lê todas as memórias nos endereços já calculados e conta as memórias ativadas de cada label.
+			 */
+			void fetchAll(void);
+
+			/**
+			 * @brief Gera um warning e encerra a execução caso a quantidade de labels da rede tenha mudado desde reset.
+			 */
+			void checkLabels(void) const;
+
+			ScoringSession(const ScoringSession &);
+			ScoringSession &operator=(const ScoringSession &);
+	};
+}
+
+#endif /* SCORINGSESSION_HPP_ */
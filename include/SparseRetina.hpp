@@ -0,0 +1,65 @@
+/**
+ * @file   SparseRetina.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe SparseRetina.
+ */
+
+#ifndef SPARSERETINA_HPP_
+#define SPARSERETINA_HPP_
+
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Classe que representa uma retina pela lista de suas posições ativas; as demais posições são zero.
+	 * Adequada a retinas com poucas posições ativas, cujo endereçamento (ver TupleMapping) depende
+	 * apenas da quantidade de posições ativas, e não do comprimento da retina.
+	 */
+	class SparseRetina
+	{
+		public:
+			/**
+			 * @brief Construtor de uma retina vazia.
+			 */
+			SparseRetina(void);
+
+			/**
+			 * @brief Construtor a partir das posições ativas.
+			 * @param length Comprimento da retina.
+			 * @param activePositions Posições ativas, em qualquer ordem, entre 0 e length - 1.
+			 */
+			SparseRetina(int length, const std::vector<int> &activePositions);
+
+			/**
+			 * @brief Construtor a partir de uma retina representada por inteiros.
+			 * @param retina Vetor de inteiros, toda posição diferente de zero é considerada ativa.
+			 */
+			explicit SparseRetina(const std::vector<int> &retina);
+
+			/**
+			 * @brief Retorna o comprimento da retina.
+			 */
+			int size(void) const;
+
+			/**
+			 * @brief Retorna a quantidade de posições ativas.
+			 */
+			int numActive(void) const;
+
+			/**
+			 * @brief Retorna as posições ativas.
+			 */
+			const int *data(void) const;
+
+		private:
+			/** Posições ativas da retina.*/
+			std::vector<int> positions;
+			/** Comprimento da retina.*/
+			int length;
+	};
+}
+
+#endif /* SPARSERETINA_HPP_ */
@@ -0,0 +1,247 @@
+/**
+ * @file   Stats.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração das estatísticas de ocupação das memórias e dos contadores
+ * de tempo de execução da rede.
+ */
+
+#ifndef STATS_HPP_
+#define STATS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Representação do conteúdo de uma memória.
+	 */
+	enum MemoryKind
+	{
+		/** Endereços utilizados em uma estrutura do tipo unordered_map.*/
+		SPARSE_MEMORY,
+		/** Um contador por endereço, em uma faixa de um objeto RamArena.*/
+		DENSE_MEMORY,
+		/** Tabela de tamanho fixo (count-min sketch), em uma faixa de um objeto RamArena.*/
+		HASHED_MEMORY,
+		/** Um bit por endereço, em um objeto BitArena compartilhado pelos discriminadores da rede.*/
+		BITSET_MEMORY,
+		/** Endereços utilizados em um objeto CompressedBitmap.*/
+		BITMAP_MEMORY
+	};
+
+	/**
+	 * Ocupação de uma memória, obtida por Memory::getStats.
+	 */
+	struct MemoryStats
+	{
+		/** Quantidade de faixas do histograma: a faixa k conta os conteúdos em [2^k, 2^(k+1)).*/
+		static const int HISTOGRAM_BUCKETS = 32;
+
+		/** Representação do conteúdo da memória.*/
+		MemoryKind kind;
+		/** Número de bits de endereçamento da memória.*/
+		int numBits;
+		/** Quantidade de contadores que a memória pode ocupar: 2^numBits, ou o tamanho da tabela de hash.*/
+		long long capacity;
+		/** Quantidade de contadores (ou endereços, na memória esparsa) com conteúdo não nulo.*/
+		long long usedCells;
+		/** Fração usedCells / capacity.*/
+		double occupancy;
+		/** Fator de carga: elementos por balde na memória esparsa, ou a fração de células ocupadas na tabela de hash.*/
+		double loadFactor;
+		/** Quantidade de bytes ocupados (estimada, na memória esparsa).*/
+		long long bytes;
+		/** Histograma dos conteúdos não nulos, com HISTOGRAM_BUCKETS faixas.*/
+		std::vector<long long> histogram;
+
+		/**
+		 * @brief Construtor de estatísticas zeradas.
+		 */
+		MemoryStats(void);
+
+		/**
+		 * @brief Contabiliza contadores não nulos no histograma e em usedCells.
+		 * @param value Conteúdo dos contadores.
+		 * @param numCells Quantidade de contadores com esse conteúdo.
+		 */
+		void addValue(long long value, long long numCells = 1);
+	};
+
+	/**
+	 * Ocupação de todas as memórias de um discriminador, obtida por Discriminator::getStats.
+	 */
+	struct DiscriminatorStats
+	{
+		/** Quantidade de entradas treinadas.*/
+		long long numTrainings;
+		/** Quantidade de contadores com conteúdo não nulo, somada entre as memórias.*/
+		long long usedCells;
+		/** Quantidade de bytes ocupados pelas memórias, incluindo o bloco de contadores compartilhado
+		 * e excluindo o bloco de bits compartilhado pela rede (BitArena).*/
+		long long bytes;
+		/** Soma dos histogramas das memórias.*/
+		std::vector<long long> histogram;
+		/** Estatísticas de cada memória.*/
+		std::vector<MemoryStats> memories;
+	};
+
+	/**
+	 * Ocupação de todos os discriminadores de uma rede, obtida por WiSARD::getStats.
+	 */
+	struct WiSARDStats
+	{
+		/** Quantidade de memórias de cada discriminador.*/
+		int numMemories;
+		/** Quantidade de bytes ocupados por todos os discriminadores, incluindo o bloco de bits compartilhado.*/
+		long long bytes;
+		/** Soma dos histogramas de todos os discriminadores.*/
+		std::vector<long long> histogram;
+		/** Estatísticas de cada discriminador, na posição do índice de sua label.*/
+		std::vector<DiscriminatorStats> discriminators;
+	};
+
+	/**
+	 * Contadores e tempos acumulados nos caminhos de treinamento e de predição, obtidos por
+	 * WiSARD::getProfile. Os tempos são somados entre as threads.
+	 */
+	struct RuntimeProfile
+	{
+		/** Entradas treinadas.*/
+		long long trainedSamples;
+		/** Entradas classificadas.*/
+		long long predictedSamples;
+		/** Entradas em que o bleaching foi aplicado.*/
+		long long bleachingCalls;
+		/** Iterações do laço de bleaching, somadas entre as entradas.*/
+		long long bleachingIterations;
+		/** Segundos gastos calculando os endereços das tuplas.*/
+		double addressingSeconds;
+		/** Segundos gastos escrevendo nas memórias.*/
+		double trainingSeconds;
+		/** Segundos gastos lendo o conteúdo das memórias.*/
+		double lookupSeconds;
+		/** Segundos gastos calculando as porcentagens, incluindo o bleaching.*/
+		double scoringSeconds;
+	};
+
+	/**
+	 * Contadores de uma única thread, acumulados sem sincronização e repassados a um Profiler.
+	 * Só contabilizam algo quando a biblioteca é compilada com WANN_PROFILE (make all PROFILE=1);
+	 * caso contrário, seus membros são vazios e removidos pelo compilador.
+	 */
+	class LocalProfile
+	{
+		public:
+			/** Contadores acumulados.*/
+			enum Counter
+			{
+				TRAINED_SAMPLES,
+				PREDICTED_SAMPLES,
+				BLEACHING_CALLS,
+				BLEACHING_ITERATIONS,
+				ADDRESSING_NS,
+				TRAINING_NS,
+				LOOKUP_NS,
+				SCORING_NS,
+				NUM_COUNTERS
+			};
+
+			/**
+			 * @brief Construtor da classe. Zera os contadores e inicia a medição de tempo.
+			 */
+			LocalProfile(void)
+			{
+				for(int i = 0; i < NUM_COUNTERS; i++)
+					values[i] = 0;
+				start();
+			}
+
+			/**
+			 * @brief Soma n a um contador.
+			 * @param counter Contador.
+			 * @param n Valor a ser somado.
+			 */
+			inline void count(Counter counter, long long n)
+			{
+#ifdef WANN_PROFILE
+				values[counter] += n;
+#endif
+			}
+
+			/**
+			 * @brief Reinicia a medição de tempo.
+			 */
+			inline void start(void)
+			{
+#ifdef WANN_PROFILE
+				last = std::chrono::steady_clock::now();
+#endif
+			}
+
+			/**
+			 * @brief Soma a um contador de tempo os nanossegundos desde a última medição, e reinicia a medição.
+			 * @param counter Contador de tempo.
+			 */
+			inline void lap(Counter counter)
+			{
+#ifdef WANN_PROFILE
+				std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+				values[counter] += std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+				last = now;
+#endif
+			}
+
+			/** Valor de cada contador.*/
+			long long values[NUM_COUNTERS];
+
+		private:
+			/** Instante da última medição de tempo.*/
+			std::chrono::steady_clock::time_point last;
+	};
+
+	/**
+	 * Contadores acumulados por uma rede, atualizados de forma atômica pelas threads de treinamento e de predição.
+	 */
+	class Profiler
+	{
+		public:
+			/**
+			 * @brief Construtor da classe, com os contadores zerados.
+			 */
+			Profiler(void);
+
+			/**
+			 * @brief Retorna verdadeiro caso a biblioteca tenha sido compilada com WANN_PROFILE.
+			 */
+			static bool isEnabled(void);
+
+			/**
+			 * @brief Soma os contadores de uma thread.
+			 * @param local Contadores da thread.
+			 */
+			void add(const LocalProfile &local);
+
+			/**
+			 * @brief Retorna os valores acumulados.
+			 */
+			RuntimeProfile snapshot(void) const;
+
+			/**
+			 * @brief Zera os contadores.
+			 */
+			void reset(void);
+
+		private:
+			/** Valor de cada contador de LocalProfile.*/
+			std::atomic<long long> values[LocalProfile::NUM_COUNTERS];
+
+			Profiler(const Profiler &);
+			Profiler &operator=(const Profiler &);
+	};
+}
+
+#endif /* STATS_HPP_ */
@@ -0,0 +1,195 @@
+/**
+ * @file   Sweep.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe Sweep.
+ */
+
+#ifndef SWEEP_HPP_
+#define SWEEP_HPP_
+
+#include "./WiSARD.hpp"
+#include "./BitRetina.hpp"
+#include "./ThreadPool.hpp"
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Resultado da avaliação de uma configuração da rede.
+	 */
+	struct SweepResult
+	{
+		/** Número de bits utilizado para endereçamento.*/
+		int numBitsAddr;
+		/** Parâmetros de cálculo das porcentagens.*/
+		WiSARD::ScoringOptions options;
+		/** Acurácia média entre as partições.*/
+		float accuracy;
+		/** Acurácia em cada partição (uma única posição fora da validação cruzada).*/
+		std::vector<float> foldAccuracies;
+	};
+
+	/**
+	 * Classe responsável por avaliar a acurácia de várias configurações da rede.
+	 * O conteúdo das memórias depende apenas do número de bits de endereçamento, de forma que
+	 * cada rede é treinada uma única vez por número de bits (e por partição, na validação cruzada)
+	 * e avaliada com todos os parâmetros de cálculo das porcentagens (bleaching, limiar de confiança,
+	 * bleaching padrão e omissão do primeiro endereço). Os treinamentos são feitos em paralelo.
+	 */
+	class Sweep
+	{
+		public:
+			/**
+			 * @brief Construtor da classe.
+			 * @param retinaLength Comprimento da retina.
+			 * @param numBitsAddr Números de bits de endereçamento a serem avaliados.
+			 * @param options Parâmetros de cálculo das porcentagens a serem avaliados, para cada número de bits.
+			 * @param randomizePositions Flag para sinalizar se o mapeamento da entrada deve ser randômico.
+			 * @param isCummulative Flag para sinalizar se o conteúdo das memórias é cumulativo.
+			 */
+			Sweep(int retinaLength,
+				  const std::vector<int> &numBitsAddr,
+				  const std::vector<WiSARD::ScoringOptions> &options,
+				  bool randomizePositions=true,
+				  bool isCummulative=true);
+
+			/**
+			 * @brief Monta todas as combinações de parâmetros de cálculo das porcentagens.
+			 * Sem bleaching, confidenceThresholds e defaultBleaching_b não têm efeito, e apenas uma
+			 * combinação é criada para cada valor de ignoreZeroAddr.
+			 * @param useBleaching Valores da flag de bleaching.
+			 * @param confidenceThresholds Valores do limite de confiança.
+			 * @param defaultBleaching_b Valores do bleaching padrão.
+			 * @param ignoreZeroAddr Valores da flag de omissão do primeiro endereço.
+			 */
+			static std::vector<WiSARD::ScoringOptions> grid(const std::vector<bool> &useBleaching,
+															const std::vector<float> &confidenceThresholds,
+															const std::vector<int> &defaultBleaching_b,
+															const std::vector<bool> &ignoreZeroAddr);
+
+			/**
+			 * @brief Treina com um conjunto e avalia com outro.
+			 * @param XTrain Entradas de treinamento.
+			 * @param yTrain Labels das entradas de treinamento.
+			 * @param XTest Entradas de teste.
+			 * @param yTest Labels das entradas de teste.
+			 * @return Um resultado para cada número de bits e cada conjunto de parâmetros.
+			 */
+			std::vector<SweepResult> evaluate(const std::vector< std::vector<int> > &XTrain, const std::vector<std::string> &yTrain,
+											  const std::vector< std::vector<int> > &XTest, const std::vector<std::string> &yTest);
+
+			/**
+			 * @brief Mesmo comportamento do membro evaluate, para entradas empacotadas.
+			 */
+			std::vector<SweepResult> evaluate(const std::vector<BitRetina> &XTrain, const std::vector<std::string> &yTrain,
+											  const std::vector<BitRetina> &XTest, const std::vector<std::string> &yTest);
+
+			/**
+			 * @brief Avalia as configurações por validação cruzada: as entradas são embaralhadas e divididas em
+			 * numFolds partições; cada partição é testada por uma rede treinada com as demais.
+			 * @param X Entradas.
+			 * @param y Labels das entradas.
+			 * @param numFolds Quantidade de partições (pelo menos 2).
+			 * @param seed Semente utilizada para embaralhar as entradas.
+			 * @return Um resultado para cada número de bits e cada conjunto de parâmetros.
+			 */
+			std::vector<SweepResult> crossValidate(const std::vector< std::vector<int> > &X, const std::vector<std::string> &y,
+												   int numFolds, unsigned seed=0);
+
+			/**
+			 * @brief Mesmo comportamento do membro crossValidate, para entradas empacotadas.
+			 */
+			std::vector<SweepResult> crossValidate(const std::vector<BitRetina> &X, const std::vector<std::string> &y,
+												   int numFolds, unsigned seed=0);
+
+			/**
+			 * @brief Escreve os resultados, um por linha, no formato
+			 * "accuracy: 0.63, num_bits: 8, bleaching: 1, conf_threshold: 0.1, bleaching_b: 1, ignoreZeros: 0".
+			 * @param output Stream de saída.
+			 * @param results Resultados a serem escritos.
+			 */
+			static void report(std::ostream &output, const std::vector<SweepResult> &results);
+
+			/**
+			 * @brief Define a quantidade de threads utilizadas nos treinamentos e avaliações.
+			 * @param numThreads Quantidade de threads. 1 desativa o paralelismo; valores menores
+			 * que 1 utilizam a quantidade de núcleos da máquina.
+			 */
+			void setNumThreads(int numThreads);
+
+			/**
+			 * @brief Define o ThreadPool utilizado nos treinamentos e avaliações.
+			 * @param threadPool ThreadPool a ser utilizado. Um ponteiro nulo desativa o paralelismo.
+			 */
+			void setThreadPool(std::shared_ptr<ThreadPool> threadPool);
+
+		private:
+			/** Comprimento da retina.*/
+			int retinaLength;
+			/** Números de bits de endereçamento a serem avaliados.*/
+			std::vector<int> numBitsAddr;
+			/** Parâmetros de cálculo das porcentagens a serem avaliados.*/
+			std::vector<WiSARD::ScoringOptions> options;
+			/** Flag para sinalizar se o mapeamento da entrada deve ser randômico.*/
+			bool randomizePositions;
+			/** Flag para sinalizar se o conteúdo das memórias é cumulativo.*/
+			bool isCummulative;
+			/** ThreadPool utilizado para treinar e avaliar as redes em paralelo (nulo quando serial).*/
+			std::shared_ptr<ThreadPool> threadPool;
+
+			/**
+			 * @brief Cria uma rede, ainda não treinada, com um dos números de bits avaliados.
+			 * @param numBits Número de bits de endereçamento.
+			 */
+			WiSARD *createNetwork(int numBits) const;
+
+			/**
+			 * @brief Executa os trabalhos (treinamento e avaliação de uma rede) em paralelo.
+			 * Com um único trabalho, o ThreadPool é repassado à própria rede.
+			 * @param numJobs Quantidade de trabalhos.
+			 * @param job Trabalho de índice job, que recebe o ThreadPool a ser utilizado pela rede (ou nulo).
+			 */
+			void runJobs(int numJobs, const std::function<void(int, std::shared_ptr<ThreadPool>)> &job);
+
+			/**
+			 * @brief Conta, para cada conjunto de parâmetros, as entradas classificadas corretamente por uma rede.
+			 * @param wisard Rede treinada.
+			 * @param X Entradas de teste.
+			 * @param y Labels das entradas de teste.
+			 * @param correct Vetor de saída, com options.size() posições.
+			 */
+			template<typename RetinaType>
+			void countCorrect(WiSARD &wisard, const std::vector<RetinaType> &X, const std::vector<std::string> &y,
+							  long long *correct) const;
+
+			/**
+			 * @brief Monta os resultados a partir das contagens de acertos.
+			 * @param correct Acertos, indexados por [número de bits][partição][parâmetros].
+			 * @param foldSizes Quantidade de entradas de teste de cada partição.
+			 */
+			std::vector<SweepResult> collect(const std::vector<long long> &correct, const std::vector<long long> &foldSizes) const;
+
+			/**
+			 * @brief Implementação do membro evaluate, comum a retinas de inteiros e empacotadas.
+			 */
+			template<typename RetinaType>
+			std::vector<SweepResult> evaluateRetinas(const std::vector<RetinaType> &XTrain, const std::vector<std::string> &yTrain,
+													 const std::vector<RetinaType> &XTest, const std::vector<std::string> &yTest);
+
+			/**
+			 * @brief Implementação do membro crossValidate, comum a retinas de inteiros e empacotadas.
+			 */
+			template<typename RetinaType>
+			std::vector<SweepResult> crossValidateRetinas(const std::vector<RetinaType> &X, const std::vector<std::string> &y,
+														  int numFolds, unsigned seed);
+	};
+}
+
+#endif /* SWEEP_HPP_ */
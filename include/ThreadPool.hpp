@@ -0,0 +1,103 @@
+/**
+ * @file   ThreadPool.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe ThreadPool.
+ */
+
+#ifndef THREADPOOL_HPP_
+#define THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace wann
+{
+	/**
+	 * Conjunto de threads persistentes, utilizado para distribuir laços em blocos (chunks).
+	 * A thread que chama parallelFor também processa blocos, de forma que um ThreadPool
+	 * com numThreads threads cria numThreads - 1 threads auxiliares.
+	 * Apenas um parallelFor é executado por vez; chamadas concorrentes aguardam a anterior.
+	 * O corpo do laço não deve chamar parallelFor do mesmo ThreadPool.
+	 */
+	class ThreadPool
+	{
+		public:
+			/**
+			 * @brief Construtor da classe.
+			 * @param numThreads Quantidade de threads que processam cada laço. Valores menores que 1
+			 * utilizam a quantidade de núcleos da máquina.
+			 */
+			explicit ThreadPool(int numThreads);
+
+			/**
+			 * @brief Destrutor da classe. Encerra as threads auxiliares.
+			 */
+			~ThreadPool(void);
+
+			/**
+			 * @brief Retorna a quantidade de threads que processam cada laço.
+			 */
+			int getNumThreads(void) const;
+
+			/**
+			 * @brief Executa body sobre os índices [0, numItems), divididos em blocos de chunkSize índices.
+			 * Os blocos são distribuídos dinamicamente entre as threads. Retorna quando todos terminam.
+			 * @param numItems Quantidade de índices.
+			 * @param chunkSize Quantidade de índices de cada bloco. Valores menores que 1 escolhem
+			 * automaticamente cerca de oito blocos por thread.
+			 * @param body Função que recebe o intervalo [begin, end) de um bloco e o índice, em
+			 * [0, getNumThreads()), da thread que o processa.
+			 */
+			void parallelFor(int numItems, int chunkSize, const std::function<void(int begin, int end, int thread)> &body);
+
+		private:
+			/** Threads auxiliares.*/
+			std::vector<std::thread> workers;
+			/** Quantidade de threads que processam cada laço.*/
+			int numThreads;
+
+			/** Protege o estado do laço corrente.*/
+			std::mutex mutex;
+			/** Serializa as chamadas de parallelFor.*/
+			std::mutex callMutex;
+			/** Sinaliza às threads auxiliares que há um novo laço ou que devem encerrar.*/
+			std::condition_variable workAvailable;
+			/** Sinaliza à thread chamadora que as threads auxiliares terminaram o laço.*/
+			std::condition_variable workDone;
+			/** Identificador do laço corrente, incrementado a cada parallelFor.*/
+			long long generation;
+			/** Quantidade de threads auxiliares que ainda processam o laço corrente.*/
+			int activeWorkers;
+			/** Flag para sinalizar o encerramento das threads auxiliares.*/
+			bool stopping;
+
+			/** Corpo do laço corrente.*/
+			const std::function<void(int, int, int)> *body;
+			/** Quantidade de índices do laço corrente.*/
+			int numItems;
+			/** Quantidade de índices de cada bloco do laço corrente.*/
+			int chunkSize;
+			/** Próximo índice a ser distribuído.*/
+			std::atomic<int> nextItem;
+
+			/**
+			 * @brief Laço principal de uma thread auxiliar.
+			 * @param thread Índice da thread auxiliar, a partir de 1.
+			 */
+			void workerLoop(int thread);
+
+			/**
+			 * @brief Processa blocos do laço corrente até que não restem índices.
+			 * @param thread Índice da thread que processa os blocos.
+			 */
+			void runChunks(int thread);
+	};
+}
+
+#endif /* THREADPOOL_HPP_ */
@@ -0,0 +1,240 @@
+/**
+ * @file   TupleMapping.hpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de declaração da classe TupleMapping.
+ */
+
+#ifndef TUPLEMAPPING_HPP_
+#define TUPLEMAPPING_HPP_
+
+#include "./BitRetina.hpp"
+#include "./SparseRetina.hpp"
+#include "./Encoder.hpp"
+
+#include <vector>
+#include <stdint.h>
+
+
+namespace wann
+{
+	/**
+	 * Classe responsável por transformar uma retina nos endereços de cada memória (tupla).
+	 * A tupla i é formada pelas posições memoryAddressMapping[i*numBits ... i*numBits + numBits - 1]
+	 * da retina; o bit j da tupla tem peso 2^j no endereço.
+	 * Quando retinaLength não é múltiplo de numBits, a última tupla possui retinaLength % numBits bits.
+	 * Para retinas empacotadas (BitRetina), utiliza um plano pré-calculado, no qual cada tupla é
+	 * dividida em segmentos: bits consecutivos da tupla que vêm de uma mesma palavra da retina, em
+	 * posições crescentes, são extraídos de uma só vez (PEXT, ou deslocamento e máscara).
+	 * Para retinas de inteiros, as tuplas com até MAX_FIXED_BITS bits usam um laço especializado em
+	 * tempo de compilação para a sua largura, totalmente desenrolado e sem desvios.
+	 * Com um Encoder associado, os endereços também podem ser calculados diretamente a partir dos
+	 * atributos numéricos de uma entrada, sem que sua retina seja montada.
+	 * Para retinas esparsas (SparseRetina), utiliza o mapeamento inverso: para cada posição da retina,
+	 * as tuplas e os bits de tupla que a utilizam; apenas as tuplas com alguma posição ativa são montadas.
+	 * O mesmo mapeamento permite atualizar os endereços de uma retina quando algumas posições são invertidas.
+	 */
+	class TupleMapping
+	{
+		public:
+			/** Maior largura de tupla com laço de endereçamento especializado.*/
+			static const int MAX_FIXED_BITS = 32;
+
+			/**
+			 * @brief Construtor de um mapeamento vazio, sem tuplas.
+			 */
+			TupleMapping(void);
+
+			/**
+			 * @brief Construtor da classe.
+			 * @param retinaLength Comprimento da retina.
+			 * @param numBits Número de bits a ser utilizado para endereçamento.
+			 * @param memoryAddressMapping Vetor auxiliar, utilizado para auxiliar o endereçamento das retinas.
+			 */
+			TupleMapping(int retinaLength, int numBits, const std::vector<int> &memoryAddressMapping);
+
+			/**
+			 * @brief Retorna a quantidade de tuplas (memórias).
+			 */
+			int getNumMemories(void) const;
+
+			/**
+			 * @brief Retorna a quantidade de bits de uma tupla.
+			 * @param memIndex Índice da tupla.
+			 */
+			int getMemoryBits(int memIndex) const;
+
+			/**
+			 * @brief Calcula o endereço de cada tupla de uma retina.
+			 * @param retina Vetor de bits, toda posição diferente de zero é considerada ativa.
+			 * @param addresses Vetor de saída, com getNumMemories() posições.
+			 */
+			void computeAddresses(const std::vector<int> &retina, long long *addresses) const;
+
+			/**
+			 * @brief Calcula o endereço de cada tupla de uma retina empacotada.
+			 * @param retina Retina empacotada.
+			 * @param addresses Vetor de saída, com getNumMemories() posições.
+			 */
+			void computeAddresses(const BitRetina &retina, long long *addresses) const;
+
+			/**
+			 * @brief Calcula o endereço das tuplas [memBegin, memEnd) de uma retina.
+			 * @param retina Vetor de bits, toda posição diferente de zero é considerada ativa.
+			 * @param addresses Vetor de saída; o endereço da tupla m é escrito em addresses[m].
+			 * @param memBegin Primeira tupla.
+			 * @param memEnd Tupla seguinte à última.
+			 */
+			void computeAddresses(const std::vector<int> &retina, long long *addresses, int memBegin, int memEnd) const;
+
+			/**
+			 * @brief Calcula o endereço das tuplas [memBegin, memEnd) de uma retina empacotada.
+			 * @param retina Retina empacotada.
+			 * @param addresses Vetor de saída; o endereço da tupla m é escrito em addresses[m].
+			 * @param memBegin Primeira tupla.
+			 * @param memEnd Tupla seguinte à última.
+			 */
+			void computeAddresses(const BitRetina &retina, long long *addresses, int memBegin, int memEnd) const;
+
+			/**
+			 * @brief Calcula o endereço de cada tupla de uma retina esparsa.
+			 * @param retina Retina esparsa.
+			 * @param addresses Vetor de saída, com getNumMemories() posições.
+			 */
+			void computeAddresses(const SparseRetina &retina, long long *addresses) const;
+
+			/**
+			 * @brief Calcula o endereço das tuplas [memBegin, memEnd) de uma retina esparsa.
+			 * @param retina Retina esparsa.
+			 * @param addresses Vetor de saída; o endereço da tupla m é escrito em addresses[m].
+			 * @param memBegin Primeira tupla.
+			 * @param memEnd Tupla seguinte à última.
+			 */
+			void computeAddresses(const SparseRetina &retina, long long *addresses, int memBegin, int memEnd) const;
+
+			/**
+			 * @brief Calcula o endereço apenas das tuplas com alguma posição ativa de uma retina esparsa,
+			 * com custo proporcional à quantidade de posições ativas. As demais tuplas têm endereço zero.
+			 * @param retina Retina esparsa.
+			 * @param addresses Vetor com getNumMemories() posições, que devem estar zeradas; o endereço de
+			 * cada tupla com posição ativa é escrito na sua posição, e as demais não são alteradas.
+			 * @param touched Vetor de saída, com getNumMemories() posições, com as tuplas com posição ativa,
+			 * na ordem em que são encontradas.
+			 * @return Quantidade de tuplas com posição ativa.
+			 */
+			int computeTouchedAddresses(const SparseRetina &retina, long long *addresses, int *touched) const;
+
+			/**
+			 * @brief Inverte posições de uma retina já endereçada, alterando apenas os endereços das tuplas
+			 * que as utilizam, com custo proporcional à quantidade de posições.
+			 * @param positions Posições invertidas, entre 0 e retinaLength - 1.
+			 * @param numPositions Quantidade de posições.
+			 * @param addresses Endereço de cada tupla da retina, com getNumMemories() posições, atualizado.
+			 * @param touched Vetor ao qual cada tupla alterada é acrescentada (uma tupla pode aparecer mais de uma vez).
+			 */
+			void flipAddresses(const int *positions, int numPositions, long long *addresses, std::vector<int> &touched) const;
+
+			/**
+			 * @brief Associa um codificador ao mapeamento, permitindo calcular endereços a partir de atributos.
+			 * @param encoder Codificador, cuja retina deve ter o comprimento do mapeamento.
+			 */
+			void setEncoder(const Encoder &encoder);
+
+			/**
+			 * @brief Retorna verdadeiro caso haja um codificador associado ao mapeamento.
+			 */
+			bool hasEncoder(void) const;
+
+			/**
+			 * @brief Retorna o codificador associado ao mapeamento.
+			 */
+			const Encoder &getEncoder(void) const;
+
+			/**
+			 * @brief Calcula o endereço de cada tupla a partir dos atributos de uma entrada, através do codificador.
+			 * @param features Atributos da entrada, com getEncoder().getNumFeatures() posições.
+			 * @param addresses Vetor de saída, com getNumMemories() posições.
+			 */
+			void computeAddresses(const std::vector<float> &features, long long *addresses) const;
+
+			/**
+			 * @brief Calcula o endereço das tuplas [memBegin, memEnd) a partir dos atributos de uma entrada.
+			 * @param features Atributos da entrada, com getEncoder().getNumFeatures() posições.
+			 * @param addresses Vetor de saída; o endereço da tupla m é escrito em addresses[m].
+			 * @param memBegin Primeira tupla.
+			 * @param memEnd Tupla seguinte à última.
+			 */
+			void computeAddresses(const std::vector<float> &features, long long *addresses, int memBegin, int memEnd) const;
+
+		private:
+			/**
+			 * Trecho de uma tupla cujos bits vêm de uma mesma palavra da retina, em posições crescentes.
+			 */
+			struct Segment
+			{
+				/** Índice da palavra da retina.*/
+				int word;
+				/** Posição, na tupla, do primeiro bit do segmento.*/
+				int outShift;
+				/** Posições, na palavra, dos bits do segmento.*/
+				uint64_t mask;
+				/** Posição do bit menos significativo de mask.*/
+				int lowBit;
+				/** Flag para sinalizar se os bits de mask são contíguos.*/
+				bool contiguous;
+			};
+
+			/**
+			 * Intervalo de um atributo que define um bit de tupla (ver Encoder).
+			 */
+			struct EncodedBit
+			{
+				/** Atributo da entrada.*/
+				int feature;
+				/** Início (inclusivo) do intervalo.*/
+				float lower;
+				/** Fim (exclusivo) do intervalo.*/
+				float upper;
+			};
+
+			/**
+			 * Bit de uma tupla que utiliza uma posição da retina.
+			 */
+			struct TupleBit
+			{
+				/** Índice da tupla.*/
+				int memory;
+				/** Posição do bit na tupla.*/
+				int bit;
+			};
+
+			/** Comprimento da retina.*/
+			int retinaLength;
+			/** Número de bits a ser utilizado para endereçamento.*/
+			int numBitsAddr;
+			/** Quantidade de tuplas.*/
+			int numMemories;
+			/** Quantidade de tuplas completas, com numBitsAddr bits.*/
+			int numFullMemories;
+			/** Laço especializado para tuplas completas de numBitsAddr bits (nulo quando numBitsAddr > MAX_FIXED_BITS).*/
+			void (*fixedKernel)(const int *retina, const int *positions, long long *addresses, int memBegin, int memEnd);
+			/** Posições da retina que formam cada tupla, concatenadas.*/
+			std::vector<int> positions;
+			/** Início de cada tupla no vetor positions (numMemories + 1 posições).*/
+			std::vector<int> tupleOffsets;
+			/** Segmentos de cada tupla, concatenados.*/
+			std::vector<Segment> segments;
+			/** Início dos segmentos de cada tupla no vetor segments (numMemories + 1 posições).*/
+			std::vector<int> segmentOffsets;
+			/** Bits de tupla que utilizam cada posição da retina, concatenados na ordem das posições.*/
+			std::vector<TupleBit> inverseBits;
+			/** Início dos bits de cada posição da retina no vetor inverseBits (retinaLength + 1 posições).*/
+			std::vector<int> inverseOffsets;
+			/** Codificador associado ao mapeamento (vazio caso não haja).*/
+			Encoder encoder;
+			/** Intervalo de cada bit de cada tupla, na ordem do vetor positions (vazio caso não haja codificador).*/
+			std::vector<EncodedBit> encodedBits;
+	};
+}
+
+#endif /* TUPLEMAPPING_HPP_ */
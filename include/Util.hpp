@@ -8,6 +8,7 @@
 #ifndef UTIL_CPP_
 #define UTIL_CPP_
 
+#include <cstddef>
 #include <string>
 #include <unordered_map>
 
@@ -36,6 +37,57 @@ namespace wann
 		 * @return Label que obteve mais memórias ativadas.
 		 */
 		std::string argMax(std::unordered_map<std::string, float>&values);
+
+		/**
+		 * @brief Calcula a confiança a partir de um vetor de porcentagens indexado pelas labels.
+		 * @param result Porcentagem de memórias ativadas para cada label de uma dada entrada.
+		 * @param numLabels Quantidade de labels.
+		 * @return Valor percentual de confiança.
+		 */
+		float calculateConfidence(const float *result, int numLabels);
+
+		/**
+		 * @brief Obtém o maior valor de um vetor de porcentagens indexado pelas labels.
+		 * @param values Porcentagem de memórias ativadas para cada label de uma dada entrada.
+		 * @param numLabels Quantidade de labels.
+		 * @return Máximo valor de porcentagem de memórias ativadas.
+		 */
+		float maxValue(const float *values, int numLabels);
+
+		/**
+		 * @brief Seleciona o índice da label com maior porcentagem de acertos; em caso de empate, o maior índice.
+		 * @param values Porcentagem de memórias ativadas para cada label de uma dada entrada.
+		 * @param numLabels Quantidade de labels.
+		 * @return Índice da label que obteve mais memórias ativadas, ou -1 caso numLabels seja zero.
+		 */
+		int argMax(const float *values, int numLabels);
+
+		/**
+		 * @brief Conta quantos valores são maiores que threshold e, opcionalmente, obtém o menor deles.
+		 * Utiliza instruções SIMD (SSE2, AVX2 ou AVX-512), escolhidas em tempo de execução de acordo
+		 * com o processador, ou um laço escalar nos demais casos.
+		 * @param values Vetor de valores, como o conteúdo das memórias de um discriminador.
+		 * @param count Quantidade de valores.
+		 * @param threshold Limiar; são contados os valores estritamente maiores.
+		 * @param minAbove Saída opcional (pode ser nula): menor valor maior que threshold, ou INT_MAX caso não haja.
+		 * @return Quantidade de valores maiores que threshold.
+		 */
+		int countGreater(const int *values, int count, int threshold, int *minAbove = NULL);
+
+		/**
+		 * @brief Conta, para cada linha de uma matriz armazenada por linhas, quantos valores são maiores que threshold.
+		 * @param values Matriz de numRows x rowLength valores, como o conteúdo das memórias de vários discriminadores.
+		 * @param numRows Quantidade de linhas.
+		 * @param rowLength Quantidade de valores de cada linha.
+		 * @param threshold Limiar; são contados os valores estritamente maiores.
+		 * @param counts Vetor de saída, com numRows posições.
+		 */
+		void countGreater(const int *values, int numRows, int rowLength, int threshold, int *counts);
+
+		/**
+		 * @brief Retorna o nome do conjunto de instruções utilizado por countGreater ("avx512", "avx2", "sse2" ou "scalar").
+		 */
+		const char *getSimdInstructionSet(void);
 	}
 }
 
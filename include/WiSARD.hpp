@@ -9,10 +9,18 @@
 #define WISARD_HPP_
 
 #include "./Discriminator.hpp"
+#include "./BitRetina.hpp"
+#include "./SparseRetina.hpp"
+#include "./Encoder.hpp"
+#include "./TupleMapping.hpp"
+#include "./ThreadPool.hpp"
+#include "./Stats.hpp"
 
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
 
 
 namespace wann
@@ -24,6 +32,21 @@ namespace wann
 	class WiSARD
 	{
 		public:
+			/**
+			 * Parâmetros utilizados no cálculo das porcentagens, que não alteram o conteúdo das memórias.
+			 */
+			struct ScoringOptions
+			{
+				/** Flag para sinalizar se deve-se ou não utilizar bleaching.*/
+				bool useBleaching;
+				/** Valor limite para a confiança, que é a diferença percentual entre os dois melhores resultados da rede.*/
+				float confidenceThreshold;
+				/** Valor padrão para o bleaching.*/
+				int defaultBleaching_b;
+				/** Flag para sinalizar se o primeiro endereço das memórias deve ser omitido na análise.*/
+				bool ignoreZeroAddr;
+			};
+
 			/**
 			 * @brief Construtor da classe
 			 * @param retinaLength Comprimento da retina.
@@ -51,18 +74,126 @@ namespace wann
 
 			/**
 			 * @brief Método responsável pela criação e treinamento de objetos do tipo
-			 * Discriminator, associados as entradas.
+			 * Discriminator, associados as entradas. Descarta o treinamento anterior da rede.
 			 * @param X Matriz de inteiros, cada linha é uma entrada a ser treinada pela rede.
 			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
 			 */
 			void fit(const std::vector< std::vector<int> > &X, const std::vector<std::string> &y);
 
+			/**
+			 * @brief Método responsável pela criação e treinamento de objetos do tipo
+			 * Discriminator, associados as entradas empacotadas. Descarta o treinamento anterior da rede.
+			 * @param X Vetor de retinas empacotadas, cada uma é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 */
+			void fit(const std::vector<BitRetina> &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Método responsável pela criação e treinamento de objetos do tipo
+			 * Discriminator, associados as entradas esparsas. Descarta o treinamento anterior da rede.
+			 * Os endereços são calculados a partir das posições ativas (ver TupleMapping). Nesta e nas demais
+			 * entradas esparsas, retinas com comprimento diferente de retinaLength geram um warning e encerram a execução.
+			 * @param X Vetor de retinas esparsas, cada uma é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 */
+			void fit(const std::vector<SparseRetina> &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Método responsável pela criação e treinamento de objetos do tipo
+			 * Discriminator, associados a entradas numéricas, codificadas pelo Encoder da rede.
+			 * Descarta o treinamento anterior da rede.
+			 * @param X Matriz de atributos, cada linha é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 */
+			void fit(const std::vector< std::vector<float> > &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Treina a rede com novas entradas, somando-as ao treinamento já existente.
+			 * Apenas labels ainda não vistas ganham novos objetos Discriminator.
+			 * @param X Matriz de inteiros, cada linha é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 */
+			void partialFit(const std::vector< std::vector<int> > &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Treina a rede com novas entradas empacotadas, somando-as ao treinamento já existente.
+			 * Apenas labels ainda não vistas ganham novos objetos Discriminator.
+			 * @param X Vetor de retinas empacotadas, cada uma é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 */
+			void partialFit(const std::vector<BitRetina> &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Treina a rede com novas entradas esparsas, somando-as ao treinamento já existente.
+			 * @param X Vetor de retinas esparsas, cada uma é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 */
+			void partialFit(const std::vector<SparseRetina> &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Treina a rede com novas entradas numéricas, somando-as ao treinamento já existente.
+			 * @param X Matriz de atributos, cada linha é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 */
+			void partialFit(const std::vector< std::vector<float> > &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Treina a rede com uma única entrada, somando-a ao treinamento já existente.
+			 * @param retina Vetor de bits a ser treinado.
+			 * @param label Label associada à entrada.
+			 */
+			void train(const std::vector<int> &retina, const std::string &label);
+
+			/**
+			 * @brief Treina a rede com uma única entrada empacotada, somando-a ao treinamento já existente.
+			 * @param retina Retina empacotada a ser treinada.
+			 * @param label Label associada à entrada.
+			 */
+			void train(const BitRetina &retina, const std::string &label);
+
+			/**
+			 * @brief Treina a rede com uma única entrada esparsa, somando-a ao treinamento já existente.
+			 * @param retina Retina esparsa a ser treinada.
+			 * @param label Label associada à entrada.
+			 */
+			void train(const SparseRetina &retina, const std::string &label);
+
+			/**
+			 * @brief Treina a rede com uma única entrada numérica, somando-a ao treinamento já existente.
+			 * @param features Atributos da entrada a ser treinada.
+			 * @param label Label associada à entrada.
+			 */
+			void train(const std::vector<float> &features, const std::string &label);
+
 			/**
 			 * @brief Seleciona uma label para cada entrada, na qual a label selecionado teve maior porcentagem de memórias ativadas.
 			 * @param X Matriz de inteiros, cada linha é uma entrada a ser classificada pela rede.
 			 * @return Vetor de strings, cada string representa a label na qual ocorreu maior porcentagem de memórias ativadas.
 			 */
 			std::vector<std::string> predict(const std::vector< std::vector<int> > &X);
+
+			/**
+			 * @brief Seleciona uma label para cada entrada empacotada, na qual a label selecionado teve maior porcentagem de memórias ativadas.
+			 * @param X Vetor de retinas empacotadas, cada uma é uma entrada a ser classificada pela rede.
+			 * @return Vetor de strings, cada string representa a label na qual ocorreu maior porcentagem de memórias ativadas.
+			 */
+			std::vector<std::string> predict(const std::vector<BitRetina> &X);
+
+			/**
+			 * @brief Seleciona uma label para cada entrada esparsa, na qual a label selecionado teve maior porcentagem de memórias ativadas.
+			 * Apenas as memórias com alguma posição ativa são lidas; as demais utilizam o conteúdo no endereço zero,
+			 * lido uma única vez após o treinamento. A interrupção antecipada (ver setEarlyExit) não é utilizada.
+			 * @param X Vetor de retinas esparsas, cada uma é uma entrada a ser classificada pela rede.
+			 * @return Vetor de strings, cada string representa a label na qual ocorreu maior porcentagem de memórias ativadas.
+			 */
+			std::vector<std::string> predict(const std::vector<SparseRetina> &X);
+
+			/**
+			 * @brief Seleciona uma label para cada entrada numérica, na qual a label selecionado teve maior porcentagem de memórias ativadas.
+			 * @param X Matriz de atributos, cada linha é uma entrada a ser classificada pela rede.
+			 * @return Vetor de strings, cada string representa a label na qual ocorreu maior porcentagem de memórias ativadas.
+			 */
+			std::vector<std::string> predict(const std::vector< std::vector<float> > &X);
 			
 			/**
 			 * @brief Calcula a porcentagem de memórias ativadas para cada discriminador de cada entrada da matriz X.
@@ -71,7 +202,285 @@ namespace wann
 			 */
 			std::vector<std::unordered_map<std::string, float>> predictProba(const std::vector<std::vector<int> > &X);
 
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada discriminador de cada entrada empacotada.
+			 * @param X Vetor de retinas empacotadas, cada uma é uma entrada a ser classificada pela rede.
+			 * @return Unordered_map contendo a porcentagem de memórias ativadas para cada label de cada entrada de X.
+			 */
+			std::vector<std::unordered_map<std::string, float>> predictProba(const std::vector<BitRetina> &X);
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada discriminador de cada entrada esparsa.
+			 * @param X Vetor de retinas esparsas, cada uma é uma entrada a ser classificada pela rede.
+			 * @return Unordered_map contendo a porcentagem de memórias ativadas para cada label de cada entrada de X.
+			 */
+			std::vector<std::unordered_map<std::string, float>> predictProba(const std::vector<SparseRetina> &X);
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada discriminador de cada entrada numérica.
+			 * @param X Matriz de atributos, cada linha é uma entrada a ser classificada pela rede.
+			 * @return Unordered_map contendo a porcentagem de memórias ativadas para cada label de cada entrada de X.
+			 */
+			std::vector<std::unordered_map<std::string, float>> predictProba(const std::vector< std::vector<float> > &X);
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada discriminador de cada entrada da matriz X,
+			 * escrevendo-a em uma matriz de floats pré-alocada pelo chamador.
+			 * @param X Matriz de inteiros, cada linha é uma entrada a ser classificada pela rede.
+			 * @param scores Matriz de saída, com X.size() linhas e getNumLabels() colunas, armazenada por linhas:
+			 * a porcentagem da entrada i para a label de índice c fica em scores[i * getNumLabels() + c].
+			 */
+			void predictScores(const std::vector< std::vector<int> > &X, float *scores);
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada discriminador de cada entrada empacotada,
+			 * escrevendo-a em uma matriz de floats pré-alocada pelo chamador.
+			 * @param X Vetor de retinas empacotadas, cada uma é uma entrada a ser classificada pela rede.
+			 * @param scores Matriz de saída, com X.size() linhas e getNumLabels() colunas, armazenada por linhas.
+			 */
+			void predictScores(const std::vector<BitRetina> &X, float *scores);
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada discriminador de cada entrada esparsa,
+			 * escrevendo-a em uma matriz de floats pré-alocada pelo chamador.
+			 * @param X Vetor de retinas esparsas, cada uma é uma entrada a ser classificada pela rede.
+			 * @param scores Matriz de saída, com X.size() linhas e getNumLabels() colunas, armazenada por linhas.
+			 */
+			void predictScores(const std::vector<SparseRetina> &X, float *scores);
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada discriminador de cada entrada numérica,
+			 * escrevendo-a em uma matriz de floats pré-alocada pelo chamador.
+			 * @param X Matriz de atributos, cada linha é uma entrada a ser classificada pela rede.
+			 * @param scores Matriz de saída, com X.size() linhas e getNumLabels() colunas, armazenada por linhas.
+			 */
+			void predictScores(const std::vector< std::vector<float> > &X, float *scores);
+
+			/**
+			 * @brief Seleciona, para cada entrada, o índice da label com maior porcentagem de memórias ativadas.
+			 * @param X Matriz de inteiros, cada linha é uma entrada a ser classificada pela rede.
+			 * @return Vetor com o índice da label selecionada para cada entrada (-1 caso a rede não possua labels).
+			 */
+			std::vector<int> predictLabelIndices(const std::vector< std::vector<int> > &X);
+
+			/**
+			 * @brief Seleciona, para cada entrada empacotada, o índice da label com maior porcentagem de memórias ativadas.
+			 * @param X Vetor de retinas empacotadas, cada uma é uma entrada a ser classificada pela rede.
+			 * @return Vetor com o índice da label selecionada para cada entrada (-1 caso a rede não possua labels).
+			 */
+			std::vector<int> predictLabelIndices(const std::vector<BitRetina> &X);
+
+			/**
+			 * @brief Seleciona, para cada entrada esparsa, o índice da label com maior porcentagem de memórias ativadas.
+			 * @param X Vetor de retinas esparsas, cada uma é uma entrada a ser classificada pela rede.
+			 * @return Vetor com o índice da label selecionada para cada entrada (-1 caso a rede não possua labels).
+			 */
+			std::vector<int> predictLabelIndices(const std::vector<SparseRetina> &X);
+
+			/**
+			 * @brief Seleciona, para cada entrada numérica, o índice da label com maior porcentagem de memórias ativadas.
+			 * @param X Matriz de atributos, cada linha é uma entrada a ser classificada pela rede.
+			 * @return Vetor com o índice da label selecionada para cada entrada (-1 caso a rede não possua labels).
+			 */
+			std::vector<int> predictLabelIndices(const std::vector< std::vector<float> > &X);
+
+			/**
+			 * @brief Seleciona, para cada entrada e para cada conjunto de parâmetros de options, o índice da label
+			 * com maior porcentagem de memórias ativadas. O conteúdo das memórias é lido uma única vez por entrada.
+			 * Omitir o primeiro endereço é efetivo caso esteja ativo em options ou na própria rede.
+			 * @param X Matriz de inteiros, cada linha é uma entrada a ser classificada pela rede.
+			 * @param options Conjuntos de parâmetros a serem avaliados.
+			 * @param labelIndices Matriz de saída, com X.size() linhas e options.size() colunas, armazenada por linhas:
+			 * o índice da entrada i com os parâmetros k fica em labelIndices[i * options.size() + k].
+			 */
+			void predictLabelIndices(const std::vector< std::vector<int> > &X, const std::vector<ScoringOptions> &options, int *labelIndices);
+
+			/**
+			 * @brief Mesmo comportamento do membro anterior, para entradas empacotadas.
+			 * @param X Vetor de retinas empacotadas, cada uma é uma entrada a ser classificada pela rede.
+			 * @param options Conjuntos de parâmetros a serem avaliados.
+			 * @param labelIndices Matriz de saída, com X.size() linhas e options.size() colunas, armazenada por linhas.
+			 */
+			void predictLabelIndices(const std::vector<BitRetina> &X, const std::vector<ScoringOptions> &options, int *labelIndices);
+
+			/**
+			 * @brief Retorna os parâmetros de cálculo das porcentagens utilizados pela rede.
+			 */
+			ScoringOptions getScoringOptions(void) const;
+
+			/**
+			 * @brief Ativa ou desativa a interrupção antecipada de predict e predictLabelIndices. Com ela, as memórias
+			 * são lidas em blocos, na ordem das tuplas, e uma label deixa de ser avaliada quando não pode mais
+			 * alcançar a label com mais memórias ativadas; com bleaching, a predição termina quando a confiança
+			 * mínima garantida atinge confidenceThreshold. A label selecionada é a mesma da avaliação completa.
+			 * Não afeta predictProba e predictScores, e não é salvo pelo membro save.
+			 * @param earlyExit Flag para sinalizar se a interrupção antecipada deve ser utilizada.
+			 */
+			void setEarlyExit(bool earlyExit);
+
+			/**
+			 * @brief Retorna verdadeiro caso a interrupção antecipada de predict e predictLabelIndices esteja ativa.
+			 */
+			bool getEarlyExit(void) const;
+
+			/**
+			 * @brief Define o codificador das entradas numéricas. Os endereços das memórias passam a ser
+			 * calculados diretamente a partir dos atributos, sem que as retinas sejam montadas.
+			 * O codificador não é salvo pelo membro save.
+			 * @param encoder Codificador, cuja retina deve ter comprimento retinaLength.
+			 */
+			void setEncoder(const Encoder &encoder);
+
+			/**
+			 * @brief Retorna o codificador das entradas numéricas (vazio caso não tenha sido definido).
+			 */
+			const Encoder &getEncoder(void) const;
+
+			/**
+			 * @brief Passa a representar cada memória por uma tabela de hash de tamanho fixo (count-min sketch
+			 * com funções H3), de numHashes linhas de numCells contadores, independente da quantidade de
+			 * padrões treinados. O conteúdo lido de uma memória nunca é inferior ao exato. Não tem efeito se a
+			 * tabela não for menor que os 2^numBitsAddr endereços de cada memória. Deve ser chamado antes do treinamento.
+			 * @param numHashes Quantidade de funções de hash (entre 1 e H3Hash::MAX_HASHES).
+			 * @param numCells Quantidade de contadores por função de hash.
+			 * @param hashSeed Semente das funções de hash.
+			 */
+			void setHashedMemories(int numHashes, int numCells, unsigned hashSeed=0);
+
+			/**
+			 * @brief Retorna a semente utilizada para embaralhar o mapeamento da entrada.
+			 */
+			unsigned getSeed(void) const;
+
+			/**
+			 * @brief Embaralha o mapeamento da entrada com uma semente escolhida, da mesma forma que o construtor
+			 * com randomizePositions. Redes com a mesma semente e o mesmo retinaLength possuem o mesmo mapeamento.
+			 * Deve ser chamado antes do treinamento.
+			 * @param seed Semente do embaralhamento.
+			 */
+			void setSeed(unsigned seed);
+
+			/**
+			 * @brief Retorna o mapeamento da entrada: a posição da retina utilizada por cada bit das tuplas.
+			 */
+			const std::vector<int> &getMemoryAddressMapping(void) const;
+
+			/**
+			 * @brief Substitui o mapeamento da entrada, por exemplo pelo de outra rede. Deve ser chamado antes do treinamento.
+			 * @param memoryAddressMapping Permutação das posições 0 ... retinaLength - 1.
+			 */
+			void setMemoryAddressMapping(const std::vector<int> &memoryAddressMapping);
+
+			/**
+			 * @brief Soma à rede o conteúdo das memórias de outra rede, como se as entradas treinadas pela outra
+			 * também tivessem sido treinadas por esta. Discriminadores de mesma label são somados (redes cumulativas)
+			 * ou combinados (redes não cumulativas), e as labels ausentes são criadas ao final, na ordem da outra rede.
+			 * As redes devem possuir o mesmo retinaLength, numBitsAddr, mapeamento da entrada, cumulatividade e
+			 * configuração de memórias com hash; os parâmetros de cálculo das porcentagens desta rede são mantidos.
+			 * @param other Rede a ser somada.
+			 * @return Falso, com um warning, caso as redes não sejam compatíveis.
+			 */
+			bool merge(const WiSARD &other);
+
+			/**
+			 * @brief Cria uma cópia independente da rede, com os mesmos parâmetros, mapeamento da entrada,
+			 * codificador, labels e conteúdo das memórias. A cópia não utiliza ThreadPool (ver setThreadPool).
+			 * @return Cópia da rede, a ser deletada pelo chamador.
+			 */
+			WiSARD *clone(void) const;
+
+			/**
+			 * @brief Carrega redes salvas pelo membro save, treinadas em partições distintas das entradas
+			 * (possivelmente em processos ou máquinas distintos), e as soma através do membro merge, em pares,
+			 * em paralelo. A rede resultante é a mesma da soma das redes na ordem de paths.
+			 * @param paths Caminhos dos arquivos.
+			 * @param numThreads Quantidade de threads utilizadas (ver setNumThreads).
+			 * @return Rede somada, a ser deletada pelo chamador, ou nulo caso algum arquivo seja inválido ou as redes
+			 * não sejam compatíveis.
+			 */
+			static WiSARD *reduce(const std::vector<std::string> &paths, int numThreads=1);
+
+			/**
+			 * @brief Retorna a quantidade de labels conhecidas pela rede.
+			 */
+			int getNumLabels(void) const;
+
+			/**
+			 * @brief Retorna as labels conhecidas pela rede; a posição de cada label é o seu índice.
+			 */
+			const std::vector<std::string> &getLabels(void) const;
+
+			/**
+			 * @brief Retorna o índice de uma label.
+			 * @param label Label a ser buscada.
+			 * @return Índice da label, ou -1 caso ela não seja conhecida pela rede.
+			 */
+			int getLabelIndex(const std::string &label) const;
+
+			/**
+			 * @brief Retorna a ocupação das memórias de todos os discriminadores: contadores utilizados,
+			 * fatores de carga, bytes e histogramas dos conteúdos.
+			 */
+			WiSARDStats getStats(void) const;
+
+			/**
+			 * @brief Retorna os contadores e tempos acumulados por fit, partialFit, train e pelos membros de predição
+			 * desde a criação da rede ou a última chamada a resetProfile. Os valores são nulos caso a biblioteca
+			 * não tenha sido compilada com WANN_PROFILE (ver Profiler::isEnabled).
+			 */
+			RuntimeProfile getProfile(void) const;
+
+			/**
+			 * @brief Zera os contadores e tempos retornados por getProfile.
+			 */
+			void resetProfile(void);
+
+			/**
+			 * @brief Salva a rede, incluindo o mapeamento da entrada e o conteúdo de todas as memórias,
+			 * em um arquivo binário. O arquivo é escrito em um arquivo temporário e renomeado ao final, de forma
+			 * que uma rede carregada do mesmo caminho com useMmap continua válida.
+			 * @param path Caminho do arquivo.
+			 * @return Falso caso o arquivo não possa ser escrito.
+			 */
+			bool save(const std::string &path) const;
+
+			/**
+			 * @brief Carrega uma rede salva pelo membro save.
+			 * @param path Caminho do arquivo.
+			 * @param useMmap Flag para sinalizar se as memórias densas devem ser utilizadas diretamente
+			 * a partir do arquivo mapeado em memória, sem cópia.
+			 * @return Rede carregada, a ser deletada pelo chamador, ou nulo caso o arquivo seja inválido.
+			 */
+			static WiSARD *load(const std::string &path, bool useMmap=true);
+
+			/**
+			 * @brief Define a quantidade de threads utilizadas por fit, predict e predictProba.
+			 * @param numThreads Quantidade de threads. 1 desativa o paralelismo; valores menores
+			 * que 1 utilizam a quantidade de núcleos da máquina.
+			 */
+			void setNumThreads(int numThreads);
+
+			/**
+			 * @brief Define o ThreadPool utilizado por fit, predict e predictProba.
+			 * @param threadPool ThreadPool a ser utilizado, possivelmente compartilhado com outras redes.
+			 * Um ponteiro nulo desativa o paralelismo.
+			 */
+			void setThreadPool(std::shared_ptr<ThreadPool> threadPool);
+
+			/**
+			 * @brief Retorna a quantidade de threads utilizadas por fit, predict e predictProba.
+			 */
+			int getNumThreads(void) const;
+
+			/**
+			 * @brief Retorna o ThreadPool utilizado por fit, predict e predictProba (nulo quando serial).
+			 */
+			std::shared_ptr<ThreadPool> getThreadPool(void) const;
+
 		private:
+			/** Sessões de classificação incremental utilizam o endereçamento e o cálculo das porcentagens da rede.*/
+			friend class ScoringSession;
+
 			/** Comprimento da retina.*/
 			int retinaLength;
 			/** Número de bits a ser utilizado para endereçamento.*/
@@ -90,21 +499,229 @@ namespace wann
 			bool ignoreZeroAddr;
 			/** Semente aleatória utilizada para se embaralhar o endereçamento da entrada.*/
 			unsigned seed;
-			/** Mapa de objetos Discriminator associados ao objeto WiSARD;*/
-			std::unordered_map <std::string, Discriminator*> discriminators;
+			/** Flag para sinalizar se predict e predictLabelIndices podem interromper a avaliação das labels.*/
+			bool earlyExit;
+			/** Labels conhecidas pela rede; a posição de cada label é o seu índice.*/
+			std::vector<std::string> labels;
+			/** Índice de cada label conhecida pela rede.*/
+			std::unordered_map<std::string, int> labelIndices;
+			/** Objetos Discriminator associados ao objeto WiSARD, na posição do índice de sua label.*/
+			std::vector<Discriminator *> discriminators;
 			/** Vetor auxiliar, utilizado para auxiliar o endereçamento da entrada.*/
 			std::vector<int> memoryAddressMapping;
+			/** Objeto que transforma as entradas nos endereços de cada memória, comum a todos os discriminadores.*/
+			TupleMapping tupleMapping;
+			/** Família de hash H3 das memórias com hash (nula quando as memórias são exatas).*/
+			std::shared_ptr<const H3Hash> hash;
+			/** Bloco com um bit por endereço das memórias de todos os discriminadores, com um slot por label
+			 * (nulo quando a rede é cumulativa ou utiliza hash).*/
+			std::shared_ptr<BitArena> bitArena;
+			/** ThreadPool utilizado para processar as entradas em paralelo (nulo quando serial).*/
+			std::shared_ptr<ThreadPool> threadPool;
+			/** Contadores e tempos dos caminhos de treinamento e de predição.*/
+			Profiler profiler;
+
+			/**
+			 * Conteúdo das memórias de todos os discriminadores no endereço zero, utilizado pelas entradas
+			 * esparsas para as memórias sem posição ativa.
+			 */
+			struct ZeroResponses
+			{
+				/** Conteúdo das memórias de cada label no endereço zero, armazenado por label.*/
+				std::vector<int> responses;
+				/** Quantidade de memórias de cada label ativadas no endereço zero.*/
+				std::vector<int> activeCounts;
+			};
+
+			/** Conteúdo no endereço zero, lido na primeira predição de entradas esparsas após o treinamento (nulo antes disso).*/
+			mutable std::shared_ptr<const ZeroResponses> zeroResponses;
+			/** Protege a leitura do membro interno zeroResponses por predições concorrentes.*/
+			mutable std::mutex zeroResponsesMutex;
+
+			/**
+			 * Vetores temporários utilizados no cálculo das porcentagens de uma entrada, reaproveitados entre entradas.
+			 */
+			struct ScoringBuffers
+			{
+				/**
+				 * @brief Construtor da estrutura.
+				 * @param numMemories Quantidade de memórias de cada discriminador.
+				 */
+				explicit ScoringBuffers(int numMemories);
+
+				/** Endereço de cada memória para a entrada corrente.*/
+				std::vector<long long> addresses;
+				/** Conteúdo das memórias de cada label, armazenado por label.*/
+				std::vector<int> responses;
+				/** Conteúdo das memórias de cada label, com o primeiro endereço omitido.*/
+				std::vector<int> maskedResponses;
+				/** Quantidade de memórias ativadas de cada label.*/
+				std::vector<int> activeCounts;
+				/** Índices das labels ainda avaliadas pela interrupção antecipada, em ordem crescente.*/
+				std::vector<int> candidates;
+				/** Memórias com alguma posição ativa da entrada esparsa corrente.*/
+				std::vector<int> touched;
+				/** Porcentagens com o bleaching corrente aplicado.*/
+				std::vector<float> bleachedScores;
+				/** Contadores e tempos da thread que utiliza os vetores.*/
+				LocalProfile profile;
+			};
 
 			/**
 			 * @brief Responsável pela implmentação da técnica de bleaching.
-			 * @param result Unordered_map contendo a porcentagem de memórias ativadas para cada label de uma dada entrada.
-			 * @param memoryResult Vetor com o conteúdo de cada memória, endereçado por uma porção de bits de uma dada entrada.
-			 * @return Unordered_map contendo a porcentagem de memórias ativadas para cada label de uma dada entrada com bleaching aplicado.
+			 * @param scores Porcentagem de memórias ativadas para cada label, substituída pela porcentagem com bleaching aplicado.
+			 * @param buffers Vetores temporários.
+			 * @param responses Conteúdo das memórias de cada label, armazenado por label.
+			 * @param options Parâmetros do bleaching.
 			 */
-			std::unordered_map <std::string,float> applyBleaching(std::unordered_map<std::string,float> &result,
-				std::unordered_map<std::string, std::vector<int>> &memoryResult);
+			void applyBleaching(float *scores, ScoringBuffers &buffers, const int *responses, const ScoringOptions &options) const;
 
+			/**
+			 * @brief Lê, de todos os discriminadores, o conteúdo das memórias nos endereços de uma entrada.
+			 * @param buffers Vetores temporários, com os endereços da entrada em addresses; o conteúdo é escrito em responses.
+			 */
+			void fetchResponses(ScoringBuffers &buffers) const;
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada label, a partir do conteúdo já lido das memórias.
+			 * @param scores Vetor de saída, com getNumLabels() posições.
+			 * @param buffers Vetores temporários, com os endereços em addresses e o conteúdo das memórias em responses.
+			 * @param options Parâmetros do cálculo.
+			 */
+			void scoreResponses(float *scores, ScoringBuffers &buffers, const ScoringOptions &options) const;
+
+			/**
+			 * @brief Calcula a porcentagem de memórias ativadas para cada label, a partir dos endereços de uma entrada.
+			 * @param scores Vetor de saída, com getNumLabels() posições.
+			 * @param buffers Vetores temporários, com os endereços da entrada em addresses.
+			 */
+			void scoreAddresses(float *scores, ScoringBuffers &buffers) const;
+
+			/**
+			 * @brief Seleciona o índice da label de uma entrada com interrupção antecipada (ver setEarlyExit).
+			 * @param scores Vetor auxiliar, com getNumLabels() posições, utilizado quando o bleaching é necessário.
+			 * @param buffers Vetores temporários, com os endereços da entrada em addresses.
+			 * @return Índice da label selecionada (-1 caso a rede não possua labels).
+			 */
+			int predictEarlyExit(float *scores, ScoringBuffers &buffers) const;
+
+			/**
+			 * @brief Implementação do membro predictLabelIndices com vários conjuntos de parâmetros.
+			 * @param X Vetor de retinas, cada uma é uma entrada a ser classificada pela rede.
+			 * @param options Conjuntos de parâmetros a serem avaliados.
+			 * @param labelIndices Matriz de saída, com X.size() linhas e options.size() colunas.
+			 */
+			template<typename RetinaType>
+			void scoreRetinasOptions(const std::vector<RetinaType> &X, const std::vector<ScoringOptions> &options, int *labelIndices);
+
+			/**
+			 * @brief Implementação comum dos membros predictScores e predictLabelIndices.
+			 * @param X Vetor de retinas, cada uma é uma entrada a ser classificada pela rede.
+			 * @param scores Matriz de saída das porcentagens, armazenada por linhas (pode ser nula).
+			 * @param labelIndices Vetor de saída com o índice da label selecionada para cada entrada (pode ser nulo).
+			 */
+			template<typename RetinaType>
+			void scoreRetinas(const std::vector<RetinaType> &X, float *scores, int *labelIndices);
 
+			/**
+			 * @brief Implementação comum dos membros predictScores e predictLabelIndices para entradas esparsas.
+			 * Apenas as memórias com alguma posição ativa são lidas.
+			 * @param X Vetor de retinas esparsas, cada uma é uma entrada a ser classificada pela rede.
+			 * @param scores Matriz de saída das porcentagens, armazenada por linhas (pode ser nula).
+			 * @param labelIndices Vetor de saída com o índice da label selecionada para cada entrada (pode ser nulo).
+			 */
+			void scoreRetinas(const std::vector<SparseRetina> &X, float *scores, int *labelIndices);
+
+			/**
+			 * @brief Retorna o conteúdo das memórias no endereço zero, lendo-o caso a rede tenha sido treinada
+			 * desde a última leitura.
+			 */
+			std::shared_ptr<const ZeroResponses> getZeroResponses(void) const;
+
+			/**
+			 * @brief Descarta o conteúdo no endereço zero já lido. Deve ser chamado sempre que o conteúdo das memórias muda.
+			 */
+			void clearZeroResponses(void);
+
+			/**
+			 * @brief Implementação do membro partialFit, comum a retinas de inteiros e empacotadas.
+			 * @param X Vetor de retinas, cada uma é uma entrada a ser treinada pela rede.
+			 * @param y Vetor de labels, deve existir exatamente uma label para cada entrada.
+			 */
+			template<typename RetinaType>
+			void partialFitRetinas(const std::vector<RetinaType> &X, const std::vector<std::string> &y);
+
+			/**
+			 * @brief Implementação do membro train, comum a todos os tipos de retina.
+			 * @param retina Entrada a ser treinada.
+			 * @param label Label associada à entrada.
+			 */
+			template<typename RetinaType>
+			void trainRetina(const RetinaType &retina, const std::string &label);
+
+			/**
+			 * @brief Retorna o índice de uma label, criando o seu discriminador caso ainda não exista.
+			 * @param label Label do discriminador.
+			 */
+			int getOrCreateLabelIndex(const std::string &label);
+
+			/**
+			 * @brief Deleta todos os discriminadores da rede.
+			 */
+			void clearDiscriminators(void);
+
+			/**
+			 * @brief Cria um bloco de bits vazio, que comporta as memórias de até Memory::DENSE_MAX_BITS bits;
+			 * memórias mais largas utilizam mapas de bits, e o bloco não possui endereços.
+			 */
+			std::shared_ptr<BitArena> createBitArena(void) const;
+
+			/**
+			 * @brief Retorna verdadeiro caso todas as memórias de todos os discriminadores estejam no bloco de bits,
+			 * com o discriminador de índice c no slot c.
+			 */
+			bool usesBitSlots(void) const;
+
+			/**
+			 * @brief Implementação do membro predictProba, comum a retinas de inteiros e empacotadas.
+			 * @param X Vetor de retinas, cada uma é uma entrada a ser classificada pela rede.
+			 * @return Unordered_map contendo a porcentagem de memórias ativadas para cada label de cada entrada de X.
+			 */
+			template<typename RetinaType>
+			std::vector<std::unordered_map<std::string, float>> predictProbaRetinas(const std::vector<RetinaType> &X);
+
+			/**
+			 * @brief Gera um warning e encerra a execução caso a rede não possua codificador ou caso alguma
+			 * entrada possua menos atributos que os utilizados pelo codificador.
+			 * @param X Matriz de atributos, cada linha é uma entrada da rede.
+			 */
+			void checkFeatures(const std::vector< std::vector<float> > &X) const;
+
+			/**
+			 * @brief Mesmo comportamento do membro checkFeatures para uma única entrada.
+			 * @param features Atributos da entrada.
+			 */
+			void checkFeatures(const std::vector<float> &features) const;
+
+			/**
+			 * @brief Gera um warning e encerra a execução caso o comprimento de alguma retina esparsa seja
+			 * diferente do comprimento da retina da rede, pois as suas posições indexam o mapeamento inverso.
+			 * @param X Vetor de retinas esparsas.
+			 */
+			void checkRetinaLength(const std::vector<SparseRetina> &X) const;
+
+			/**
+			 * @brief Mesmo comportamento do membro checkRetinaLength para uma única retina esparsa.
+			 * @param retina Retina esparsa.
+			 */
+			void checkRetinaLength(const SparseRetina &retina) const;
+
+			/**
+			 * @brief Converte índices de labels em labels.
+			 * @param indices Vetor de índices de labels.
+			 * @return Vetor com a label de cada índice.
+			 */
+			std::vector<std::string> labelsFromIndices(const std::vector<int> &indices) const;
 	};
 }
 
@@ -0,0 +1,110 @@
+/**
+ * @file   BitArena.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe BitArena.
+ */
+
+#include "../include/BitArena.hpp"
+
+#include <string.h>
+
+using namespace std;
+using namespace wann;
+
+/**
+ * O bloco começa vazio; os bytes são alocados pelo primeiro addSlot.
+ */
+BitArena::BitArena(int numRams, long long ramSize)
+:numRams(numRams), ramSize(ramSize), numSlots(0), strideBytes(0)
+{
+}
+
+/**
+ * Quando os bytes de cada endereço não comportam mais um slot, escolhe a nova largura
+ * (1, 2, 4, 8 bytes e, a partir daí, múltiplos de 8) e copia os bits de cada endereço
+ * para o início da sua nova faixa.
+ */
+int BitArena::addSlot(void)
+{
+	int neededBytes = numSlots / 8 + 1;
+	if(neededBytes > strideBytes)
+	{
+		int newStride = 1;
+		while(newStride < neededBytes && newStride < 8)
+			newStride *= 2;
+		if(neededBytes > 8)
+			newStride = (neededBytes + 7) / 8 * 8;
+
+		size_t numAddrs = (size_t) numRams * (size_t) ramSize;
+		vector<uint8_t> widened(numAddrs * (size_t) newStride, 0);
+		for(size_t i = 0; strideBytes > 0 && i < numAddrs; i++)
+			memcpy(widened.data() + i * newStride, bits.data() + i * strideBytes, strideBytes);
+
+		bits.swap(widened);
+		strideBytes = newStride;
+	}
+	return numSlots++;
+}
+
+int BitArena::getNumSlots(void) const
+{
+	return numSlots;
+}
+
+int BitArena::getStrideBytes(void) const
+{
+	return strideBytes;
+}
+
+int BitArena::getNumRams(void) const
+{
+	return numRams;
+}
+
+long long BitArena::getRamSize(void) const
+{
+	return ramSize;
+}
+
+long long BitArena::getBytes(void) const
+{
+	return (long long) bits.size();
+}
+
+/**
+ * Formato: quantidade de memórias, de endereços por memória, de slots e largura de cada
+ * endereço, seguidos dos bits, alinhados em 64 bytes.
+ */
+void BitArena::write(ModelWriter &writer) const
+{
+	writer.write((int32_t) numRams);
+	writer.write((int64_t) ramSize);
+	writer.write((int32_t) numSlots);
+	writer.write((int32_t) strideBytes);
+	writer.align(64);
+	writer.writeBytes(bits.data(), bits.size());
+}
+
+/**
+ * Os slots são criados pelos discriminadores lidos antes do bloco; aqui apenas o conteúdo é copiado.
+ */
+bool BitArena::read(ModelReader &reader)
+{
+	int32_t fileRams, fileSlots, fileStride;
+	int64_t fileRamSize;
+
+	if(!reader.read(fileRams) || !reader.read(fileRamSize) || !reader.read(fileSlots) || !reader.read(fileStride))
+		return false;
+	if(fileRams != numRams || fileRamSize != ramSize || fileSlots != numSlots || fileStride != strideBytes)
+		return false;
+
+	reader.align(64);
+	const char *bytes = reader.readBytes(bits.size());
+	if(bytes == NULL)
+		return false;
+	// a block without addresses (only bitmaps) has no data pointer
+	if(!bits.empty())
+		memcpy(bits.data(), bytes, bits.size());
+	return true;
+}
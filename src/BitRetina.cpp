@@ -0,0 +1,58 @@
+/**
+ * @file   BitRetina.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe BitRetina.
+ */
+
+#include "../include/BitRetina.hpp"
+
+using namespace std;
+using namespace wann;
+
+BitRetina::BitRetina(void)
+:length(0)
+{
+}
+
+/**
+ * Aloca (length + 63) / 64 palavras zeradas.
+ */
+BitRetina::BitRetina(int length)
+:words((length + 63) / 64, 0ULL), length(length)
+{
+}
+
+/**
+ * Ativa o bit de cada posição de retina cujo valor é diferente de zero,
+ * mesma convenção utilizada pelo endereçamento de Discriminator.
+ */
+BitRetina::BitRetina(const vector<int> &retina)
+:words((retina.size() + 63) / 64, 0ULL), length((int) retina.size())
+{
+	for(int i = 0; i < length; i++)
+	{
+		if(retina[i] != 0)
+			words[i >> 6] |= (1ULL << (i & 63));
+	}
+}
+
+int BitRetina::size(void) const
+{
+	return length;
+}
+
+const uint64_t *BitRetina::data(void) const
+{
+	return words.data();
+}
+
+uint64_t *BitRetina::data(void)
+{
+	return words.data();
+}
+
+int BitRetina::numWords(void) const
+{
+	return (int) words.size();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file   CompressedBitmap.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe CompressedBitmap.
+ */
+
+#include "../include/CompressedBitmap.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Busca binária pelo grupo e, dentro dele, teste do bit ou busca binária no vetor ordenado.
+ */
+bool CompressedBitmap::contains(long long value) const
+{
+	long long key = value >> 16;
+	vector<long long>::const_iterator it = lower_bound(keys.begin(), keys.end(), key);
+	if(it == keys.end() || *it != key)
+		return false;
+
+	const Container &container = containers[it - keys.begin()];
+	uint16_t low = (uint16_t) (value & 0xFFFF);
+	if(!container.words.empty())
+		return (container.words[low >> 6] >> (low & 63)) & 1ULL;
+	return binary_search(container.values.begin(), container.values.end(), low);
+}
+
+/**
+ * Cria o grupo, caso não exista, na sua posição ordenada. Um vetor ordenado que passa de
+ * ARRAY_MAX_SIZE valores é convertido em mapa de bits.
+ */
+void CompressedBitmap::insert(long long value)
+{
+	long long key = value >> 16;
+	vector<long long>::iterator it = lower_bound(keys.begin(), keys.end(), key);
+	size_t index = it - keys.begin();
+	if(it == keys.end() || *it != key)
+	{
+		keys.insert(it, key);
+		containers.insert(containers.begin() + index, Container());
+		containers[index].cardinality = 0;
+	}
+
+	Container &container = containers[index];
+	uint16_t low = (uint16_t) (value & 0xFFFF);
+	if(!container.words.empty())
+	{
+		uint64_t bit = 1ULL << (low & 63);
+		if((container.words[low >> 6] & bit) == 0)
+		{
+			container.words[low >> 6] |= bit;
+			container.cardinality++;
+		}
+		return;
+	}
+
+	vector<uint16_t>::iterator pos = lower_bound(container.values.begin(), container.values.end(), low);
+	if(pos != container.values.end() && *pos == low)
+		return;
+	container.values.insert(pos, low);
+	container.cardinality++;
+
+	if(container.cardinality > ARRAY_MAX_SIZE)
+	{
+		container.words.assign(1024, 0);
+		for(size_t i = 0; i < container.values.size(); i++)
+			container.words[container.values[i] >> 6] |= 1ULL << (container.values[i] & 63);
+		vector<uint16_t>().swap(container.values);
+	}
+}
+
+long long CompressedBitmap::size(void) const
+{
+	long long total = 0;
+	for(size_t i = 0; i < containers.size(); i++)
+		total += containers[i].cardinality;
+	return total;
+}
+
+long long CompressedBitmap::getBytes(void) const
+{
+	long long total = (long long) (keys.capacity() * sizeof(long long) + containers.capacity() * sizeof(Container));
+	for(size_t i = 0; i < containers.size(); i++)
+		total += (long long) (containers[i].values.capacity() * sizeof(uint16_t) + containers[i].words.capacity() * sizeof(uint64_t));
+	return total;
+}
+
+/**
+ * Formato: quantidade de grupos e, para cada grupo, a sua chave, a sua representação
+ * (0 para vetor ordenado, 1 para mapa de bits) e o seu conteúdo.
+ */
+void CompressedBitmap::write(ModelWriter &writer) const
+{
+	writer.write((int64_t) keys.size());
+	for(size_t i = 0; i < keys.size(); i++)
+	{
+		const Container &container = containers[i];
+		writer.write((int64_t) keys[i]);
+		writer.write((uint8_t) (container.words.empty() ? 0 : 1));
+		writer.write((int32_t) container.cardinality);
+		if(container.words.empty())
+			writer.writeBytes(container.values.data(), container.values.size() * sizeof(uint16_t));
+		else
+			writer.writeBytes(container.words.data(), container.words.size() * sizeof(uint64_t));
+	}
+}
+
+/**
+ * Valida a ordem das chaves, os limites dos endereços e a quantidade de valores de cada grupo.
+ * Os valores de um vetor devem ser estritamente crescentes (contains usa busca binária) e a
+ * quantidade de bits ligados de um mapa de bits deve ser igual à sua cardinalidade.
+ */
+bool CompressedBitmap::read(ModelReader &reader, long long maxValue)
+{
+	int64_t numContainers;
+	if(!reader.read(numContainers) || numContainers < 0)
+		return false;
+
+	keys.clear();
+	containers.clear();
+	for(int64_t i = 0; i < numContainers; i++)
+	{
+		int64_t key;
+		uint8_t isBitmap;
+		int32_t cardinality;
+		if(!reader.read(key) || !reader.read(isBitmap) || !reader.read(cardinality))
+			return false;
+		if(key < 0 || key > (maxValue >> 16) || (!keys.empty() && key <= keys.back())
+		   || cardinality < 1 || cardinality > 65536 || (!isBitmap && cardinality > ARRAY_MAX_SIZE))
+			return false;
+
+		Container container;
+		container.cardinality = cardinality;
+		size_t numBytes = isBitmap ? 1024 * sizeof(uint64_t) : (size_t) cardinality * sizeof(uint16_t);
+		const char *bytes = reader.readBytes(numBytes);
+		if(bytes == NULL)
+			return false;
+		// the file gives no alignment guarantee for the group contents
+		if(isBitmap)
+		{
+			container.words.resize(1024);
+			memcpy(container.words.data(), bytes, numBytes);
+			int numSet = 0;
+			for(size_t w = 0; w < container.words.size(); w++)
+				numSet += __builtin_popcountll(container.words[w]);
+			if(numSet != cardinality)
+				return false;
+		}
+		else
+		{
+			container.values.resize(cardinality);
+			memcpy(container.values.data(), bytes, numBytes);
+			for(size_t k = 1; k < container.values.size(); k++)
+			{
+				if(container.values[k] <= container.values[k - 1])
+					return false;
+			}
+		}
+
+		keys.push_back(key);
+		containers.push_back(container);
+	}
+	return true;
+}
@@ -0,0 +1,315 @@
+/**
+ * @file   DataLoader.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe DataLoader.
+ */
+
+#include "../include/DataLoader.hpp"
+#include "../include/ModelFile.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <stdint.h>
+
+using namespace std;
+using namespace wann;
+
+/** Identificador do início de um arquivo de retinas.*/
+static const char RETINA_MAGIC[8] = {'W','A','N','N','R','E','T','N'};
+/** Versão do formato do arquivo de retinas.*/
+static const uint32_t RETINA_VERSION = 1;
+/** Valor utilizado para detectar arquivos gravados com outra ordem de bytes.*/
+static const uint32_t RETINA_BYTE_ORDER = 0x01020304;
+
+
+/**
+ * Não mapeia o arquivo: file já foi mapeado pelo seu construtor, que não mapeia arquivos vazios.
+ * Quando não há mapeamento, apenas verifica se o arquivo existe, e um arquivo vazio é lido como
+ * um bloco vazio. Retorna falso e gera um warning caso o arquivo não exista ou não possa ser aberto.
+ */
+static bool openFile(const string &path, MappedFile &file)
+{
+	if(file.isOpen())
+		return true;
+
+	ifstream probe(path.c_str());
+	if(!probe.is_open())
+	{
+		cout << "WARNING: could not open data file " << path << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Lê um inteiro em [begin, end), aceitando espaços ao redor e sinal opcional.
+ * Retorna falso caso o campo não seja um inteiro ou não caiba em um int.
+ */
+static inline bool parseInt(const char *begin, const char *end, int &value)
+{
+	while(begin < end && (*begin == ' ' || *begin == '\t'))
+		begin++;
+	while(end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+		end--;
+
+	bool negative = false;
+	if(begin < end && (*begin == '-' || *begin == '+'))
+	{
+		negative = (*begin == '-');
+		begin++;
+	}
+	if(begin == end)
+		return false;
+
+	long long result = 0;
+	for(; begin < end; begin++)
+	{
+		unsigned digit = (unsigned) (*begin - '0');
+		if(digit > 9)
+			return false;
+		result = result * 10 + digit;
+		if(result > (long long) INT_MAX + 1)
+			return false;
+	}
+	if(negative)
+		result = -result;
+	if(result > INT_MAX)
+		return false;
+
+	value = (int) result;
+	return true;
+}
+
+/**
+ * Percorre o arquivo mapeado linha a linha. Para cada linha não vazia, a quantidade de valores é
+ * obtida contando as vírgulas, onRow é chamada uma vez e cada campo é convertido por parseInt.
+ * Aceita quebras de linha "\n" e "\r\n".
+ */
+template<typename ValueFunction, typename RowFunction>
+bool DataLoader::parseCsv(const string &path, ValueFunction onValue, RowFunction onRow)
+{
+	MappedFile file(path);
+	if(!openFile(path, file))
+		return false;
+
+	const char *cursor = file.data();
+	const char *fileEnd = cursor + file.size();
+	long long lineNumber = 0;
+	int row = 0;
+
+	while(cursor < fileEnd)
+	{
+		const char *lineEnd = (const char *) memchr(cursor, '\n', fileEnd - cursor);
+		if(lineEnd == NULL)
+			lineEnd = fileEnd;
+		const char *next = (lineEnd < fileEnd) ? lineEnd + 1 : fileEnd;
+		lineNumber++;
+
+		if(lineEnd > cursor && lineEnd[-1] == '\r')
+			lineEnd--;
+
+		const char *first = cursor;
+		while(first < lineEnd && (*first == ' ' || *first == '\t'))
+			first++;
+
+		if(first < lineEnd)
+		{
+			int numValues = (int) count(cursor, lineEnd, ',') + 1;
+			onRow(row, numValues);
+
+			const char *field = cursor;
+			for(int column = 0; column < numValues; column++)
+			{
+				const char *fieldEnd = (const char *) memchr(field, ',', lineEnd - field);
+				if(fieldEnd == NULL)
+					fieldEnd = lineEnd;
+
+				int value;
+				if(!parseInt(field, fieldEnd, value))
+				{
+					cout << "WARNING: invalid integer at line " << lineNumber << ", column " << column + 1
+						 << " of " << path << endl;
+					return false;
+				}
+				onValue(row, column, value);
+				field = fieldEnd + 1;
+			}
+			row++;
+		}
+		cursor = next;
+	}
+	return true;
+}
+
+/**
+ * Cada retina é alocada já com seu tamanho final, obtido pela quantidade de vírgulas da linha.
+ */
+bool DataLoader::loadCsv(const string &path, vector<vector<int>> &X)
+{
+	X.clear();
+	int *current = NULL;
+	bool ok = parseCsv(path,
+		[&](int, int column, int value)
+		{
+			current[column] = value;
+		},
+		[&](int, int numValues)
+		{
+			X.push_back(vector<int>(numValues));
+			current = X.back().data();
+		});
+	if(!ok)
+		X.clear();
+	return ok;
+}
+
+/**
+ * Os valores são escritos diretamente nas palavras de cada retina, sem passar por vector<int>.
+ */
+bool DataLoader::loadCsv(const string &path, vector<BitRetina> &X)
+{
+	X.clear();
+	uint64_t *current = NULL;
+	bool ok = parseCsv(path,
+		[&](int, int column, int value)
+		{
+			if(value != 0)
+				current[column >> 6] |= (1ULL << (column & 63));
+		},
+		[&](int, int numValues)
+		{
+			X.push_back(BitRetina(numValues));
+			current = X.back().data();
+		});
+	if(!ok)
+		X.clear();
+	return ok;
+}
+
+/**
+ * Vírgulas e quebras de linha separam rótulos; "\r" e espaços ao redor de cada rótulo são descartados,
+ * assim como campos vazios (por exemplo, após uma vírgula final).
+ */
+bool DataLoader::loadLabels(const string &path, vector<string> &y)
+{
+	y.clear();
+	MappedFile file(path);
+	if(!openFile(path, file))
+		return false;
+
+	const char *cursor = file.data();
+	const char *fileEnd = cursor + file.size();
+	while(cursor < fileEnd)
+	{
+		const char *fieldEnd = cursor;
+		while(fieldEnd < fileEnd && *fieldEnd != ',' && *fieldEnd != '\n')
+			fieldEnd++;
+
+		const char *begin = cursor, *end = fieldEnd;
+		while(begin < end && (*begin == ' ' || *begin == '\t'))
+			begin++;
+		while(end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+			end--;
+
+		if(begin < end)
+			y.push_back(string(begin, end));
+		cursor = fieldEnd + 1;
+	}
+	return true;
+}
+
+/**
+ * Formato (versão 1, na ordem de bytes da máquina): identificador, versão, marcador de ordem de bytes,
+ * comprimento das retinas, quantidade de retinas e, a partir de uma posição alinhada em 64 bytes,
+ * as palavras de todas as retinas em sequência.
+ */
+bool DataLoader::saveRetinas(const string &path, const vector<BitRetina> &X)
+{
+	int retinaLength = X.empty() ? 0 : X[0].size();
+	for(size_t i = 0; i < X.size(); i++)
+	{
+		if(X[i].size() != retinaLength)
+		{
+			cout << "WARNING: retinas must have the same length to be saved" << endl;
+			return false;
+		}
+	}
+	// retinas without positions would have no words, and loadRetinas could not bound their quantity
+	if(!X.empty() && retinaLength == 0)
+	{
+		cout << "WARNING: empty retinas can not be saved" << endl;
+		return false;
+	}
+
+	ModelWriter writer(path);
+	writer.writeBytes(RETINA_MAGIC, sizeof(RETINA_MAGIC));
+	writer.write(RETINA_VERSION);
+	writer.write(RETINA_BYTE_ORDER);
+	writer.write((int32_t) retinaLength);
+	writer.write((int64_t) X.size());
+	writer.align(64);
+	for(size_t i = 0; i < X.size(); i++)
+		writer.writeBytes(X[i].data(), X[i].numWords() * sizeof(uint64_t));
+
+	if(!writer.commit())
+	{
+		cout << "WARNING: could not write retina file " << path << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * As palavras de cada retina são copiadas do arquivo mapeado sem conversão. A quantidade de retinas
+ * do cabeçalho é validada contra o tamanho do arquivo antes de qualquer alocação; como retinas vazias
+ * não ocupam bytes, um arquivo que declare alguma é inválido.
+ */
+bool DataLoader::loadRetinas(const string &path, vector<BitRetina> &X)
+{
+	X.clear();
+	MappedFile file(path);
+	if(!file.isOpen())
+	{
+		cout << "WARNING: could not open retina file " << path << endl;
+		return false;
+	}
+
+	ModelReader reader(file.data(), file.size());
+	const char *magic = reader.readBytes(sizeof(RETINA_MAGIC));
+	uint32_t version = 0, byteOrder = 0;
+	int32_t retinaLength = -1;
+	int64_t numRetinas = -1;
+	reader.read(version);
+	reader.read(byteOrder);
+	reader.read(retinaLength);
+	reader.read(numRetinas);
+	reader.align(64);
+
+	size_t numWords = (retinaLength > 0) ? ((size_t) retinaLength + 63) / 64 : 0;
+	if(!reader.good() || magic == NULL || memcmp(magic, RETINA_MAGIC, sizeof(RETINA_MAGIC)) != 0
+	   || version != RETINA_VERSION || byteOrder != RETINA_BYTE_ORDER || retinaLength < 0 || numRetinas < 0
+	   || (numWords == 0 && numRetinas > 0)
+	   || (numWords > 0 && (uint64_t) numRetinas > file.size() / (numWords * sizeof(uint64_t))))
+	{
+		cout << "WARNING: invalid retina file " << path << endl;
+		return false;
+	}
+
+	X.reserve((size_t) numRetinas);
+	for(int64_t i = 0; i < numRetinas; i++)
+	{
+		const char *words = reader.readBytes(numWords * sizeof(uint64_t));
+		if(words == NULL)
+		{
+			cout << "WARNING: invalid retina file " << path << endl;
+			X.clear();
+			return false;
+		}
+		X.push_back(BitRetina(retinaLength));
+		memcpy(X.back().data(), words, numWords * sizeof(uint64_t));
+	}
+	return true;
+}
@@ -9,6 +9,11 @@
 #include "../include/Memory.hpp"
 
 #include <cmath>
+#include <memory>
+#include <stdint.h>
+#include <climits>
+#include <limits>
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -21,146 +26,468 @@ using namespace wann;
  * e os adiciona ao membro interno memories.
  * Se há resto na divisão, faz com que a última memória criada seja endereçada
  * pela quantidade de bits representados pelo resto.
+ * Quando numBits permite memórias densas, os contadores de todas as memórias
+ * são alocados de uma única vez, em um bloco RamArena compartilhado, no qual a
+ * memória i ocupa a faixa i.
+ * Quando há uma família de hash cuja tabela é menor que os 2^numBits endereços de uma memória,
+ * todas as memórias passam a utilizar hash, e o bloco armazena uma tabela por memória.
+ * Caso contrário, se as memórias não são cumulativas e há um bloco de bits, o discriminador
+ * ocupa um slot desse bloco em vez de criar o seu próprio bloco de contadores.
  */
 Discriminator::Discriminator(int retinaLength, 
                              int numBits,
                              vector<int> memoryAddressMapping, 
                              bool isCummulative, 
-                             bool ignoreZeroAddr)
+                             bool ignoreZeroAddr,
+                             shared_ptr<const H3Hash> hash,
+                             shared_ptr<BitArena> bits)
+: Discriminator(retinaLength, numBits, memoryAddressMapping, isCummulative, ignoreZeroAddr, hash, bits, shared_ptr<RamArena>())
+{
+}
+
+/**
+ * Escolhe a representação das memórias como descrito no construtor público. Quando ela prevê
+ * um bloco de contadores, utiliza counters, caso as suas dimensões correspondam às das memórias,
+ * e só aloca um bloco vazio caso contrário.
+ */
+Discriminator::Discriminator(int retinaLength,
+                             int numBits,
+                             const vector<int> &memoryAddressMapping,
+                             bool isCummulative,
+                             bool ignoreZeroAddr,
+                             shared_ptr<const H3Hash> hash,
+                             shared_ptr<BitArena> bits,
+                             shared_ptr<RamArena> counters)
 : retinaLength(retinaLength),
   numBitsAddr(numBits),
-  memoryAddressMapping(memoryAddressMapping),
+  numTrainings(0),
   isCummulative(isCummulative),
-  ignoreZeroAddr(ignoreZeroAddr)
+  ignoreZeroAddr(ignoreZeroAddr),
+  denseCounters(false),
+  bitSlot(-1),
+  denseBits(false),
+  tupleMapping(retinaLength, numBits, memoryAddressMapping)
 {
-    numMemories = (int) ceil(((float)retinaLength)/(float)numBits);
-    bool hasRestMemory = ((retinaLength % numBits) > 0) ? true : false;
+    numMemories = tupleMapping.getNumMemories();
+    long long ramSize = 0;
 
-    if(!hasRestMemory)
+    if(hash && (numBits >= 63 || hash->getTableSize() < (1LL << numBits)))
+    {
+        this->hash = hash;
+        ramSize = hash->getTableSize();
+    }
+    else if(bits && !isCummulative)
     {
-        for(int i=0; i<numMemories; i++)
-            memories.push_back(new Memory(numBits, isCummulative, ignoreZeroAddr));
+        this->bits = bits;
+        bitSlot = bits->addSlot();
     }
+    else if(numBits <= Memory::DENSE_MAX_BITS)
+        ramSize = 1LL << numBits;
+
+    if(ramSize > 0 && counters && counters->getNumRams() == numMemories && counters->getRamSize() == ramSize)
+        arena = counters;
+    else if(ramSize > 0)
+        arena = make_shared<RamArena>(numMemories, ramSize);
 
-    else
+    buildMemories();
+}
+
+/**
+ * Cria um objeto Memory para cada tupla. A última memória, quando retinaLength não é múltiplo
+ * de numBitsAddr, é endereçada pela quantidade de bits representados pelo resto.
+ * Se há um bloco de contadores (membro interno arena), a memória i ocupa a sua faixa i.
+ * Se há um bloco de bits, a memória i ocupa o slot do discriminador na sua memória i, ou,
+ * caso o bloco não comporte os seus endereços, um mapa de bits comprimido.
+ */
+void Discriminator::buildMemories(void)
+{
+    memories.clear();
+    memories.reserve(numMemories);
+    for(int i=0; i<numMemories; i++)
     {
-        for(int i=0; i<numMemories-1; i++)
-            memories.push_back(new Memory(numBits, isCummulative, ignoreZeroAddr));
+        int memoryBits = tupleMapping.getMemoryBits(i);
 
-        //the rest memory 
-        memories.push_back(new Memory((retinaLength % numBits), isCummulative, ignoreZeroAddr));
+        if(bits && memoryBits < 63 && (1LL << memoryBits) <= bits->getRamSize())
+            memories.push_back(Memory(memoryBits, ignoreZeroAddr, bits, i, bitSlot));
+        else if(bits)
+            memories.push_back(Memory(memoryBits, ignoreZeroAddr, make_shared<CompressedBitmap>()));
+        else if(hash)
+            memories.push_back(Memory(memoryBits, isCummulative, ignoreZeroAddr, arena, i, hash));
+        else if(arena)
+            memories.push_back(Memory(memoryBits, isCummulative, ignoreZeroAddr, arena, i));
+        else
+            memories.push_back(Memory(memoryBits, isCummulative, ignoreZeroAddr));
     }
+    updateDenseCounters();
 }
 
 /**
- * Deleta dinamicamente todas as memórias associadas ao Discriminator.
+ * Uma memória deixa o bloco quando é convertida em esparsa (contador não representável)
+ * ou quando é lida de um arquivo com outra representação.
+ */
+void Discriminator::updateDenseCounters(void)
+{
+    denseCounters = arena && !hash;
+    for(int i = 0; denseCounters && i < numMemories; i++)
+        denseCounters = memories[i].isStoredIn(arena.get());
+
+    denseBits = (bool) bits;
+    for(int i = 0; denseBits && i < numMemories; i++)
+        denseBits = memories[i].isStoredIn(bits.get());
+}
+
+/**
+ * As memórias e o bloco de contadores são liberados junto com o membro interno memories.
  */
 Discriminator::~Discriminator(void)
 {
-    for(int i = 0; i < memories.size(); i++)
-    {
-        delete memories[i];
-    }
 }
 
 /**
  * Segmenta a entrada em porções definidas pelo membro interno numBitsAddr.
- * O acesso a retina é chaveado pelo membro interno memoryAddressMapping.
+ * O acesso a retina é chaveado pelo membro interno tupleMapping.
  * Assim, cada grupo de bits, com comprimento numBitsAddr é relacionado com um objeto Memory.
  * Em seguida, se incrementa em 1, no objeto Memory associado, o endereço chaveado pelo grupo de bits anterior.
  */
 void Discriminator::addTrainning(const vector<int> &retina)
 {
-    int memIndex;
-    long long addr;
-    int lastMemoryPosition;
-    int restOfPositions;
-    long long base;
-    
-    // each group of numBitsAddr is related with a memory
-    for(int i=0; i <= retinaLength-numBitsAddr; i+= numBitsAddr)
+    vector<long long> addresses(numMemories);
+    tupleMapping.computeAddresses(retina, addresses.data());
+    addTrainning(addresses.data());
+}
+
+/**
+ * Mesmo comportamento do membro addTrainning para retinas de inteiros, porém os
+ * endereços são extraídos da retina empacotada.
+ */
+void Discriminator::addTrainning(const BitRetina &retina)
+{
+    vector<long long> addresses(numMemories);
+    tupleMapping.computeAddresses(retina, addresses.data());
+    addTrainning(addresses.data());
+}
+
+/**
+ * Incrementa em 1, em cada objeto Memory, o endereço correspondente.
+ */
+void Discriminator::addTrainning(const long long *addresses)
+{
+    numTrainings++;
+    addTrainning(addresses, 0, numMemories);
+    if(denseCounters && isCummulative && numTrainings > INT_MAX)
+        updateDenseCounters();
+}
+
+/**
+ * Incrementa em 1, em cada objeto Memory do intervalo, o endereço correspondente.
+ * Quando todas as memórias estão no bloco de bits, apenas ativa o bit do slot do discriminador.
+ * Quando todas as memórias estão no bloco de contadores, e o bloco não é lido de um arquivo
+ * mapeado, incrementa os contadores diretamente, através da instância de addDense
+ * correspondente à largura dos contadores. Um contador que não comporta o incremento é
+ * atualizado pelo objeto Memory, que alarga o bloco, e o restante do intervalo segue pela
+ * nova largura.
+ */
+void Discriminator::addTrainning(const long long *addresses, int memBegin, int memEnd)
+{
+    if(denseBits)
     {
-        addr = 0LL;
-        base = 1LL;
+        for(int i = memBegin; i < memEnd; i++)
+            bits->set(bitSlot, i, addresses[i]);
+        return;
+    }
 
-        for(int j=0; j < numBitsAddr; j++)
+    int i = memBegin;
+    while(i < memEnd)
+    {
+        if(denseCounters && !arena->isMapped())
         {
-            if(retina[memoryAddressMapping[i+j]] != 0)
-                addr += base;
-
-            base *= 2LL;
+            switch(arena->getCounterBytes())
+            {
+                case 1:  i = addDense<uint8_t>(addresses, i, memEnd);  break;
+                case 2:  i = addDense<uint16_t>(addresses, i, memEnd); break;
+                default: i = addDense<uint32_t>(addresses, i, memEnd); break;
+            }
+            if(i == memEnd)
+                break;
         }
-        memIndex = (int) ( i / numBitsAddr);
-        memories[memIndex]->addValue(addr, 1);
+        memories[i].addValue(addresses[i], 1);
+        i++;
+    }
+}
+
+/**
+ * A memória i ocupa a faixa i do bloco. Para no primeiro contador cumulativo que já
+ * está no maior valor representável por CounterType (limitado a INT_MAX).
+ */
+template<typename CounterType>
+int Discriminator::addDense(const long long *addresses, int memBegin, int memEnd)
+{
+    CounterType *counters = (CounterType *) arena->getCounters();
+    long long ramSize = arena->getRamSize();
+    const CounterType maxValue = (CounterType) min((long long) numeric_limits<CounterType>::max(), (long long) INT_MAX);
 
+    for(int i = memBegin; i < memEnd; i++)
+    {
+        CounterType &counter = counters[(long long) i * ramSize + addresses[i]];
+        if(!isCummulative)
+            counter = 1;
+        else if(counter == maxValue)
+            return i;
+        else
+            counter++;
     }
-    //  the rest of the retina (when the retina length is not a multiple of number of bits of address)
-    restOfPositions = retinaLength % numBitsAddr;    
-    if(restOfPositions != 0)
+    return memEnd;
+}
+
+/**
+ * Um contador cumulativo não ultrapassa a quantidade de entradas treinadas; um não cumulativo
+ * não ultrapassa 1. Alarga antecipadamente o bloco de contadores densos, se houver, para
+ * comportar esse limite. Memórias esparsas não precisam de preparação.
+ */
+void Discriminator::reserveTrainings(long long numSamples)
+{
+    numTrainings += numSamples;
+    if(arena)
+        arena->reserveValue(isCummulative ? numTrainings : 1);
+    // beyond INT_MAX trainings a counter may overflow and move its memory out of the arena
+    if(isCummulative && numTrainings > INT_MAX)
+        denseCounters = false;
+}
+
+/**
+ * Soma, memória a memória, o conteúdo de other, e acumula a quantidade de entradas treinadas.
+ * Como as memórias podem ter sido alargadas ou convertidas em esparsas, o membro interno
+ * denseCounters é recalculado ao final.
+ */
+bool Discriminator::merge(const Discriminator &other)
+{
+    if(numMemories != other.numMemories || isCummulative != other.isCummulative)
+        return false;
+    for(int i = 0; i < numMemories; i++)
     {
-        addr = 0LL;
-        base = 1LL;
-        for(int j=0; j< restOfPositions; j++)
-        {
-            if(retina[memoryAddressMapping[retinaLength - restOfPositions - 1 +j]] != 0)
-                addr += base;
+        if(tupleMapping.getMemoryBits(i) != other.tupleMapping.getMemoryBits(i))
+            return false;
+    }
 
-            base *= 2LL;
-        }
-        lastMemoryPosition = memIndex + 1;
-        memories[lastMemoryPosition]->addValue(addr, 1);
+    for(int i = 0; i < numMemories; i++)
+    {
+        if(!memories[i].merge(other.memories[i]))
+            return false;
     }
+    numTrainings += other.numTrainings;
+    updateDenseCounters();
+    return true;
+}
+
+/**
+ * Copia os membros internos e o bloco de contadores inteiro, em vez de somar memória a memória,
+ * e faz cada memória copiada passar a referenciar as cópias dos blocos, preservando a sua
+ * representação (largura dos contadores, memórias esparsas ou em mapas de bits).
+ */
+Discriminator *Discriminator::clone(shared_ptr<BitArena> bits) const
+{
+    Discriminator *d = new Discriminator(*this);
+    if(arena)
+        d->arena = make_shared<RamArena>(*arena);
+    if(this->bits)
+        d->bits = bits;
+
+    for(int i = 0; i < numMemories; i++)
+        d->memories[i].copyStorage(arena.get(), d->arena, d->bits);
+    return d;
 }
 
 /**
  * Cria um vetor de inteiros, result, a ser retornado pelo método.
  * Segmenta a entrada em porções definidas pelo membro interno numBitsAddr.
- * O acesso a retina é chaveado pelo membro interno memoryAddressMapping.
+ * O acesso a retina é chaveado pelo membro interno tupleMapping.
  * Assim, cada grupo de bits, com comprimento numBitsAddr é relacionado com um objeto Memory.
  * Em seguida, obtém o conteúdo do objeto Memory associado, endereçado pelo grupo de bits anterior.
  * Adiciona este conteúdo ao vetor results, para cada memória associada.
  */
 vector<int> Discriminator::predict(const vector<int> &retina)
 {
-    long long addr;
-    int memIndex;
-    int restOfPositions;
-    int lastMemoryPosition;
-    long long base;
+    vector<long long> addresses(numMemories);
     vector<int> result(numMemories);
+    tupleMapping.computeAddresses(retina, addresses.data());
+    predict(addresses.data(), result.data());
+    return result;
+}
 
-    // each group of numBitsAddr is related with a memory
-    for(int i=0; i <= retinaLength-numBitsAddr; i+= numBitsAddr)
+/**
+ * Mesmo comportamento do membro predict para retinas de inteiros, porém os
+ * endereços são extraídos da retina empacotada.
+ */
+vector<int> Discriminator::predict(const BitRetina &retina)
+{
+    vector<long long> addresses(numMemories);
+    vector<int> result(numMemories);
+    tupleMapping.computeAddresses(retina, addresses.data());
+    predict(addresses.data(), result.data());
+    return result;
+}
+
+/**
+ * Obtém o conteúdo de cada objeto Memory no endereço correspondente.
+ * Quando todas as memórias estão no bloco de bits, lê diretamente o bit do slot do discriminador.
+ * Quando todas as memórias estão no bloco de contadores, lê o bloco diretamente,
+ * através da instância de predictDense correspondente à largura dos contadores.
+ */
+void Discriminator::predict(const long long *addresses, int *result) const
+{
+    predict(addresses, result, 0, numMemories);
+}
+
+/**
+ * Mesmo comportamento do membro predict, restrito às memórias do intervalo.
+ */
+void Discriminator::predict(const long long *addresses, int *result, int memBegin, int memEnd) const
+{
+    if(denseBits)
+    {
+        for(int i = memBegin; i < memEnd; i++)
+            result[i] = (ignoreZeroAddr && addresses[i] == 0) ? 0 : (int) bits->get(bitSlot, i, addresses[i]);
+        return;
+    }
+    if(denseCounters)
     {
-        addr = 0LL;
-        base = 1LL;
-        for(int j=0; j<numBitsAddr; j++)
+        switch(arena->getCounterBytes())
         {
-            if(retina[memoryAddressMapping[i+j]] != 0)
-                addr += base;
-
-            base *= 2LL;
+            case 1:  predictDense<uint8_t>(addresses, result, memBegin, memEnd);  return;
+            case 2:  predictDense<uint16_t>(addresses, result, memBegin, memEnd); return;
+            default: predictDense<uint32_t>(addresses, result, memBegin, memEnd); return;
         }
-        memIndex = (int) ( i / numBitsAddr );
-        result.push_back(memories[memIndex]->getValue(addr));
     }
-    //  the rest of the retina (when the retina length is not a multiple of number of bits of address)   
-    restOfPositions = retinaLength % numBitsAddr;
-    addr = 0L;
-    base = 1L;
-    if(restOfPositions != 0)
+    for(int i = memBegin; i < memEnd; i++)
+        result[i] = memories[i].getValue(addresses[i]);
+}
+
+/**
+ * Mesmo comportamento do membro predict, restrito às memórias listadas, lidas uma a uma.
+ */
+void Discriminator::predict(const long long *addresses, int *result, const int *memIndices, int numIndices) const
+{
+    for(int k = 0; k < numIndices; k++)
+        predict(addresses, result, memIndices[k], memIndices[k] + 1);
+}
+
+/**
+ * A memória i ocupa a faixa i do bloco, de forma que o seu contador no endereço addr
+ * está na posição i * ramSize + addr. Com ignoreZeroAddr, o endereço 0 retorna 0.
+ */
+template<typename CounterType>
+void Discriminator::predictDense(const long long *addresses, int *result, int memBegin, int memEnd) const
+{
+    const CounterType *counters = (const CounterType *) arena->getCounters();
+    long long ramSize = arena->getRamSize();
+
+    counters += (long long) memBegin * ramSize;
+    for(int i = memBegin; i < memEnd; i++, counters += ramSize)
+        result[i] = (int) counters[addresses[i]];
+
+    if(ignoreZeroAddr)
     {
-        for(int j=0; j< restOfPositions; j++)
-        {
-            if(retina[memoryAddressMapping[retinaLength - restOfPositions - 1 + j]] != 0)
-                addr += (long) base;
+        for(int i = memBegin; i < memEnd; i++)
+            if(addresses[i] == 0)
+                result[i] = 0;
+    }
+}
 
-            base *= 2;
-        }
-        lastMemoryPosition = memIndex + 1;
-        result.push_back(memories[lastMemoryPosition]->getValue(addr));
+/**
+ * Quando alguma memória é larga demais para o bloco de bits e utiliza um mapa de bits, o slot
+ * do discriminador não contém todas as suas memórias.
+ */
+int Discriminator::getBitSlot(void) const
+{
+    return denseBits ? bitSlot : -1;
+}
+
+/**
+ * O bloco de contadores compartilhado é contabilizado uma única vez, por inteiro, em bytes;
+ * as memórias fora dele (esparsas, com bloco próprio ou com mapa de bits) somam os seus próprios bytes.
+ * O bloco de bits pertence à rede e não é contabilizado.
+ */
+DiscriminatorStats Discriminator::getStats(void) const
+{
+    DiscriminatorStats stats;
+    stats.numTrainings = numTrainings;
+    stats.usedCells = 0;
+    stats.bytes = arena ? (long long) arena->getNumRams() * arena->getRamSize() * arena->getCounterBytes() : 0;
+    stats.histogram.assign(MemoryStats::HISTOGRAM_BUCKETS, 0);
+    stats.memories.reserve(numMemories);
+
+    for(int i = 0; i < numMemories; i++)
+    {
+        stats.memories.push_back(memories[i].getStats());
+        const MemoryStats &memory = stats.memories.back();
+
+        bool inSharedArena = arena && (hash || memories[i].isStoredIn(arena.get()));
+        bool inBitArena = bits && memories[i].isStoredIn(bits.get());
+        if(!inSharedArena && !inBitArena)
+            stats.bytes += memory.bytes;
+        stats.usedCells += memory.usedCells;
+        for(int k = 0; k < MemoryStats::HISTOGRAM_BUCKETS; k++)
+            stats.histogram[k] += memory.histogram[k];
     }
-    return result;
+    return stats;
+}
+
+/**
+ * Formato: quantidade de entradas treinadas, quantidade de memórias, flag indicando se
+ * há bloco de contadores compartilhado (seguida do bloco, caso haja) e o conteúdo de cada memória.
+ */
+void Discriminator::write(ModelWriter &writer) const
+{
+    writer.write((int64_t) numTrainings);
+    writer.write((int32_t) numMemories);
+    writer.write((uint8_t) (arena ? 1 : 0));
+    if(arena)
+        arena->write(writer);
+
+    for(int i = 0; i < numMemories; i++)
+        memories[i].write(writer, arena.get());
 }
 
+/**
+ * Lê o bloco de contadores, caso haja, e cria o discriminador diretamente sobre ele, sem alocar
+ * um bloco vazio para ser descartado. Caso file não seja nulo, o bloco de contadores é lido diretamente do arquivo
+ * mapeado. Retorna nulo caso o arquivo seja inválido ou não corresponda à configuração.
+ */
+Discriminator *Discriminator::read(ModelReader &reader,
+                                   int retinaLength,
+                                   int numBits,
+                                   const vector<int> &memoryAddressMapping,
+                                   bool isCummulative,
+                                   bool ignoreZeroAddr,
+                                   shared_ptr<MappedFile> file,
+                                   shared_ptr<const H3Hash> hash,
+                                   shared_ptr<BitArena> bits)
+{
+    int64_t numTrainings;
+    int32_t numMemories;
+    uint8_t hasArena;
+    shared_ptr<RamArena> arena;
+
+    if(!reader.read(numTrainings) || !reader.read(numMemories) || !reader.read(hasArena))
+        return NULL;
+    if(hasArena && !(arena = RamArena::read(reader, file)))
+        return NULL;
+
+    Discriminator *d = new Discriminator(retinaLength, numBits, memoryAddressMapping, isCummulative, ignoreZeroAddr, hash, bits, arena);
+    // a discriminator whose arena was not the one read does not match the file
+    bool valid = (numMemories == d->numMemories) && ((hasArena != 0) == (bool) d->arena) && (!hasArena || d->arena == arena);
 
+    for(int i = 0; valid && i < d->numMemories; i++)
+        valid = d->memories[i].read(reader, file);
+
+    if(!valid)
+    {
+        delete d;
+        return NULL;
+    }
+    d->numTrainings = numTrainings;
+    d->updateDenseCounters();
+    if(isCummulative && numTrainings > INT_MAX)
+        d->denseCounters = false;
+    return d;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file   Encoder.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe Encoder.
+ */
+
+#include "../include/Encoder.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+using namespace wann;
+
+Encoder::Encoder(void)
+:numFeatures(0)
+{
+}
+
+Encoder Encoder::thermometer(int numFeatures, int levels, float minimum, float maximum)
+{
+	return thermometer(levels, vector<float>(numFeatures, minimum), vector<float>(numFeatures, maximum));
+}
+
+/**
+ * Os levels limiares de cada atributo dividem [minimum, maximum] em levels + 1 faixas iguais,
+ * de forma que minimum não ativa nenhum bit e maximum ativa todos.
+ */
+Encoder Encoder::thermometer(int levels, const vector<float> &minimum, const vector<float> &maximum)
+{
+	if(levels < 1 || minimum.size() != maximum.size())
+	{
+		cout << "WARNING: invalid thermometer encoder" << endl;
+		exit(-1);
+	}
+
+	Encoder encoder;
+	encoder.numFeatures = (int) minimum.size();
+	float infinity = numeric_limits<float>::infinity();
+	for(int f = 0; f < encoder.numFeatures; f++)
+	{
+		float step = (maximum[f] - minimum[f]) / (levels + 1);
+		for(int k = 0; k < levels; k++)
+			encoder.addPosition(f, minimum[f] + (k + 1) * step, infinity);
+	}
+	return encoder;
+}
+
+Encoder Encoder::oneHot(int numFeatures, int numBins, float minimum, float maximum)
+{
+	return oneHot(numBins, vector<float>(numFeatures, minimum), vector<float>(numFeatures, maximum));
+}
+
+/**
+ * A primeira faixa começa em -infinito e a última termina em +infinito, para que todo valor
+ * (exceto NaN) ative exatamente um bit.
+ */
+Encoder Encoder::oneHot(int numBins, const vector<float> &minimum, const vector<float> &maximum)
+{
+	if(numBins < 1 || minimum.size() != maximum.size())
+	{
+		cout << "WARNING: invalid one-hot encoder" << endl;
+		exit(-1);
+	}
+
+	Encoder encoder;
+	encoder.numFeatures = (int) minimum.size();
+	float infinity = numeric_limits<float>::infinity();
+	for(int f = 0; f < encoder.numFeatures; f++)
+	{
+		float step = (maximum[f] - minimum[f]) / numBins;
+		for(int k = 0; k < numBins; k++)
+		{
+			float lower = (k == 0) ? -infinity : minimum[f] + k * step;
+			float upper = (k == numBins - 1) ? infinity : minimum[f] + (k + 1) * step;
+			encoder.addPosition(f, lower, upper);
+		}
+	}
+	return encoder;
+}
+
+Encoder Encoder::threshold(int numFeatures, float threshold)
+{
+	return Encoder::threshold(vector<float>(numFeatures, threshold));
+}
+
+/**
+ * "Maior que o limiar" equivale a [próximo float após o limiar, +infinito).
+ */
+Encoder Encoder::threshold(const vector<float> &thresholds)
+{
+	Encoder encoder;
+	encoder.numFeatures = (int) thresholds.size();
+	float infinity = numeric_limits<float>::infinity();
+	for(int f = 0; f < encoder.numFeatures; f++)
+		encoder.addPosition(f, nextafterf(thresholds[f], infinity), infinity);
+	return encoder;
+}
+
+int Encoder::getRetinaLength(void) const
+{
+	return (int) positionFeatures.size();
+}
+
+int Encoder::getNumFeatures(void) const
+{
+	return numFeatures;
+}
+
+int Encoder::getFeature(int position) const
+{
+	return positionFeatures[position];
+}
+
+float Encoder::getLower(int position) const
+{
+	return lowerBounds[position];
+}
+
+float Encoder::getUpper(int position) const
+{
+	return upperBounds[position];
+}
+
+BitRetina Encoder::encode(const vector<float> &features) const
+{
+	BitRetina retina(getRetinaLength());
+	for(int p = 0; p < getRetinaLength(); p++)
+	{
+		if(get(features.data(), p))
+			retina.set(p, true);
+	}
+	return retina;
+}
+
+void Encoder::addPosition(int feature, float lower, float upper)
+{
+	positionFeatures.push_back(feature);
+	lowerBounds.push_back(lower);
+	upperBounds.push_back(upper);
+}
@@ -0,0 +1,79 @@
+/**
+ * @file   H3Hash.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe H3Hash.
+ */
+
+#include "../include/H3Hash.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Sorteia um valor de 32 bits para cada bit de endereço de cada linha, com mt19937 (sequência
+ * definida pelo padrão, portanto idêntica em qualquer plataforma), e pré-combina os valores
+ * de cada byte: a posição v da tabela do byte k é o ou-exclusivo dos valores dos bits ativos de v.
+ * Gera um warning e encerra a execução caso os parâmetros sejam inválidos.
+ */
+H3Hash::H3Hash(int numHashes, int numCells, int numBits, unsigned seed)
+:numHashes(numHashes), numCells(numCells), numBits(numBits), seed(seed)
+{
+	if(numHashes < 1 || numHashes > MAX_HASHES || numCells < 1 || numBits < 1 || numBits > 64)
+	{
+		cout << "WARNING: invalid hashed memory configuration" << endl;
+		exit(-1);
+	}
+
+	numBytes = (numBits + 7) / 8;
+	tables.assign((size_t) numHashes * numBytes * 256, 0);
+
+	mt19937 generator(seed);
+	for(int r = 0; r < numHashes; r++)
+	{
+		for(int k = 0; k < numBytes; k++)
+		{
+			uint32_t q[8];
+			for(int i = 0; i < 8; i++)
+				q[i] = (k * 8 + i < numBits) ? (uint32_t) generator() : 0;
+
+			uint32_t *table = tables.data() + ((size_t) r * numBytes + k) * 256;
+			for(int v = 1; v < 256; v++)
+			{
+				int lowBit = 0;
+				while(((v >> lowBit) & 1) == 0)
+					lowBit++;
+				table[v] = table[v & (v - 1)] ^ q[lowBit];
+			}
+		}
+	}
+}
+
+int H3Hash::getNumHashes(void) const
+{
+	return numHashes;
+}
+
+int H3Hash::getNumCells(void) const
+{
+	return numCells;
+}
+
+int H3Hash::getNumBits(void) const
+{
+	return numBits;
+}
+
+unsigned H3Hash::getSeed(void) const
+{
+	return seed;
+}
+
+long long H3Hash::getTableSize(void) const
+{
+	return (long long) numHashes * numCells;
+}
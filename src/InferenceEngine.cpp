@@ -0,0 +1,214 @@
+/**
+ * @file   InferenceEngine.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe InferenceEngine.
+ */
+
+#include "../include/InferenceEngine.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Cria as estruturas de latência de cada thread antes de iniciá-las.
+ */
+InferenceEngine::InferenceEngine(WiSARD &wisard,
+								 int numWorkers,
+								 int maxBatchSize,
+								 double maxDelay,
+								 int queueCapacity)
+:wisard(wisard),
+ maxBatchSize(max(1, maxBatchSize)),
+ maxDelay(chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(max(0.0, maxDelay)))),
+ queue((size_t) max(1, queueCapacity)),
+ numQueued(0),
+ numSleeping(0),
+ stopping(false)
+{
+	if(numWorkers < 1)
+		numWorkers = max(1, (int) thread::hardware_concurrency());
+
+	for(int i = 0; i < numWorkers; i++)
+	{
+		stats.push_back(unique_ptr<WorkerStats>(new WorkerStats()));
+		stats.back()->numRequests = 0;
+		stats.back()->numBatches = 0;
+	}
+	for(int i = 0; i < numWorkers; i++)
+		workers.push_back(thread(&InferenceEngine::workerLoop, this, i));
+}
+
+/**
+ * As threads só encerram quando a fila está vazia, de forma que todas as requisições submetidas
+ * antes do destrutor recebem a sua label.
+ */
+InferenceEngine::~InferenceEngine(void)
+{
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		stopping.store(true);
+	}
+	requestAvailable.notify_all();
+
+	for(size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+/**
+ * Insere a requisição na fila, aguardando enquanto ela está cheia, e acorda uma thread ociosa, caso haja.
+ * A contagem de requisições é incrementada antes da leitura da quantidade de threads ociosas, e cada
+ * thread se registra como ociosa antes de verificar a contagem, de forma que a requisição não passa
+ * despercebida por todas as threads.
+ */
+future<string> InferenceEngine::submit(const vector<int> &retina)
+{
+	if(stopping.load())
+	{
+		cout << "WARNING: request submitted to a stopped inference engine" << endl;
+		exit(-1);
+	}
+
+	Request *request = new Request();
+	request->retina = retina;
+	future<string> result = request->result.get_future();
+	request->submitted = chrono::steady_clock::now();
+
+	while(!queue.push(request))
+		this_thread::yield();
+
+	numQueued.fetch_add(1);
+	if(numSleeping.load() > 0)
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		requestAvailable.notify_one();
+	}
+	return result;
+}
+
+/**
+ * Aguarda a primeira requisição de um lote e, a partir dela, continua retirando requisições da
+ * fila até que o lote esteja cheio ou que a primeira requisição tenha aguardado maxDelay.
+ */
+void InferenceEngine::workerLoop(int worker)
+{
+	vector<Request *> batch;
+	batch.reserve(maxBatchSize);
+
+	while(true)
+	{
+		Request *request;
+		if(!queue.pop(request))
+		{
+			if(stopping.load())
+				return;
+
+			unique_lock<mutex> lock(sleepMutex);
+			numSleeping.fetch_add(1);
+			requestAvailable.wait_for(lock, chrono::milliseconds(10),
+									  [this]() { return stopping.load() || numQueued.load() > 0; });
+			numSleeping.fetch_sub(1);
+			continue;
+		}
+		numQueued.fetch_sub(1);
+		batch.push_back(request);
+
+		chrono::steady_clock::time_point deadline = request->submitted + maxDelay;
+		while((int) batch.size() < maxBatchSize)
+		{
+			if(queue.pop(request))
+			{
+				numQueued.fetch_sub(1);
+				batch.push_back(request);
+			}
+			else if(stopping.load() || chrono::steady_clock::now() >= deadline)
+				break;
+			else
+				this_thread::yield();
+		}
+
+		runBatch(batch, worker);
+	}
+}
+
+/**
+ * Classifica o lote em uma única chamada a WiSARD::predict. Caso ela lance uma exceção (por
+ * exemplo, std::bad_alloc), a exceção é repassada à future de todas as requisições do lote,
+ * que são contabilizadas normalmente, e a thread continua atendendo os lotes seguintes.
+ */
+void InferenceEngine::runBatch(vector<Request *> &batch, int worker)
+{
+	vector< vector<int> > X(batch.size());
+	for(size_t i = 0; i < batch.size(); i++)
+		X[i].swap(batch[i]->retina);
+
+	vector<string> labels;
+	exception_ptr error;
+	try
+	{
+		labels = wisard.predict(X);
+	}
+	catch(...)
+	{
+		error = current_exception();
+	}
+
+	WorkerStats &workerStats = *stats[worker];
+	lock_guard<mutex> lock(workerStats.mutex);
+	for(size_t i = 0; i < batch.size(); i++)
+	{
+		if(error)
+			batch[i]->result.set_exception(error);
+		else
+			batch[i]->result.set_value(labels[i]);
+		double latency = chrono::duration<double>(chrono::steady_clock::now() - batch[i]->submitted).count();
+
+		if((int) workerStats.latencies.size() < LATENCY_WINDOW)
+			workerStats.latencies.push_back(latency);
+		else
+			workerStats.latencies[workerStats.numRequests % LATENCY_WINDOW] = latency;
+		workerStats.numRequests++;
+		delete batch[i];
+	}
+	workerStats.numBatches++;
+	batch.clear();
+}
+
+/**
+ * Reúne as latências mantidas por cada thread e obtém os percentis por seleção (nth_element).
+ */
+LatencyStats InferenceEngine::getLatencyStats(void) const
+{
+	LatencyStats result;
+	result.numRequests = 0;
+	result.numBatches = 0;
+
+	vector<double> latencies;
+	for(size_t w = 0; w < stats.size(); w++)
+	{
+		lock_guard<mutex> lock(stats[w]->mutex);
+		latencies.insert(latencies.end(), stats[w]->latencies.begin(), stats[w]->latencies.end());
+		result.numRequests += stats[w]->numRequests;
+		result.numBatches += stats[w]->numBatches;
+	}
+
+	result.meanBatchSize = (result.numBatches > 0) ? (double) result.numRequests / (double) result.numBatches : 0.0;
+	result.p50Seconds = 0.0;
+	result.p99Seconds = 0.0;
+	result.maxSeconds = 0.0;
+	if(latencies.empty())
+		return result;
+
+	size_t p50 = latencies.size() / 2;
+	size_t p99 = min(latencies.size() - 1, (size_t) (latencies.size() * 0.99));
+	nth_element(latencies.begin(), latencies.begin() + p50, latencies.end());
+	result.p50Seconds = latencies[p50];
+	nth_element(latencies.begin(), latencies.begin() + p99, latencies.end());
+	result.p99Seconds = latencies[p99];
+	result.maxSeconds = *max_element(latencies.begin(), latencies.end());
+	return result;
+}
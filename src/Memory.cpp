@@ -9,6 +9,10 @@
 #include <math.h>
 #include <iostream>
 #include <unordered_map>
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+#include <climits>
 
 using namespace std;
 using namespace wann;
@@ -16,20 +20,97 @@ using namespace wann;
 /**
  * Gera um warning caso o número de bits para endereçamento da memória seja superior a 62. (Possibilidade de overflow).
  * Seta o atributo interno numAddrs com o valor de 2 elevado a entrada numBits.
+ * Se numBits não ultrapassa DENSE_MAX_BITS, cria um bloco RamArena próprio, com uma
+ * única memória de 2^numBits contadores. Caso contrário, a memória é mantida esparsa.
  */
 Memory::Memory(int numBits, 
 			   bool isCummulative=true, 
 			   bool ignoreZeroAddr=false)
-:numBits(numBits),isCummulative(isCummulative),ignoreZeroAddr(ignoreZeroAddr)
+:ramIndex(0),slot(0),numBits(numBits),isCummulative(isCummulative),ignoreZeroAddr(ignoreZeroAddr)
 {
 	if(numBits > 62)
 		cout << "WARNING: Representation overflow due to number of bits" << endl;
 
 	numAddrs = (long long)pow((long long)2, (long long)numBits);
-	
+
+	if(numBits <= DENSE_MAX_BITS)
+		arena = make_shared<RamArena>(1, numAddrs);
+}
+
+/**
+ * Utiliza a faixa ramIndex do bloco arena para armazenar os contadores da memória.
+ * Gera um warning e encerra a execução caso a faixa não comporte 2^numBits endereços.
+ */
+Memory::Memory(int numBits,
+			   bool isCummulative,
+			   bool ignoreZeroAddr,
+			   shared_ptr<RamArena> arena,
+			   int ramIndex)
+:arena(arena),ramIndex(ramIndex),slot(0),numBits(numBits),isCummulative(isCummulative),ignoreZeroAddr(ignoreZeroAddr)
+{
+	numAddrs = (long long)pow((long long)2, (long long)numBits);
+
+	if(ramIndex < 0 || ramIndex >= arena->getNumRams() || numAddrs > arena->getRamSize())
+	{
+		cout << "WARNING: memory does not fit in the arena" << endl;
+		exit(-1);
+	}
 }
 /**
- * Deleta o contéudo armazenado pelo membro interno data.
+ * Utiliza a faixa ramIndex do bloco arena como tabela de hash->getTableSize() contadores.
+ * Gera um warning e encerra a execução caso a faixa não comporte a tabela.
+ */
+Memory::Memory(int numBits,
+			   bool isCummulative,
+			   bool ignoreZeroAddr,
+			   shared_ptr<RamArena> arena,
+			   int ramIndex,
+			   shared_ptr<const H3Hash> hash)
+:arena(arena),hash(hash),ramIndex(ramIndex),slot(0),numBits(numBits),isCummulative(isCummulative),ignoreZeroAddr(ignoreZeroAddr)
+{
+	numAddrs = (numBits >= 63) ? LLONG_MAX : (1LL << numBits);
+
+	if(ramIndex < 0 || ramIndex >= arena->getNumRams() || hash->getTableSize() > arena->getRamSize())
+	{
+		cout << "WARNING: memory does not fit in the arena" << endl;
+		exit(-1);
+	}
+}
+
+/**
+ * Utiliza o slot do bloco bits na memória ramIndex. A memória é sempre não cumulativa.
+ * Gera um warning e encerra a execução caso o bloco não comporte 2^numBits endereços.
+ */
+Memory::Memory(int numBits,
+			   bool ignoreZeroAddr,
+			   shared_ptr<BitArena> bits,
+			   int ramIndex,
+			   int slot)
+:bits(bits),ramIndex(ramIndex),slot(slot),numBits(numBits),isCummulative(false),ignoreZeroAddr(ignoreZeroAddr)
+{
+	numAddrs = (long long)pow((long long)2, (long long)numBits);
+
+	if(ramIndex < 0 || ramIndex >= bits->getNumRams() || numAddrs > bits->getRamSize()
+	   || slot < 0 || slot >= bits->getNumSlots())
+	{
+		cout << "WARNING: memory does not fit in the bit arena" << endl;
+		exit(-1);
+	}
+}
+
+/**
+ * Memória não cumulativa de qualquer largura, cujos endereços ativados ficam no mapa de bits.
+ */
+Memory::Memory(int numBits,
+			   bool ignoreZeroAddr,
+			   shared_ptr<CompressedBitmap> bitmap)
+:bitmap(bitmap),ramIndex(0),slot(0),numBits(numBits),isCummulative(false),ignoreZeroAddr(ignoreZeroAddr)
+{
+	numAddrs = (numBits >= 63) ? LLONG_MAX : (1LL << numBits);
+}
+
+/**
+ * Deleta o contéudo armazenado pelos membros internos de dados.
  */
 Memory::~Memory(void)
 {
@@ -41,9 +122,8 @@ Memory::~Memory(void)
  * membro interno numAddrs, gera um warning e encerra a execução.
  * Caso o membro interno isCummulative seja falso, apenas seta o conteúdo
  * associado àquele endereço com 1.
- * Caso não seja, verifica se já há algum conteúdo associado ao endereço.
- * Se não houver, o cria com o valor do parâmetro value. Se houver, incrementa
- * o conteúdo com value.
+ * Caso não seja, incrementa o conteúdo associado ao endereço com value
+ * (endereços ainda não utilizados possuem conteúdo zero).
  */
 void Memory::addValue(const long long addr, int value = 1)
 {	
@@ -53,20 +133,38 @@ void Memory::addValue(const long long addr, int value = 1)
 		cout << "WARNING: number of address: " << numAddrs << endl;
 		exit(-1);
 	}
+	if(hash)
+	{
+		addHashedValue(addr, value);
+		return;
+	}
+	if(bits)
+	{
+		bits->set(slot, ramIndex, addr);
+		return;
+	}
+	if(bitmap)
+	{
+		bitmap->insert(addr);
+		return;
+	}
+	if(arena)
+	{
+		long long newValue = isCummulative ? arena->getValue(ramIndex, addr) + value : 1;
+		if(arena->setValue(ramIndex, addr, newValue))
+			return;
+
+		convertToSparse();
+		data[addr] = (int) newValue;
+		return;
+	}
 	if(!isCummulative)
 	{
 		data[addr] = 1;
 	}
 	else
 	{
-		if(!data.count(addr))
-		{
-			data[addr] = value;
-		}
-		else
-		{
-			data[addr] += value;
-		}
+		data[addr] += value;
 	}	
 }
 
@@ -78,7 +176,7 @@ void Memory::addValue(const long long addr, int value = 1)
  * Verifica se o conteúdo associado ao endereço já foi inicializado,
  * caso sim, retorna o conteúdo, caso não, retorna zero.
  */
-int Memory::getValue(const long long addr)
+int Memory::getValue(const long long addr) const
 {
 	if(addr < 0 || addr >= numAddrs)
 	{
@@ -88,8 +186,329 @@ int Memory::getValue(const long long addr)
 	}
 	if(ignoreZeroAddr && addr == 0)
 		return 0;
-	if(!data.count(addr))
+	if(hash)
+	{
+		long long cells[H3Hash::MAX_HASHES];
+		hash->computeCells(addr, cells);
+
+		long long value = arena->getValue(ramIndex, cells[0]);
+		for(int r = 1; r < hash->getNumHashes(); r++)
+			value = min(value, arena->getValue(ramIndex, cells[r]));
+		return (int) value;
+	}
+	if(bits)
+		return bits->get(slot, ramIndex, addr) ? 1 : 0;
+	if(bitmap)
+		return bitmap->contains(addr) ? 1 : 0;
+	if(arena)
+		return (int) arena->getValue(ramIndex, addr);
+
+	unordered_map<long long, int>::const_iterator it = data.find(addr);
+	if(it == data.end())
 		return 0;
 
-	return data[addr];
+	return it->second;
+}
+
+/**
+ * Atualização conservadora do count-min sketch: o novo conteúdo é o menor contador entre as linhas
+ * somado a value (ou 1, caso a memória não seja cumulativa), e apenas os contadores menores que ele
+ * são elevados. O conteúdo lido continua sendo um limite superior do conteúdo exato, com erro menor
+ * que o da atualização de todas as linhas.
+ * Com ignoreZeroAddr, o endereço 0 nunca é lido e não é inserido, pois apenas elevaria os contadores
+ * das células compartilhadas com ele.
+ * Gera um warning e encerra a execução caso o novo conteúdo não seja representável.
+ */
+void Memory::addHashedValue(const long long addr, int value)
+{
+	if(ignoreZeroAddr && addr == 0)
+		return;
+
+	long long cells[H3Hash::MAX_HASHES];
+	hash->computeCells(addr, cells);
+	int numHashes = hash->getNumHashes();
+
+	long long current = arena->getValue(ramIndex, cells[0]);
+	for(int r = 1; r < numHashes; r++)
+		current = min(current, arena->getValue(ramIndex, cells[r]));
+
+	long long newValue = isCummulative ? current + value : 1;
+	for(int r = 0; r < numHashes; r++)
+	{
+		if(arena->getValue(ramIndex, cells[r]) < newValue && !arena->setValue(ramIndex, cells[r], newValue))
+		{
+			cout << "WARNING: hashed memory counter overflow" << endl;
+			exit(-1);
+		}
+	}
+}
+
+/**
+ * Insere no membro interno data todos os endereços com conteúdo não nulo,
+ * zera a faixa da memória no bloco arena e deixa de referenciá-lo.
+ * Utilizado quando um valor não é representável pelos contadores densos.
+ */
+void Memory::convertToSparse(void)
+{
+	for(long long addr = 0; addr < numAddrs; addr++)
+	{
+		long long value = arena->getValue(ramIndex, addr);
+		if(value != 0)
+			data[addr] = (int) value;
+	}
+	arena->clearRam(ramIndex);
+	arena.reset();
+}
+
+/**
+ * As tabelas de hash de mesma família são combinadas célula a célula: somadas, o que mantém cada
+ * contador lido como limite superior da soma dos conteúdos exatos, ou pelo maior valor, caso a
+ * memória não seja cumulativa. As demais representações são percorridas endereço a endereço, e
+ * cada conteúdo é somado através de addValue, que alarga ou converte a memória quando necessário.
+ */
+bool Memory::merge(const Memory &other)
+{
+	if(numBits != other.numBits || (bool) hash != (bool) other.hash)
+		return false;
+
+	if(hash)
+	{
+		long long numCells = hash->getTableSize();
+		if(hash->getNumHashes() != other.hash->getNumHashes() || numCells != other.hash->getTableSize()
+		   || hash->getSeed() != other.hash->getSeed())
+			return false;
+
+		for(long long cell = 0; cell < numCells; cell++)
+		{
+			long long value = other.arena->getValue(other.ramIndex, cell);
+			if(value == 0)
+				continue;
+
+			long long current = arena->getValue(ramIndex, cell);
+			long long newValue = isCummulative ? current + value : max(current, value);
+			if(!arena->setValue(ramIndex, cell, newValue))
+			{
+				cout << "WARNING: hashed memory counter overflow" << endl;
+				exit(-1);
+			}
+		}
+		return true;
+	}
+
+	other.forEachValue([this](long long addr, int value) { addValue(addr, value); });
+	return true;
+}
+
+/**
+ * Percorre os bits do slot, os endereços do mapa de bits, os contadores da faixa do bloco
+ * ou os endereços do membro interno data, conforme a representação da memória.
+ */
+template<typename Function>
+void Memory::forEachValue(Function function) const
+{
+	if(bits)
+	{
+		for(long long addr = 0; addr < numAddrs; addr++)
+		{
+			if(bits->get(slot, ramIndex, addr))
+				function(addr, 1);
+		}
+	}
+	else if(bitmap)
+	{
+		bitmap->forEach([&function](long long addr) { function(addr, 1); });
+	}
+	else if(arena)
+	{
+		for(long long addr = 0; addr < numAddrs; addr++)
+		{
+			long long value = arena->getValue(ramIndex, addr);
+			if(value != 0)
+				function(addr, (int) value);
+		}
+	}
+	else
+	{
+		for(unordered_map<long long, int>::const_iterator it = data.begin(); it != data.end(); ++it)
+		{
+			if(it->second != 0)
+				function(it->first, it->second);
+		}
+	}
+}
+
+/**
+ * Os membros internos data e ramIndex já são copiados junto com a memória. Um bloco de contadores
+ * próprio da memória (lido de um arquivo, por exemplo) e o mapa de bits comprimido são copiados
+ * integralmente.
+ */
+void Memory::copyStorage(const RamArena *sharedArena, shared_ptr<RamArena> arenaCopy, shared_ptr<BitArena> bitsCopy)
+{
+	if(arena && arena.get() == sharedArena)
+		arena = arenaCopy;
+	else if(arena)
+		arena = make_shared<RamArena>(*arena);
+	if(bits)
+		bits = bitsCopy;
+	if(bitmap)
+		bitmap = make_shared<CompressedBitmap>(*bitmap);
+}
+
+/**
+ * Memórias com hash também ficam no bloco, mas o seu conteúdo não é o contador do endereço.
+ */
+bool Memory::isStoredIn(const RamArena *arena) const
+{
+	return !hash && this->arena.get() == arena;
+}
+
+bool Memory::isStoredIn(const BitArena *bits) const
+{
+	return this->bits.get() == bits;
+}
+
+/**
+ * Percorre os contadores da faixa da memória no bloco arena, ou os endereços do membro interno data.
+ * Os bytes de uma memória esparsa são estimados a partir dos baldes e dos nós do unordered_map.
+ */
+MemoryStats Memory::getStats(void) const
+{
+	MemoryStats stats;
+	stats.numBits = numBits;
+	stats.capacity = numAddrs;
+
+	if(bits)
+	{
+		stats.kind = BITSET_MEMORY;
+		stats.bytes = numAddrs / 8;
+		for(long long addr = 0; addr < numAddrs; addr++)
+			stats.addValue(bits->get(slot, ramIndex, addr) ? 1 : 0);
+	}
+	else if(bitmap)
+	{
+		stats.kind = BITMAP_MEMORY;
+		stats.bytes = bitmap->getBytes();
+		stats.addValue(1, bitmap->size());
+	}
+	else if(arena)
+	{
+		long long numCells = hash ? hash->getTableSize() : numAddrs;
+		stats.kind = hash ? HASHED_MEMORY : DENSE_MEMORY;
+		stats.capacity = numCells;
+		stats.bytes = numCells * arena->getCounterBytes();
+		for(long long cell = 0; cell < numCells; cell++)
+			stats.addValue(arena->getValue(ramIndex, cell));
+		if(hash)
+			stats.loadFactor = (double) stats.usedCells / (double) numCells;
+	}
+	else
+	{
+		stats.kind = SPARSE_MEMORY;
+		stats.loadFactor = data.load_factor();
+		stats.bytes = (long long) (data.bucket_count() * sizeof(void *)
+								   + data.size() * (sizeof(void *) + sizeof(pair<const long long, int>)));
+		for(unordered_map<long long, int>::const_iterator it = data.begin(); it != data.end(); ++it)
+			stats.addValue(it->second);
+	}
+
+	stats.occupancy = (stats.capacity > 0) ? (double) stats.usedCells / (double) stats.capacity : 0.0;
+	return stats;
+}
+
+/**
+ * Escreve o tipo de representação da memória: 0 para esparsa, 1 para densa em um bloco
+ * compartilhado, 2 para densa em um bloco próprio, 3 para tabela de hash em um bloco compartilhado,
+ * 4 para um bit por endereço no bloco de bits da rede e 5 para mapa de bits comprimido. Memórias esparsas são escritas como
+ * a quantidade de endereços seguida dos pares (endereço, conteúdo), em ordem crescente de
+ * endereço; memórias com bloco próprio escrevem o bloco, e memórias com mapa de bits escrevem o mapa.
+ * O bloco de bits é escrito uma única vez, pela rede.
+ */
+void Memory::write(ModelWriter &writer, const RamArena *sharedArena) const
+{
+	if(bits)
+	{
+		writer.write((uint8_t) 4);
+	}
+	else if(bitmap)
+	{
+		writer.write((uint8_t) 5);
+		bitmap->write(writer);
+	}
+	else if(!arena)
+	{
+		vector<pair<long long, int>> entries(data.begin(), data.end());
+		sort(entries.begin(), entries.end());
+
+		writer.write((uint8_t) 0);
+		writer.write((int64_t) entries.size());
+		for(size_t i = 0; i < entries.size(); i++)
+		{
+			writer.write((int64_t) entries[i].first);
+			writer.write((int32_t) entries[i].second);
+		}
+	}
+	else if(hash)
+	{
+		writer.write((uint8_t) 3);
+	}
+	else if(arena.get() == sharedArena)
+	{
+		writer.write((uint8_t) 1);
+	}
+	else
+	{
+		writer.write((uint8_t) 2);
+		arena->write(writer);
+	}
+}
+
+/**
+ * Memórias densas ou com hash em bloco compartilhado, e memórias com um bit por endereço, mantêm
+ * a representação recebida na construção. Memórias esparsas deixam de referenciar qualquer bloco.
+ */
+bool Memory::read(ModelReader &reader, shared_ptr<MappedFile> file)
+{
+	uint8_t kind;
+	if(!reader.read(kind))
+		return false;
+
+	if(hash)
+		return kind == 3;
+	if(bits)
+		return kind == 4;
+	if(bitmap)
+		return kind == 5 && bitmap->read(reader, numAddrs - 1);
+
+	if(kind == 0)
+	{
+		int64_t numEntries;
+		if(!reader.read(numEntries) || numEntries < 0)
+			return false;
+
+		arena.reset();
+		data.clear();
+		data.reserve((size_t) numEntries);
+		for(int64_t i = 0; i < numEntries; i++)
+		{
+			int64_t addr;
+			int32_t value;
+			if(!reader.read(addr) || !reader.read(value) || addr < 0 || addr >= numAddrs)
+				return false;
+			data[addr] = value;
+		}
+		return true;
+	}
+	if(kind == 1)
+		return (bool) arena;
+	if(kind == 2)
+	{
+		shared_ptr<RamArena> ownArena = RamArena::read(reader, file);
+		if(!ownArena || ownArena->getNumRams() != 1 || ownArena->getRamSize() < numAddrs)
+			return false;
+		arena = ownArena;
+		ramIndex = 0;
+		data.clear();
+		return true;
+	}
+	return false;
 }
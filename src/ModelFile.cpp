@@ -0,0 +1,173 @@
+/**
+ * @file   ModelFile.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação das classes MappedFile, ModelWriter e ModelReader.
+ */
+
+#include "../include/ModelFile.hpp"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdint.h>
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Abre o arquivo e o mapeia inteiro, somente para leitura. Em caso de falha,
+ * o objeto fica fechado (isOpen retorna falso).
+ */
+MappedFile::MappedFile(const string &path)
+:content(NULL), length(0)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		return;
+
+	struct stat info;
+	if(fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		void *mapped = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if(mapped != MAP_FAILED)
+		{
+			content = (const char *) mapped;
+			length = (size_t) info.st_size;
+		}
+	}
+	close(fd);
+}
+
+/**
+ * Desfaz o mapeamento, caso exista.
+ */
+MappedFile::~MappedFile(void)
+{
+	if(content != NULL)
+		munmap((void *) content, length);
+}
+
+bool MappedFile::isOpen(void) const
+{
+	return content != NULL;
+}
+
+const char *MappedFile::data(void) const
+{
+	return content;
+}
+
+size_t MappedFile::size(void) const
+{
+	return length;
+}
+
+
+ModelWriter::ModelWriter(const string &path)
+:path(path),
+ tmpPath(path + ".tmp"),
+ output(tmpPath.c_str(), ios::out | ios::binary | ios::trunc),
+ position(0),
+ committed(false)
+{
+}
+
+ModelWriter::~ModelWriter(void)
+{
+	if(!committed)
+	{
+		output.close();
+		unlink(tmpPath.c_str());
+	}
+}
+
+void ModelWriter::writeBytes(const void *bytes, size_t numBytes)
+{
+	output.write((const char *) bytes, numBytes);
+	position += numBytes;
+}
+
+/**
+ * O comprimento é escrito como um inteiro de 32 bits sem sinal.
+ */
+void ModelWriter::writeString(const string &value)
+{
+	write((uint32_t) value.size());
+	writeBytes(value.data(), value.size());
+}
+
+void ModelWriter::align(size_t alignment)
+{
+	static const char zeros[64] = {0};
+	while(position % alignment != 0)
+		writeBytes(zeros, min(alignment - position % alignment, sizeof(zeros)));
+}
+
+bool ModelWriter::good(void) const
+{
+	return output.good();
+}
+
+/**
+ * rename substitui o destino atomicamente: quem já mapeou o arquivo anterior continua lendo o
+ * seu conteúdo, que só é liberado quando o último mapeamento é desfeito.
+ */
+bool ModelWriter::commit(void)
+{
+	output.close();
+	if(output.fail() || rename(tmpPath.c_str(), path.c_str()) != 0)
+	{
+		unlink(tmpPath.c_str());
+		committed = true;
+		return false;
+	}
+	committed = true;
+	return true;
+}
+
+
+ModelReader::ModelReader(const char *data, size_t size)
+:data(data), size(size), position(0), failed(false)
+{
+}
+
+/**
+ * Falha, sem avançar, caso não restem numBytes bytes no bloco.
+ */
+const char *ModelReader::readBytes(size_t numBytes)
+{
+	if(failed || numBytes > size - position)
+	{
+		failed = true;
+		return NULL;
+	}
+	const char *bytes = data + position;
+	position += numBytes;
+	return bytes;
+}
+
+bool ModelReader::readString(string &value)
+{
+	uint32_t stringLength;
+	if(!read(stringLength))
+		return false;
+	const char *bytes = readBytes(stringLength);
+	if(bytes == NULL)
+		return false;
+	value.assign(bytes, stringLength);
+	return true;
+}
+
+void ModelReader::align(size_t alignment)
+{
+	size_t padding = (alignment - position % alignment) % alignment;
+	readBytes(padding);
+}
+
+bool ModelReader::good(void) const
+{
+	return !failed;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file   ModelHandle.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe ModelHandle.
+ */
+
+#include "../include/ModelHandle.hpp"
+
+#include <thread>
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Versão publicada da rede.
+ */
+struct ModelHandle::Version
+{
+	/** Rede da versão, imutável após a publicação.*/
+	WiSARD *model;
+	/** Número da versão.*/
+	long long number;
+};
+
+ModelHandle::Snapshot::Snapshot(const ModelHandle *handle, int slot, Version *version)
+:handle(handle), slot(slot), version(version)
+{
+}
+
+ModelHandle::Snapshot::Snapshot(Snapshot &&other)
+:handle(other.handle), slot(other.slot), version(other.version)
+{
+	other.slot = -1;
+	other.version = NULL;
+}
+
+/**
+ * Um objeto cuja versão foi transferida não possui posição a ser liberada.
+ */
+ModelHandle::Snapshot::~Snapshot(void)
+{
+	if(slot >= 0)
+		handle->release(slot);
+}
+
+WiSARD *ModelHandle::Snapshot::operator->(void) const
+{
+	return version->model;
+}
+
+WiSARD &ModelHandle::Snapshot::operator*(void) const
+{
+	return *version->model;
+}
+
+long long ModelHandle::Snapshot::getVersion(void) const
+{
+	return version->number;
+}
+
+/**
+ * Todas as posições de leitor começam livres, e o ThreadPool da rede inicial passa ao escritor.
+ */
+ModelHandle::ModelHandle(WiSARD *model)
+:currentNumber(0), threadPool(model->getThreadPool())
+{
+	model->setThreadPool(shared_ptr<ThreadPool>());
+
+	Version *version = new Version();
+	version->model = model;
+	version->number = 0;
+	current.store(version);
+
+	for(int s = 0; s < MAX_READERS; s++)
+	{
+		hazards[s].store(NULL);
+		slotsInUse[s].store(false);
+	}
+}
+
+ModelHandle::~ModelHandle(void)
+{
+	retired.push_back(current.load());
+	for(size_t i = 0; i < retired.size(); i++)
+	{
+		delete retired[i]->model;
+		delete retired[i];
+	}
+}
+
+/**
+ * Ocupa uma posição livre através de compare-and-swap e anuncia nela a versão corrente. Como a
+ * versão pode ter sido substituída e deletada entre a leitura e o anúncio, o anúncio é repetido
+ * até que a versão corrente seja a anunciada; a partir daí, o escritor a encontra em reclaim.
+ */
+ModelHandle::Snapshot ModelHandle::acquire(void) const
+{
+	int slot = -1;
+	while(slot < 0)
+	{
+		for(int s = 0; slot < 0 && s < MAX_READERS; s++)
+		{
+			bool expected = false;
+			if(!slotsInUse[s].load(memory_order_relaxed)
+			   && slotsInUse[s].compare_exchange_strong(expected, true, memory_order_acquire))
+				slot = s;
+		}
+		if(slot < 0)
+			this_thread::yield();
+	}
+
+	Version *version = current.load();
+	while(true)
+	{
+		hazards[slot].store(version);
+		Version *latest = current.load();
+		if(latest == version)
+			break;
+		version = latest;
+	}
+	return Snapshot(this, slot, version);
+}
+
+void ModelHandle::release(int slot) const
+{
+	hazards[slot].store(NULL, memory_order_release);
+	slotsInUse[slot].store(false, memory_order_release);
+}
+
+long long ModelHandle::getVersion(void) const
+{
+	return currentNumber.load();
+}
+
+/**
+ * A cópia é feita por WiSARD::clone, que apenas lê a versão corrente, e treinada fora do alcance dos leitores,
+ * com o ThreadPool do escritor.
+ */
+long long ModelHandle::update(const function<void(WiSARD &)> &train)
+{
+	lock_guard<mutex> lock(writerMutex);
+	WiSARD *model = current.load()->model->clone();
+	model->setThreadPool(threadPool);
+	train(*model);
+	return publishLocked(model);
+}
+
+long long ModelHandle::partialFit(const vector< vector<int> > &X, const vector<string> &y)
+{
+	return update([&](WiSARD &model) { model.partialFit(X, y); });
+}
+
+long long ModelHandle::publish(WiSARD *model)
+{
+	lock_guard<mutex> lock(writerMutex);
+	return publishLocked(model);
+}
+
+/**
+ * Troca a versão corrente atomicamente; a versão substituída é deletada por reclaimLocked
+ * assim que nenhum leitor a anunciar. A rede publicada deixa de utilizar ThreadPool.
+ */
+long long ModelHandle::publishLocked(WiSARD *model)
+{
+	model->setThreadPool(shared_ptr<ThreadPool>());
+
+	Version *version = new Version();
+	version->model = model;
+	version->number = currentNumber.load() + 1;
+
+	retired.push_back(current.exchange(version));
+	currentNumber.store(version->number);
+	reclaimLocked();
+	return version->number;
+}
+
+int ModelHandle::reclaim(void)
+{
+	lock_guard<mutex> lock(writerMutex);
+	return reclaimLocked();
+}
+
+/**
+ * Uma versão substituída não volta a ser a corrente, de forma que um leitor que ainda não a
+ * anunciou não conseguirá anunciá-la com sucesso: basta que nenhuma posição a anuncie agora.
+ */
+int ModelHandle::reclaimLocked(void)
+{
+	size_t numKept = 0;
+	for(size_t i = 0; i < retired.size(); i++)
+	{
+		bool inUse = false;
+		for(int s = 0; !inUse && s < MAX_READERS; s++)
+			inUse = (hazards[s].load() == retired[i]);
+
+		if(inUse)
+			retired[numKept++] = retired[i];
+		else
+		{
+			delete retired[i]->model;
+			delete retired[i];
+		}
+	}
+	retired.resize(numKept);
+	return (int) numKept;
+}
@@ -0,0 +1,243 @@
+/**
+ * @file   RamArena.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe RamArena.
+ */
+
+#include "../include/RamArena.hpp"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Aloca, com uma única chamada a calloc, numRams * ramSize contadores de 8 bits.
+ * Caso a alocação falhe, gera um warning e encerra a execução.
+ */
+RamArena::RamArena(int numRams, long long ramSize)
+:counters(NULL), counterBytes(1), numRams(numRams), ramSize(ramSize)
+{
+	counters = calloc((size_t) numRams * (size_t) ramSize, 1);
+	if(counters == NULL && numRams > 0 && ramSize > 0)
+	{
+		cout << "WARNING: could not allocate memory arena" << endl;
+		exit(-1);
+	}
+}
+
+/**
+ * Apenas referencia os contadores do arquivo mapeado, sem copiá-los.
+ */
+RamArena::RamArena(const void *mappedCounters, int counterBytes, int numRams, long long ramSize,
+				   shared_ptr<MappedFile> file)
+:counters((void *) mappedCounters), mappedFile(file), counterBytes(counterBytes), numRams(numRams), ramSize(ramSize)
+{
+}
+
+/**
+ * Aloca um novo bloco, próprio, com a mesma largura de contadores e copia o conteúdo de other.
+ */
+RamArena::RamArena(const RamArena &other)
+:counters(NULL), counterBytes(other.counterBytes), numRams(other.numRams), ramSize(other.ramSize)
+{
+	size_t numBytes = (size_t) numRams * (size_t) ramSize * (size_t) counterBytes;
+	counters = malloc(numBytes);
+	if(counters == NULL && numBytes > 0)
+	{
+		cout << "WARNING: could not allocate memory arena" << endl;
+		exit(-1);
+	}
+	memcpy(counters, other.counters, numBytes);
+}
+
+/**
+ * Libera o bloco de contadores, caso seja próprio.
+ */
+RamArena::~RamArena(void)
+{
+	if(!mappedFile)
+		free(counters);
+}
+
+/**
+ * Valores negativos ou maiores que INT_MAX não são representáveis e fazem o método retornar falso.
+ * Caso value não caiba na largura atual, alarga todos os contadores do bloco para a menor
+ * largura em que value caiba, e então o escreve.
+ */
+bool RamArena::setValue(int ram, long long addr, long long value)
+{
+	if(value < 0 || value > INT_MAX)
+		return false;
+	if(mappedFile)
+		detach();
+
+	if(counterBytes == 1 && value > UINT8_MAX)
+		widenCounters(value > UINT16_MAX ? 4 : 2);
+	else if(counterBytes == 2 && value > UINT16_MAX)
+		widenCounters(4);
+
+	long long pos = (long long) ram * ramSize + addr;
+	switch(counterBytes)
+	{
+		case 1:  ((uint8_t *) counters)[pos] = (uint8_t) value;   break;
+		case 2:  ((uint16_t *) counters)[pos] = (uint16_t) value; break;
+		default: ((uint32_t *) counters)[pos] = (uint32_t) value; break;
+	}
+	return true;
+}
+
+/**
+ * Escolhe a menor largura em que maxValue caiba, limitada a 32 bits, e alarga o bloco
+ * caso ela seja maior que a largura atual.
+ */
+void RamArena::reserveValue(long long maxValue)
+{
+	int neededBytes = (maxValue > UINT16_MAX) ? 4 : (maxValue > UINT8_MAX) ? 2 : 1;
+	if(mappedFile)
+		detach();
+	if(neededBytes > counterBytes)
+		widenCounters(neededBytes);
+}
+
+/**
+ * Zera a faixa de contadores pertencente à memória ram.
+ */
+void RamArena::clearRam(int ram)
+{
+	if(mappedFile)
+		detach();
+	memset((char *) counters + (size_t) ram * (size_t) ramSize * (size_t) counterBytes, 0,
+		   (size_t) ramSize * (size_t) counterBytes);
+}
+
+/**
+ * Formato: largura dos contadores, quantidade de memórias e de endereços por memória,
+ * seguidos dos contadores, alinhados em 64 bytes.
+ */
+void RamArena::write(ModelWriter &writer) const
+{
+	writer.write((int32_t) counterBytes);
+	writer.write((int32_t) numRams);
+	writer.write((int64_t) ramSize);
+	writer.align(64);
+	writer.writeBytes(counters, (size_t) numRams * (size_t) ramSize * (size_t) counterBytes);
+}
+
+/**
+ * Valida o cabeçalho do bloco e, conforme file, referencia os contadores no arquivo
+ * mapeado ou os copia para um novo bloco próprio.
+ */
+shared_ptr<RamArena> RamArena::read(ModelReader &reader, shared_ptr<MappedFile> file)
+{
+	int32_t counterBytes, numRams;
+	int64_t ramSize;
+	shared_ptr<RamArena> arena;
+
+	if(!reader.read(counterBytes) || !reader.read(numRams) || !reader.read(ramSize))
+		return arena;
+	if((counterBytes != 1 && counterBytes != 2 && counterBytes != 4) || numRams < 0 || ramSize < 0)
+		return arena;
+
+	reader.align(64);
+	size_t numBytes = (size_t) numRams * (size_t) ramSize * (size_t) counterBytes;
+	const char *bytes = reader.readBytes(numBytes);
+	if(bytes == NULL)
+		return arena;
+
+	if(file)
+	{
+		arena = make_shared<RamArena>(bytes, counterBytes, numRams, ramSize, file);
+	}
+	else
+	{
+		arena = make_shared<RamArena>(numRams, ramSize);
+		arena->widenCounters(counterBytes);
+		memcpy(arena->counters, bytes, numBytes);
+	}
+	return arena;
+}
+
+bool RamArena::isMapped(void) const
+{
+	return (bool) mappedFile;
+}
+
+const void *RamArena::getCounters(void) const
+{
+	return counters;
+}
+
+void *RamArena::getCounters(void)
+{
+	return counters;
+}
+
+int RamArena::getCounterBytes(void) const
+{
+	return counterBytes;
+}
+
+int RamArena::getNumRams(void) const
+{
+	return numRams;
+}
+
+long long RamArena::getRamSize(void) const
+{
+	return ramSize;
+}
+
+/**
+ * Aloca um bloco próprio, copia os contadores do arquivo mapeado e deixa de referenciá-lo.
+ */
+void RamArena::detach(void)
+{
+	size_t numBytes = (size_t) numRams * (size_t) ramSize * (size_t) counterBytes;
+	void *copy = malloc(numBytes);
+	if(copy == NULL && numBytes > 0)
+	{
+		cout << "WARNING: could not allocate memory arena" << endl;
+		exit(-1);
+	}
+	memcpy(copy, counters, numBytes);
+	counters = copy;
+	mappedFile.reset();
+}
+
+/**
+ * Aloca um novo bloco com a largura newCounterBytes, copia cada contador
+ * do bloco atual para ele e libera o bloco atual.
+ */
+void RamArena::widenCounters(int newCounterBytes)
+{
+	if(newCounterBytes == counterBytes)
+		return;
+
+	size_t numCounters = (size_t) numRams * (size_t) ramSize;
+	void *widened = malloc(numCounters * (size_t) newCounterBytes);
+	if(widened == NULL)
+	{
+		cout << "WARNING: could not allocate memory arena" << endl;
+		exit(-1);
+	}
+
+	for(size_t i = 0; i < numCounters; i++)
+	{
+		uint32_t value = (counterBytes == 1) ? ((uint8_t *) counters)[i] : ((uint16_t *) counters)[i];
+		if(newCounterBytes == 2)
+			((uint16_t *) widened)[i] = (uint16_t) value;
+		else
+			((uint32_t *) widened)[i] = value;
+	}
+
+	if(!mappedFile)
+		free(counters);
+	mappedFile.reset();
+	counters = widened;
+	counterBytes = newCounterBytes;
+}
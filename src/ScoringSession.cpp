@@ -0,0 +1,165 @@
+/**
+ * @file   ScoringSession.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe ScoringSession.
+ */
+
+#include "../include/ScoringSession.hpp"
+#include "../include/Util.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Os endereços de todas as tuplas da retina zerada são zero.
+ */
+ScoringSession::ScoringSession(const WiSARD &wisard)
+:wisard(wisard),
+ numLabels(0),
+ buffers(wisard.tupleMapping.getNumMemories()),
+ isChanged(wisard.tupleMapping.getNumMemories(), 0)
+{
+	fetchAll();
+}
+
+void ScoringSession::reset(const vector<int> &retina)
+{
+	wisard.tupleMapping.computeAddresses(retina, buffers.addresses.data());
+	fetchAll();
+}
+
+void ScoringSession::reset(const BitRetina &retina)
+{
+	wisard.tupleMapping.computeAddresses(retina, buffers.addresses.data());
+	fetchAll();
+}
+
+void ScoringSession::reset(const SparseRetina &retina)
+{
+	wisard.checkRetinaLength(retina);
+	wisard.tupleMapping.computeAddresses(retina, buffers.addresses.data());
+	fetchAll();
+}
+
+/**
+ * Lê, de todos os discriminadores, o conteúdo das memórias nos endereços correntes, através do
+ * mesmo membro utilizado por WiSARD::predictProba, e conta as memórias ativadas de cada label.
+ */
+void ScoringSession::fetchAll(void)
+{
+	numLabels = wisard.getNumLabels();
+	wisard.fetchResponses(buffers);
+	buffers.activeCounts.resize(numLabels);
+	util::countGreater(buffers.responses.data(), numLabels, wisard.tupleMapping.getNumMemories(), 0,
+					   buffers.activeCounts.data());
+	rowScores.resize(numLabels);
+}
+
+/**
+ * Inverte os bits das tuplas que utilizam as posições e, para cada tupla alterada (uma única vez,
+ * mesmo que utilize várias posições), lê o conteúdo das memórias de cada label no novo endereço.
+ * A quantidade de memórias ativadas de cada label é corrigida pela diferença entre o conteúdo
+ * anterior, ainda em buffers.responses, e o novo.
+ */
+void ScoringSession::flip(const vector<int> &positions)
+{
+	checkLabels();
+	int retinaLength = wisard.retinaLength;
+	for(size_t k = 0; k < positions.size(); k++)
+	{
+		if(positions[k] < 0 || positions[k] >= retinaLength)
+		{
+			cout << "WARNING: flipped position " << positions[k]
+				 << " is outside the retina of length " << retinaLength << endl;
+			exit(-1);
+		}
+	}
+
+	touched.clear();
+	wisard.tupleMapping.flipAddresses(positions.data(), (int) positions.size(), buffers.addresses.data(), touched);
+
+	changed.clear();
+	for(size_t k = 0; k < touched.size(); k++)
+	{
+		if(!isChanged[touched[k]])
+		{
+			isChanged[touched[k]] = 1;
+			changed.push_back(touched[k]);
+		}
+	}
+	for(size_t k = 0; k < changed.size(); k++)
+		isChanged[changed[k]] = 0;
+
+	int numMemories = wisard.tupleMapping.getNumMemories();
+	int numChanged = (int) changed.size();
+	previous.resize(numChanged);
+	for(int c = 0; c < numLabels; c++)
+	{
+		int *responses = buffers.responses.data() + (size_t) c * numMemories;
+		for(int k = 0; k < numChanged; k++)
+			previous[k] = responses[changed[k]];
+
+		wisard.discriminators[c]->predict(buffers.addresses.data(), responses, changed.data(), numChanged);
+
+		int count = buffers.activeCounts[c];
+		for(int k = 0; k < numChanged; k++)
+			count += (responses[changed[k]] > 0) - (previous[k] > 0);
+		buffers.activeCounts[c] = count;
+	}
+}
+
+/**
+ * As porcentagens são obtidas das quantidades mantidas pela sessão; o bleaching, quando utilizado
+ * pela rede, é aplicado sobre o conteúdo mantido de todas as memórias, como em WiSARD::predictProba.
+ */
+void ScoringSession::predictScores(float *scores)
+{
+	checkLabels();
+	int numMemories = wisard.tupleMapping.getNumMemories();
+	for(int c = 0; c < numLabels; c++)
+		scores[c] = (float) buffers.activeCounts[c] / (float) numMemories;
+
+	if(wisard.useBleaching)
+		wisard.applyBleaching(scores, buffers, buffers.responses.data(), wisard.getScoringOptions());
+}
+
+/**
+ * Cria um unordered map com as porcentagens, chaveado pelas labels.
+ */
+unordered_map<string, float> ScoringSession::predictProba(void)
+{
+	predictScores(rowScores.data());
+
+	unordered_map<string, float> result;
+	for(int c = 0; c < numLabels; c++)
+		result[wisard.labels[c]] = rowScores[c];
+	return result;
+}
+
+int ScoringSession::predictLabelIndex(void)
+{
+	predictScores(rowScores.data());
+	return util::argMax(rowScores.data(), numLabels);
+}
+
+string ScoringSession::predict(void)
+{
+	int index = predictLabelIndex();
+	return (index >= 0) ? wisard.labels[index] : string();
+}
+
+/**
+ * Um treinamento com novas labels alteraria o tamanho do conteúdo mantido pela sessão.
+ */
+void ScoringSession::checkLabels(void) const
+{
+	if(wisard.getNumLabels() != numLabels)
+	{
+		cout << "WARNING: the network labels changed since the scoring session was reset" << endl;
+		exit(-1);
+	}
+}
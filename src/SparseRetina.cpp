@@ -0,0 +1,65 @@
+/**
+ * @file   SparseRetina.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe SparseRetina.
+ */
+
+#include "../include/SparseRetina.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+using namespace wann;
+
+SparseRetina::SparseRetina(void)
+:length(0)
+{
+}
+
+/**
+ * Gera um warning e encerra a execução caso alguma posição esteja fora da retina.
+ */
+SparseRetina::SparseRetina(int length, const vector<int> &activePositions)
+:positions(activePositions), length(length)
+{
+	for(size_t k = 0; k < positions.size(); k++)
+	{
+		if(positions[k] < 0 || positions[k] >= length)
+		{
+			cout << "WARNING: active position " << positions[k]
+				 << " is outside the retina of length " << length << endl;
+			exit(-1);
+		}
+	}
+}
+
+/**
+ * Guarda, em ordem crescente, cada posição de retina cujo valor é diferente de zero,
+ * mesma convenção utilizada pelo endereçamento de Discriminator.
+ */
+SparseRetina::SparseRetina(const vector<int> &retina)
+:length((int) retina.size())
+{
+	for(int i = 0; i < length; i++)
+	{
+		if(retina[i] != 0)
+			positions.push_back(i);
+	}
+}
+
+int SparseRetina::size(void) const
+{
+	return length;
+}
+
+int SparseRetina::numActive(void) const
+{
+	return (int) positions.size();
+}
+
+const int *SparseRetina::data(void) const
+{
+	return positions.data();
+}
@@ -0,0 +1,81 @@
+/**
+ * @file   Stats.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação das estatísticas de ocupação das memórias e dos contadores
+ * de tempo de execução da rede.
+ */
+
+#include "../include/Stats.hpp"
+
+using namespace std;
+using namespace wann;
+
+MemoryStats::MemoryStats(void)
+:kind(SPARSE_MEMORY), numBits(0), capacity(0), usedCells(0), occupancy(0.0), loadFactor(0.0), bytes(0),
+ histogram(HISTOGRAM_BUCKETS, 0)
+{
+}
+
+/**
+ * A faixa de value é a posição do seu bit mais significativo. Conteúdos nulos não são contabilizados.
+ */
+void MemoryStats::addValue(long long value, long long numCells)
+{
+	if(value <= 0)
+		return;
+
+	int bucket = 0;
+	while(bucket < HISTOGRAM_BUCKETS - 1 && (value >> (bucket + 1)) != 0)
+		bucket++;
+	histogram[bucket] += numCells;
+	usedCells += numCells;
+}
+
+Profiler::Profiler(void)
+{
+	reset();
+}
+
+bool Profiler::isEnabled(void)
+{
+#ifdef WANN_PROFILE
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * Sem WANN_PROFILE, os contadores de local são sempre nulos, e nada é somado.
+ */
+void Profiler::add(const LocalProfile &local)
+{
+#ifdef WANN_PROFILE
+	for(int i = 0; i < LocalProfile::NUM_COUNTERS; i++)
+	{
+		if(local.values[i] != 0)
+			values[i].fetch_add(local.values[i], memory_order_relaxed);
+	}
+#endif
+}
+
+RuntimeProfile Profiler::snapshot(void) const
+{
+	RuntimeProfile profile;
+	profile.trainedSamples = values[LocalProfile::TRAINED_SAMPLES].load(memory_order_relaxed);
+	profile.predictedSamples = values[LocalProfile::PREDICTED_SAMPLES].load(memory_order_relaxed);
+	profile.bleachingCalls = values[LocalProfile::BLEACHING_CALLS].load(memory_order_relaxed);
+	profile.bleachingIterations = values[LocalProfile::BLEACHING_ITERATIONS].load(memory_order_relaxed);
+	profile.addressingSeconds = values[LocalProfile::ADDRESSING_NS].load(memory_order_relaxed) * 1e-9;
+	profile.trainingSeconds = values[LocalProfile::TRAINING_NS].load(memory_order_relaxed) * 1e-9;
+	profile.lookupSeconds = values[LocalProfile::LOOKUP_NS].load(memory_order_relaxed) * 1e-9;
+	profile.scoringSeconds = values[LocalProfile::SCORING_NS].load(memory_order_relaxed) * 1e-9;
+	return profile;
+}
+
+void Profiler::reset(void)
+{
+	for(int i = 0; i < LocalProfile::NUM_COUNTERS; i++)
+		values[i].store(0, memory_order_relaxed);
+}
@@ -0,0 +1,278 @@
+/**
+ * @file   Sweep.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe Sweep.
+ */
+
+#include "../include/Sweep.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace wann;
+
+Sweep::Sweep(int retinaLength,
+			 const vector<int> &numBitsAddr,
+			 const vector<WiSARD::ScoringOptions> &options,
+			 bool randomizePositions,
+			 bool isCummulative)
+:retinaLength(retinaLength),
+ numBitsAddr(numBitsAddr),
+ options(options),
+ randomizePositions(randomizePositions),
+ isCummulative(isCummulative)
+{
+}
+
+/**
+ * Percorre as combinações na ordem dos parâmetros. Sem bleaching, apenas a primeira combinação
+ * de confidenceThresholds e defaultBleaching_b é mantida.
+ */
+vector<WiSARD::ScoringOptions> Sweep::grid(const vector<bool> &useBleaching,
+										   const vector<float> &confidenceThresholds,
+										   const vector<int> &defaultBleaching_b,
+										   const vector<bool> &ignoreZeroAddr)
+{
+	vector<WiSARD::ScoringOptions> result;
+	for(size_t u = 0; u < useBleaching.size(); u++)
+	{
+		for(size_t t = 0; t < confidenceThresholds.size(); t++)
+		{
+			for(size_t b = 0; b < defaultBleaching_b.size(); b++)
+			{
+				if(!useBleaching[u] && (t > 0 || b > 0))
+					continue;
+
+				for(size_t z = 0; z < ignoreZeroAddr.size(); z++)
+				{
+					WiSARD::ScoringOptions option;
+					option.useBleaching = useBleaching[u];
+					option.confidenceThreshold = confidenceThresholds[t];
+					option.defaultBleaching_b = defaultBleaching_b[b];
+					option.ignoreZeroAddr = ignoreZeroAddr[z];
+					result.push_back(option);
+				}
+			}
+		}
+	}
+	return result;
+}
+
+vector<SweepResult> Sweep::evaluate(const vector< vector<int> > &XTrain, const vector<string> &yTrain,
+									const vector< vector<int> > &XTest, const vector<string> &yTest)
+{
+	return evaluateRetinas(XTrain, yTrain, XTest, yTest);
+}
+
+vector<SweepResult> Sweep::evaluate(const vector<BitRetina> &XTrain, const vector<string> &yTrain,
+									const vector<BitRetina> &XTest, const vector<string> &yTest)
+{
+	return evaluateRetinas(XTrain, yTrain, XTest, yTest);
+}
+
+vector<SweepResult> Sweep::crossValidate(const vector< vector<int> > &X, const vector<string> &y,
+										 int numFolds, unsigned seed)
+{
+	return crossValidateRetinas(X, y, numFolds, seed);
+}
+
+vector<SweepResult> Sweep::crossValidate(const vector<BitRetina> &X, const vector<string> &y,
+										 int numFolds, unsigned seed)
+{
+	return crossValidateRetinas(X, y, numFolds, seed);
+}
+
+/**
+ * Um trabalho por número de bits: cada rede é treinada com todo o conjunto de treinamento
+ * e avaliada com todos os parâmetros.
+ */
+template<typename RetinaType>
+vector<SweepResult> Sweep::evaluateRetinas(const vector<RetinaType> &XTrain, const vector<string> &yTrain,
+										   const vector<RetinaType> &XTest, const vector<string> &yTest)
+{
+	vector<long long> correct(numBitsAddr.size() * options.size(), 0);
+
+	runJobs((int) numBitsAddr.size(), [&](int job, shared_ptr<ThreadPool> pool)
+	{
+		WiSARD *wisard = createNetwork(numBitsAddr[job]);
+		wisard->setThreadPool(pool);
+		wisard->fit(XTrain, yTrain);
+		countCorrect(*wisard, XTest, yTest, correct.data() + job * options.size());
+		delete wisard;
+	});
+
+	return collect(correct, vector<long long>(1, (long long) XTest.size()));
+}
+
+/**
+ * As entradas de teste de cada partição são copiadas uma única vez (juntas, somam uma cópia de X)
+ * e compartilhadas entre os números de bits; o treinamento percorre X diretamente, ignorando
+ * as entradas da partição de teste. Um trabalho por número de bits e partição.
+ */
+template<typename RetinaType>
+vector<SweepResult> Sweep::crossValidateRetinas(const vector<RetinaType> &X, const vector<string> &y,
+												int numFolds, unsigned seed)
+{
+	if(numFolds < 2 || numFolds > (int) X.size())
+	{
+		cout << "WARNING: invalid number of folds for cross validation" << endl;
+		exit(-1);
+	}
+
+	vector<int> order(X.size());
+	for(size_t i = 0; i < order.size(); i++)
+		order[i] = (int) i;
+	shuffle(order.begin(), order.end(), default_random_engine(seed));
+
+	// consecutive slices of the shuffled order
+	vector<int> folds(X.size());
+	for(size_t k = 0; k < order.size(); k++)
+		folds[order[k]] = (int) (k * numFolds / order.size());
+
+	vector< vector<RetinaType> > XFolds(numFolds);
+	vector< vector<string> > yFolds(numFolds);
+	for(size_t i = 0; i < X.size(); i++)
+	{
+		XFolds[folds[i]].push_back(X[i]);
+		yFolds[folds[i]].push_back(y[i]);
+	}
+
+	vector<long long> foldSizes(numFolds);
+	for(int f = 0; f < numFolds; f++)
+		foldSizes[f] = (long long) XFolds[f].size();
+
+	vector<long long> correct(numBitsAddr.size() * numFolds * options.size(), 0);
+
+	runJobs((int) numBitsAddr.size() * numFolds, [&](int job, shared_ptr<ThreadPool> pool)
+	{
+		int fold = job % numFolds;
+		WiSARD *wisard = createNetwork(numBitsAddr[job / numFolds]);
+		wisard->setThreadPool(pool);
+		for(size_t i = 0; i < X.size(); i++)
+		{
+			if(folds[i] != fold)
+				wisard->train(X[i], y[i]);
+		}
+		countCorrect(*wisard, XFolds[fold], yFolds[fold], correct.data() + job * options.size());
+		delete wisard;
+	});
+
+	return collect(correct, foldSizes);
+}
+
+/**
+ * A rede é criada sem bleaching e sem omitir o primeiro endereço, já que esses parâmetros
+ * são aplicados apenas na avaliação.
+ */
+WiSARD *Sweep::createNetwork(int numBits) const
+{
+	return new WiSARD(retinaLength, numBits, false, 0.1, 1, randomizePositions, isCummulative, false);
+}
+
+/**
+ * Os trabalhos são distribuídos um a um entre as threads; cada rede é treinada e avaliada
+ * serialmente pela thread que a criou.
+ */
+void Sweep::runJobs(int numJobs, const function<void(int, shared_ptr<ThreadPool>)> &job)
+{
+	if(threadPool && numJobs > 1)
+	{
+		threadPool->parallelFor(numJobs, 1, [&](int begin, int end, int thread)
+		{
+			for(int j = begin; j < end; j++)
+				job(j, shared_ptr<ThreadPool>());
+		});
+	}
+	else
+	{
+		for(int j = 0; j < numJobs; j++)
+			job(j, threadPool);
+	}
+}
+
+/**
+ * Classifica as entradas com todos os parâmetros de uma só vez, através do membro
+ * WiSARD::predictLabelIndices, e compara com o índice da label esperada.
+ */
+template<typename RetinaType>
+void Sweep::countCorrect(WiSARD &wisard, const vector<RetinaType> &X, const vector<string> &y,
+						 long long *correct) const
+{
+	size_t numOptions = options.size();
+	vector<int> predicted(X.size() * numOptions);
+	wisard.predictLabelIndices(X, options, predicted.data());
+
+	for(size_t i = 0; i < X.size(); i++)
+	{
+		int expected = wisard.getLabelIndex(y[i]);
+		if(expected < 0)
+			continue;
+		for(size_t k = 0; k < numOptions; k++)
+		{
+			if(predicted[i * numOptions + k] == expected)
+				correct[k]++;
+		}
+	}
+}
+
+/**
+ * A acurácia de cada configuração é a média das acurácias de suas partições.
+ */
+vector<SweepResult> Sweep::collect(const vector<long long> &correct, const vector<long long> &foldSizes) const
+{
+	size_t numFolds = foldSizes.size();
+	vector<SweepResult> results;
+
+	for(size_t n = 0; n < numBitsAddr.size(); n++)
+	{
+		for(size_t k = 0; k < options.size(); k++)
+		{
+			SweepResult result;
+			result.numBitsAddr = numBitsAddr[n];
+			result.options = options[k];
+			result.accuracy = 0.0;
+			for(size_t f = 0; f < numFolds; f++)
+			{
+				long long hits = correct[(n * numFolds + f) * options.size() + k];
+				float accuracy = (foldSizes[f] > 0) ? (float) hits / (float) foldSizes[f] : 0.0f;
+				result.foldAccuracies.push_back(accuracy);
+				result.accuracy += accuracy / numFolds;
+			}
+			results.push_back(result);
+		}
+	}
+	return results;
+}
+
+void Sweep::report(ostream &output, const vector<SweepResult> &results)
+{
+	for(size_t i = 0; i < results.size(); i++)
+	{
+		const SweepResult &result = results[i];
+		output << "accuracy: " << result.accuracy
+			   << ", num_bits: " << result.numBitsAddr
+			   << ", bleaching: " << result.options.useBleaching
+			   << ", conf_threshold: " << result.options.confidenceThreshold
+			   << ", bleaching_b: " << result.options.defaultBleaching_b
+			   << ", ignoreZeros: " << result.options.ignoreZeroAddr << endl;
+	}
+}
+
+/**
+ * Descarta o ThreadPool atual e, caso numThreads seja diferente de 1, cria um novo ThreadPool.
+ */
+void Sweep::setNumThreads(int numThreads)
+{
+	threadPool.reset();
+	if(numThreads != 1)
+		threadPool = make_shared<ThreadPool>(numThreads);
+}
+
+void Sweep::setThreadPool(shared_ptr<ThreadPool> threadPool)
+{
+	this->threadPool = threadPool;
+}
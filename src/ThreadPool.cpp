@@ -0,0 +1,123 @@
+/**
+ * @file   ThreadPool.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe ThreadPool.
+ */
+
+#include "../include/ThreadPool.hpp"
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Cria numThreads - 1 threads auxiliares, que aguardam por laços a serem processados.
+ */
+ThreadPool::ThreadPool(int numThreads)
+:numThreads(numThreads), generation(0), activeWorkers(0), stopping(false),
+ body(NULL), numItems(0), chunkSize(1), nextItem(0)
+{
+	if(this->numThreads < 1)
+		this->numThreads = max(1, (int) thread::hardware_concurrency());
+
+	for(int i = 1; i < this->numThreads; i++)
+		workers.push_back(thread(&ThreadPool::workerLoop, this, i));
+}
+
+/**
+ * Sinaliza o encerramento e aguarda o término de todas as threads auxiliares.
+ */
+ThreadPool::~ThreadPool(void)
+{
+	{
+		lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+
+	for(size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+int ThreadPool::getNumThreads(void) const
+{
+	return numThreads;
+}
+
+/**
+ * Publica o laço para as threads auxiliares, processa blocos na própria thread
+ * e aguarda até que todas as threads auxiliares tenham terminado.
+ */
+void ThreadPool::parallelFor(int numItems, int chunkSize, const function<void(int, int, int)> &body)
+{
+	if(numItems <= 0)
+		return;
+	if(chunkSize < 1)
+		chunkSize = max(1, numItems / (numThreads * 8));
+
+	if(workers.empty() || numItems <= chunkSize)
+	{
+		body(0, numItems, 0);
+		return;
+	}
+
+	lock_guard<std::mutex> callLock(callMutex);
+	{
+		lock_guard<std::mutex> lock(mutex);
+		this->body = &body;
+		this->numItems = numItems;
+		this->chunkSize = chunkSize;
+		nextItem.store(0);
+		activeWorkers = (int) workers.size();
+		generation++;
+	}
+	workAvailable.notify_all();
+
+	runChunks(0);
+
+	unique_lock<std::mutex> lock(mutex);
+	workDone.wait(lock, [this]{ return activeWorkers == 0; });
+	this->body = NULL;
+}
+
+/**
+ * Aguarda um novo laço, processa seus blocos e sinaliza o término, até o encerramento.
+ */
+void ThreadPool::workerLoop(int thread)
+{
+	long long seenGeneration = 0;
+
+	while(true)
+	{
+		{
+			unique_lock<std::mutex> lock(mutex);
+			workAvailable.wait(lock, [&]{ return stopping || generation != seenGeneration; });
+			if(stopping)
+				return;
+			seenGeneration = generation;
+		}
+
+		runChunks(thread);
+
+		{
+			lock_guard<std::mutex> lock(mutex);
+			activeWorkers--;
+		}
+		workDone.notify_one();
+	}
+}
+
+/**
+ * Reserva atomicamente o próximo bloco de índices e o processa, até esgotar os índices.
+ */
+void ThreadPool::runChunks(int thread)
+{
+	while(true)
+	{
+		int begin = nextItem.fetch_add(chunkSize);
+		if(begin >= numItems)
+			return;
+
+		(*body)(begin, min(begin + chunkSize, numItems), thread);
+	}
+}
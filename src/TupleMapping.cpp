@@ -0,0 +1,385 @@
+/**
+ * @file   TupleMapping.cpp
+ * @Author fabricio
+ * @date   Outubro 17, 2026
+ * @brief  Arquivo de implementação da classe TupleMapping.
+ */
+
+#include "../include/TupleMapping.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace wann;
+
+/**
+ * Endereço de uma tupla de N bits, com o laço sobre os bits desenrolado em tempo de compilação:
+ * cada bit j contribui com (retina[position[j]] != 0) << j, sem desvios.
+ */
+template<int N>
+struct TupleAddress
+{
+	static inline long long compute(const int *retina, const int *position)
+	{
+		return TupleAddress<N-1>::compute(retina, position) | ((long long) (retina[position[N-1]] != 0) << (N-1));
+	}
+};
+
+template<>
+struct TupleAddress<0>
+{
+	static inline long long compute(const int *, const int *)
+	{
+		return 0LL;
+	}
+};
+
+/**
+ * Calcula os endereços das tuplas completas [memBegin, memEnd), todas com NumBits bits.
+ */
+template<int NumBits>
+static void computeFixedTuples(const int *retina, const int *positions, long long *addresses, int memBegin, int memEnd)
+{
+	const int *position = positions + (long long) memBegin * NumBits;
+	for(int m = memBegin; m < memEnd; m++, position += NumBits)
+		addresses[m] = TupleAddress<NumBits>::compute(retina, position);
+}
+
+/** Instância de computeFixedTuples para cada largura de tupla até MAX_FIXED_BITS (posição 0 sem uso).*/
+static void (* const FIXED_KERNELS[TupleMapping::MAX_FIXED_BITS + 1])(const int *, const int *, long long *, int, int) =
+{
+	NULL,
+	&computeFixedTuples<1>,  &computeFixedTuples<2>,  &computeFixedTuples<3>,  &computeFixedTuples<4>,
+	&computeFixedTuples<5>,  &computeFixedTuples<6>,  &computeFixedTuples<7>,  &computeFixedTuples<8>,
+	&computeFixedTuples<9>,  &computeFixedTuples<10>, &computeFixedTuples<11>, &computeFixedTuples<12>,
+	&computeFixedTuples<13>, &computeFixedTuples<14>, &computeFixedTuples<15>, &computeFixedTuples<16>,
+	&computeFixedTuples<17>, &computeFixedTuples<18>, &computeFixedTuples<19>, &computeFixedTuples<20>,
+	&computeFixedTuples<21>, &computeFixedTuples<22>, &computeFixedTuples<23>, &computeFixedTuples<24>,
+	&computeFixedTuples<25>, &computeFixedTuples<26>, &computeFixedTuples<27>, &computeFixedTuples<28>,
+	&computeFixedTuples<29>, &computeFixedTuples<30>, &computeFixedTuples<31>, &computeFixedTuples<32>
+};
+
+TupleMapping::TupleMapping(void)
+:retinaLength(0), numBitsAddr(1), numMemories(0), numFullMemories(0), fixedKernel(NULL),
+ tupleOffsets(1, 0), segmentOffsets(1, 0), inverseOffsets(1, 0)
+{
+}
+
+/**
+ * Monta as posições de cada tupla, mantendo a forma de endereçamento original do Discriminator:
+ * a tupla de resto (quando retinaLength não é múltiplo de numBits) usa as posições
+ * memoryAddressMapping[retinaLength - resto - 1 ... retinaLength - 2].
+ * Em seguida, divide cada tupla em segmentos para a extração a partir de palavras de 64 bits,
+ * e escolhe a instância de computeFixedTuples correspondente a numBits, se houver.
+ * Por fim, monta o mapeamento inverso, agrupando os bits de tupla por posição da retina; como a
+ * tupla de resto reutiliza posições das tuplas completas, uma posição pode pertencer a duas tuplas.
+ */
+TupleMapping::TupleMapping(int retinaLength, int numBits, const vector<int> &memoryAddressMapping)
+:retinaLength(retinaLength), numBitsAddr(numBits)
+{
+	numMemories = (int) ceil(((float)retinaLength)/(float)numBits);
+	numFullMemories = retinaLength / numBits;
+	fixedKernel = (numBits >= 1 && numBits <= MAX_FIXED_BITS) ? FIXED_KERNELS[numBits] : NULL;
+	int restOfPositions = retinaLength % numBits;
+
+	tupleOffsets.push_back(0);
+	for(int i = 0; i < numFullMemories; i++)
+	{
+		for(int j = 0; j < numBits; j++)
+			positions.push_back(memoryAddressMapping[i*numBits + j]);
+		tupleOffsets.push_back((int) positions.size());
+	}
+	if(restOfPositions != 0)
+	{
+		int start = retinaLength - restOfPositions - 1;
+		if(start < 0)
+			start = 0;
+		for(int j = 0; j < restOfPositions; j++)
+			positions.push_back(memoryAddressMapping[start + j]);
+		tupleOffsets.push_back((int) positions.size());
+	}
+
+	segmentOffsets.push_back(0);
+	for(int m = 0; m < numMemories; m++)
+	{
+		int previousPosition = -1;
+		for(int j = 0; j < tupleOffsets[m+1] - tupleOffsets[m]; j++)
+		{
+			int position = positions[tupleOffsets[m] + j];
+			bool extendsSegment = (int) segments.size() > segmentOffsets[m]
+								  && (position >> 6) == segments.back().word
+								  && position > previousPosition;
+			if(!extendsSegment)
+			{
+				Segment segment;
+				segment.word = position >> 6;
+				segment.outShift = j;
+				segment.mask = 0ULL;
+				segments.push_back(segment);
+			}
+			segments.back().mask |= (1ULL << (position & 63));
+			previousPosition = position;
+		}
+		segmentOffsets.push_back((int) segments.size());
+	}
+
+	for(size_t s = 0; s < segments.size(); s++)
+	{
+		uint64_t mask = segments[s].mask;
+		int lowBit = 0;
+		while(((mask >> lowBit) & 1ULL) == 0)
+			lowBit++;
+		uint64_t shifted = mask >> lowBit;
+		segments[s].lowBit = lowBit;
+		segments[s].contiguous = (shifted & (shifted + 1)) == 0;
+	}
+
+	inverseOffsets.assign(retinaLength + 1, 0);
+	for(size_t k = 0; k < positions.size(); k++)
+		inverseOffsets[positions[k] + 1]++;
+	for(int p = 0; p < retinaLength; p++)
+		inverseOffsets[p + 1] += inverseOffsets[p];
+
+	vector<int> next(inverseOffsets.begin(), inverseOffsets.end() - 1);
+	inverseBits.resize(positions.size());
+	for(int m = 0; m < numMemories; m++)
+	{
+		for(int j = 0; j < tupleOffsets[m+1] - tupleOffsets[m]; j++)
+		{
+			TupleBit &tupleBit = inverseBits[next[positions[tupleOffsets[m] + j]]++];
+			tupleBit.memory = m;
+			tupleBit.bit = j;
+		}
+	}
+}
+
+int TupleMapping::getNumMemories(void) const
+{
+	return numMemories;
+}
+
+int TupleMapping::getMemoryBits(int memIndex) const
+{
+	return tupleOffsets[memIndex+1] - tupleOffsets[memIndex];
+}
+
+void TupleMapping::computeAddresses(const vector<int> &retina, long long *addresses) const
+{
+	computeAddresses(retina, addresses, 0, numMemories);
+}
+
+void TupleMapping::computeAddresses(const BitRetina &retina, long long *addresses) const
+{
+	computeAddresses(retina, addresses, 0, numMemories);
+}
+
+/**
+ * Para cada tupla, soma o peso 2^j de cada bit j cuja posição da retina é diferente de zero.
+ * As tuplas completas usam a instância de computeFixedTuples da largura do mapeamento; a tupla
+ * de resto, e todas as tuplas quando numBitsAddr excede MAX_FIXED_BITS, usam o laço genérico.
+ */
+void TupleMapping::computeAddresses(const vector<int> &retina, long long *addresses, int memBegin, int memEnd) const
+{
+	if(fixedKernel && memBegin < numFullMemories)
+	{
+		int fixedEnd = min(memEnd, numFullMemories);
+		fixedKernel(retina.data(), positions.data(), addresses, memBegin, fixedEnd);
+		memBegin = fixedEnd;
+	}
+
+	const int *position = positions.data() + tupleOffsets[memBegin];
+
+	for(int m = memBegin; m < memEnd; m++)
+	{
+		long long addr = 0LL;
+		int tupleBits = tupleOffsets[m+1] - tupleOffsets[m];
+
+		for(int j = 0; j < tupleBits; j++)
+			addr |= (long long) (retina[position[j]] != 0) << j;
+
+		addresses[m] = addr;
+		position += tupleBits;
+	}
+}
+
+/**
+ * Para cada tupla, extrai cada segmento da palavra correspondente da retina e o desloca
+ * para a sua posição no endereço. Com BMI2, a extração é feita por PEXT; sem BMI2,
+ * segmentos contíguos usam deslocamento e máscara e os demais são extraídos bit a bit.
+ */
+void TupleMapping::computeAddresses(const BitRetina &retina, long long *addresses, int memBegin, int memEnd) const
+{
+	const uint64_t *words = retina.data();
+	const Segment *segment = segments.data() + segmentOffsets[memBegin];
+
+	for(int m = memBegin; m < memEnd; m++)
+	{
+		uint64_t addr = 0ULL;
+		const Segment *end = segments.data() + segmentOffsets[m+1];
+
+		for(; segment != end; ++segment)
+		{
+			uint64_t word = words[segment->word];
+			uint64_t bits;
+#if defined(__BMI2__)
+			bits = _pext_u64(word, segment->mask);
+#else
+			if(segment->contiguous)
+			{
+				bits = (word & segment->mask) >> segment->lowBit;
+			}
+			else
+			{
+				bits = 0ULL;
+				int k = 0;
+				for(uint64_t mask = segment->mask; mask != 0ULL; mask &= mask - 1ULL, k++)
+				{
+					if(word & mask & (~mask + 1ULL))
+						bits |= (1ULL << k);
+				}
+			}
+#endif
+			addr |= bits << segment->outShift;
+		}
+		addresses[m] = (long long) addr;
+	}
+}
+
+void TupleMapping::computeAddresses(const SparseRetina &retina, long long *addresses) const
+{
+	computeAddresses(retina, addresses, 0, numMemories);
+}
+
+/**
+ * Zera os endereços do intervalo e, para cada posição ativa, soma o peso 2^j de cada bit j
+ * de tupla do intervalo que a utiliza.
+ */
+void TupleMapping::computeAddresses(const SparseRetina &retina, long long *addresses, int memBegin, int memEnd) const
+{
+	fill(addresses + memBegin, addresses + memEnd, 0LL);
+
+	const int *active = retina.data();
+	for(int k = 0; k < retina.numActive(); k++)
+	{
+		const TupleBit *bit = inverseBits.data() + inverseOffsets[active[k]];
+		const TupleBit *end = inverseBits.data() + inverseOffsets[active[k] + 1];
+		for(; bit != end; ++bit)
+		{
+			if(bit->memory >= memBegin && bit->memory < memEnd)
+				addresses[bit->memory] |= (1LL << bit->bit);
+		}
+	}
+}
+
+/**
+ * Como cada posição ativa acrescenta um bit ao endereço da tupla, uma tupla é encontrada
+ * pela primeira vez quando o seu endereço ainda é zero.
+ */
+int TupleMapping::computeTouchedAddresses(const SparseRetina &retina, long long *addresses, int *touched) const
+{
+	int numTouched = 0;
+	const int *active = retina.data();
+	for(int k = 0; k < retina.numActive(); k++)
+	{
+		const TupleBit *bit = inverseBits.data() + inverseOffsets[active[k]];
+		const TupleBit *end = inverseBits.data() + inverseOffsets[active[k] + 1];
+		for(; bit != end; ++bit)
+		{
+			if(addresses[bit->memory] == 0)
+				touched[numTouched++] = bit->memory;
+			addresses[bit->memory] |= (1LL << bit->bit);
+		}
+	}
+	return numTouched;
+}
+
+/**
+ * Cada bit de tupla que utiliza uma posição invertida é invertido no endereço da tupla.
+ */
+void TupleMapping::flipAddresses(const int *positions, int numPositions, long long *addresses, vector<int> &touched) const
+{
+	for(int k = 0; k < numPositions; k++)
+	{
+		const TupleBit *bit = inverseBits.data() + inverseOffsets[positions[k]];
+		const TupleBit *end = inverseBits.data() + inverseOffsets[positions[k] + 1];
+		for(; bit != end; ++bit)
+		{
+			addresses[bit->memory] ^= (1LL << bit->bit);
+			touched.push_back(bit->memory);
+		}
+	}
+}
+
+/**
+ * Copia, na ordem das posições de cada tupla, o atributo e o intervalo de cada bit,
+ * de forma que o cálculo dos endereços percorra um único vetor contíguo.
+ */
+void TupleMapping::setEncoder(const Encoder &encoder)
+{
+	if(encoder.getRetinaLength() != retinaLength)
+	{
+		cout << "WARNING: encoder retina length (" << encoder.getRetinaLength()
+			 << ") differs from the retina length (" << retinaLength << ")" << endl;
+		exit(-1);
+	}
+
+	this->encoder = encoder;
+	encodedBits.resize(positions.size());
+	for(size_t k = 0; k < positions.size(); k++)
+	{
+		encodedBits[k].feature = encoder.getFeature(positions[k]);
+		encodedBits[k].lower = encoder.getLower(positions[k]);
+		encodedBits[k].upper = encoder.getUpper(positions[k]);
+	}
+}
+
+bool TupleMapping::hasEncoder(void) const
+{
+	return !encodedBits.empty();
+}
+
+const Encoder &TupleMapping::getEncoder(void) const
+{
+	return encoder;
+}
+
+void TupleMapping::computeAddresses(const vector<float> &features, long long *addresses) const
+{
+	computeAddresses(features, addresses, 0, numMemories);
+}
+
+/**
+ * Para cada tupla, soma o peso 2^j de cada bit j cujo atributo está dentro do seu intervalo.
+ */
+void TupleMapping::computeAddresses(const vector<float> &features, long long *addresses, int memBegin, int memEnd) const
+{
+	if(!hasEncoder())
+	{
+		cout << "WARNING: no encoder to address numeric features" << endl;
+		exit(-1);
+	}
+
+	const float *values = features.data();
+	const EncodedBit *bit = encodedBits.data() + tupleOffsets[memBegin];
+
+	for(int m = memBegin; m < memEnd; m++)
+	{
+		long long addr = 0LL;
+		int tupleBits = tupleOffsets[m+1] - tupleOffsets[m];
+
+		for(int j = 0; j < tupleBits; j++)
+		{
+			float value = values[bit[j].feature];
+			addr |= (long long) (value >= bit[j].lower && value < bit[j].upper) << j;
+		}
+
+		addresses[m] = addr;
+		bit += tupleBits;
+	}
+}
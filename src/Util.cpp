@@ -7,6 +7,9 @@
 
 #include "../include/Util.hpp"
 
+#include <algorithm>
+#include <climits>
+
 using namespace std;
 using namespace wann;
 
@@ -79,5 +82,300 @@ string util::argMax(unordered_map<string, float> &values)
     return maxLabel;
 }
 
+/**
+ * Mesmo cálculo do membro calculateConfidence sobre unordered_map.
+ */
+float util::calculateConfidence(const float *result, int numLabels)
+{
+    float max = 0.0;
+    float secondMax = 0.0;
+
+    for (int i = 0; i < numLabels; i++)
+    {
+        float value = result[i];
+
+        if(max < value)
+        {
+            secondMax = max;
+            max = value;
+        }
+        else if(secondMax < value)
+        {
+            secondMax = value;
+        }
+    }
+    
+    float confidence = 1.0 - (secondMax /max);
+    return confidence;
+}
+
+/**
+ * Mesmo cálculo do membro maxValue sobre unordered_map.
+ */
+float util::maxValue(const float *values, int numLabels)
+{
+    float max = 0.0;
+    for (int i = 0; i < numLabels; i++)
+    {
+        float value = values[i];
+        if( (value - max) > 0.0001 ) 
+        {
+            max = value;
+        }
+    }
+
+    return max;
+}
+
+/**
+ * Mesmo critério do membro argMax sobre unordered_map: vence a última label,
+ * na ordem dos índices, com a maior porcentagem.
+ */
+int util::argMax(const float *values, int numLabels)
+{
+    float max = 0.0;
+    int maxLabel = -1;
+
+    for (int i = 0; i < numLabels; i++)
+    {
+        float value = values[i];
+
+        if(max <= value)
+        {
+            max = value;
+            maxLabel = i;
+        }
+    }
+
+    return maxLabel;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define WANN_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+/**
+ * Implementação escalar de countGreater, utilizada também para os valores restantes
+ * das implementações vetoriais. O menor valor só é calculado quando WithMin é verdadeiro.
+ */
+template<bool WithMin>
+static int countGreaterScalar(const int *values, int count, int threshold, int *minAbove)
+{
+    int total = 0;
+    int minValue = INT_MAX;
+
+    for(int i = 0; i < count; i++)
+    {
+        int value = values[i];
+        total += (value > threshold);
+        if(WithMin && value > threshold && value < minValue)
+            minValue = value;
+    }
+
+    if(WithMin)
+        *minAbove = minValue;
+    return total;
+}
 
+#ifdef WANN_X86_KERNELS
 
+/**
+ * Processa 4 valores por vez. Cada comparação gera -1 nas posições maiores que threshold,
+ * que é subtraído dos contadores; o menor valor é mantido por máscaras, pois SSE2 não possui
+ * mínimo de inteiros de 32 bits.
+ */
+template<bool WithMin>
+__attribute__((target("sse2")))
+static int countGreaterSse2(const int *values, int count, int threshold, int *minAbove)
+{
+    const __m128i limit = _mm_set1_epi32(threshold);
+    const __m128i maxInt = _mm_set1_epi32(INT_MAX);
+    __m128i totals = _mm_setzero_si128();
+    __m128i minValues = maxInt;
+
+    int i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i value = _mm_loadu_si128((const __m128i *) (values + i));
+        __m128i greater = _mm_cmpgt_epi32(value, limit);
+        totals = _mm_sub_epi32(totals, greater);
+        if(WithMin)
+        {
+            __m128i candidate = _mm_or_si128(_mm_and_si128(greater, value), _mm_andnot_si128(greater, maxInt));
+            __m128i smaller = _mm_cmplt_epi32(candidate, minValues);
+            minValues = _mm_or_si128(_mm_and_si128(smaller, candidate), _mm_andnot_si128(smaller, minValues));
+        }
+    }
+
+    int lanes[4];
+    _mm_storeu_si128((__m128i *) lanes, totals);
+    int total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    int restMin;
+    total += countGreaterScalar<WithMin>(values + i, count - i, threshold, &restMin);
+    if(WithMin)
+    {
+        _mm_storeu_si128((__m128i *) lanes, minValues);
+        *minAbove = min(min(min(lanes[0], lanes[1]), min(lanes[2], lanes[3])), restMin);
+    }
+    return total;
+}
+
+/**
+ * Processa 8 valores por vez, com o mesmo esquema da versão SSE2; o menor valor usa
+ * blend e mínimo de inteiros de 32 bits.
+ */
+template<bool WithMin>
+__attribute__((target("avx2")))
+static int countGreaterAvx2(const int *values, int count, int threshold, int *minAbove)
+{
+    const __m256i limit = _mm256_set1_epi32(threshold);
+    const __m256i maxInt = _mm256_set1_epi32(INT_MAX);
+    __m256i totals = _mm256_setzero_si256();
+    __m256i minValues = maxInt;
+
+    int i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i value = _mm256_loadu_si256((const __m256i *) (values + i));
+        __m256i greater = _mm256_cmpgt_epi32(value, limit);
+        totals = _mm256_sub_epi32(totals, greater);
+        if(WithMin)
+            minValues = _mm256_min_epi32(minValues, _mm256_blendv_epi8(maxInt, value, greater));
+    }
+
+    int lanes[8];
+    _mm256_storeu_si256((__m256i *) lanes, totals);
+    int total = 0;
+    for(int k = 0; k < 8; k++)
+        total += lanes[k];
+
+    int restMin;
+    total += countGreaterScalar<WithMin>(values + i, count - i, threshold, &restMin);
+    if(WithMin)
+    {
+        _mm256_storeu_si256((__m256i *) lanes, minValues);
+        for(int k = 0; k < 8; k++)
+            restMin = min(restMin, lanes[k]);
+        *minAbove = restMin;
+    }
+    return total;
+}
+
+/**
+ * Processa 16 valores por vez: a comparação gera uma máscara de bits, contada por popcount,
+ * e o mínimo é atualizado apenas nas posições da máscara. Os valores restantes são lidos
+ * com uma carga mascarada, sem laço escalar.
+ */
+template<bool WithMin>
+__attribute__((target("avx512f,popcnt")))
+static int countGreaterAvx512(const int *values, int count, int threshold, int *minAbove)
+{
+    const __m512i limit = _mm512_set1_epi32(threshold);
+    __m512i minValues = _mm512_set1_epi32(INT_MAX);
+    int total = 0;
+
+    int i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        __m512i value = _mm512_loadu_si512((const void *) (values + i));
+        __mmask16 greater = _mm512_cmpgt_epi32_mask(value, limit);
+        total += _mm_popcnt_u32(greater);
+        if(WithMin)
+            minValues = _mm512_mask_min_epi32(minValues, greater, minValues, value);
+    }
+    if(i < count)
+    {
+        __mmask16 rest = (__mmask16) ((1u << (count - i)) - 1u);
+        __m512i value = _mm512_maskz_loadu_epi32(rest, (const void *) (values + i));
+        __mmask16 greater = _mm512_mask_cmpgt_epi32_mask(rest, value, limit);
+        total += _mm_popcnt_u32(greater);
+        if(WithMin)
+            minValues = _mm512_mask_min_epi32(minValues, greater, minValues, value);
+    }
+
+    if(WithMin)
+    {
+        int lanes[16];
+        _mm512_storeu_si512((void *) lanes, minValues);
+        int minValue = lanes[0];
+        for(int k = 1; k < 16; k++)
+            minValue = min(minValue, lanes[k]);
+        *minAbove = minValue;
+    }
+    return total;
+}
+
+#endif
+
+/**
+ * Implementações de countGreater para um conjunto de instruções.
+ */
+struct CountGreaterKernels
+{
+    /** Nome do conjunto de instruções.*/
+    const char *name;
+    /** Contagem sem o menor valor.*/
+    int (*count)(const int *values, int count, int threshold, int *minAbove);
+    /** Contagem com o menor valor.*/
+    int (*countWithMin)(const int *values, int count, int threshold, int *minAbove);
+};
+
+/**
+ * Escolhe, uma única vez, o maior conjunto de instruções suportado pelo processador
+ * (e pelo sistema operacional, no caso de AVX e AVX-512).
+ */
+static const CountGreaterKernels &getCountGreaterKernels(void)
+{
+    static const CountGreaterKernels kernels = []()
+    {
+        CountGreaterKernels selected = {"scalar", &countGreaterScalar<false>, &countGreaterScalar<true>};
+#ifdef WANN_X86_KERNELS
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt"))
+        {
+            CountGreaterKernels avx512 = {"avx512", &countGreaterAvx512<false>, &countGreaterAvx512<true>};
+            selected = avx512;
+        }
+        else if(__builtin_cpu_supports("avx2"))
+        {
+            CountGreaterKernels avx2 = {"avx2", &countGreaterAvx2<false>, &countGreaterAvx2<true>};
+            selected = avx2;
+        }
+        else if(__builtin_cpu_supports("sse2"))
+        {
+            CountGreaterKernels sse2 = {"sse2", &countGreaterSse2<false>, &countGreaterSse2<true>};
+            selected = sse2;
+        }
+#endif
+        return selected;
+    }();
+    return kernels;
+}
+
+/**
+ * Delega a contagem à implementação escolhida para o processador.
+ */
+int util::countGreater(const int *values, int count, int threshold, int *minAbove)
+{
+    const CountGreaterKernels &kernels = getCountGreaterKernels();
+    if(minAbove != NULL)
+        return kernels.countWithMin(values, count, threshold, minAbove);
+    return kernels.count(values, count, threshold, NULL);
+}
+
+/**
+ * Aplica a contagem a cada linha, com a implementação escolhida para o processador.
+ */
+void util::countGreater(const int *values, int numRows, int rowLength, int threshold, int *counts)
+{
+    const CountGreaterKernels &kernels = getCountGreaterKernels();
+    for(int r = 0; r < numRows; r++)
+        counts[r] = kernels.count(values + (size_t) r * rowLength, rowLength, threshold, NULL);
+}
+
+const char *util::getSimdInstructionSet(void)
+{
+    return getCountGreaterKernels().name;
+}
@@ -8,13 +8,20 @@
 #include "../include/WiSARD.hpp"
 #include "../include/Discriminator.hpp"
 #include "../include/Util.hpp"
+#include "../include/ModelFile.hpp"
 
+#include <climits>
 #include <cmath>
 #include <iostream>
 #include <random>
 #include <algorithm>
+#include <numeric>
 #include <chrono>
+#include <cstring>
 #include <string>
+#include <functional>
+#include <memory>
+#include <stdint.h>
 
 using namespace wann;
 using namespace std;
@@ -24,6 +31,10 @@ using namespace std;
  * Caso randomizePositions seja verdadeiro, cria uma semente aleatória, baseada na hora atual,
  * salva seu conteúdo no membro interno "seed" e a utiliza  para embaralhar
  * o conteúdo do vetor "memoryAddressMapping".
+ * Por fim, monta o membro interno tupleMapping, utilizado para calcular os endereços
+ * das entradas uma única vez para todos os discriminadores.
+ * Redes não cumulativas guardam um único bit por endereço, no bloco de bits compartilhado
+ * pelos discriminadores (ou em mapas de bits comprimidos, para memórias largas).
  */
 WiSARD::WiSARD(int retinaLength, 
 			   int numBitsAddr, 
@@ -41,7 +52,9 @@ WiSARD::WiSARD(int retinaLength,
  defaultBleaching_b(defaultBleaching_b),
  randomizePositions(randomizePositions),
  isCummulative(isCummulative),
- ignoreZeroAddr(ignoreZeroAddr)
+ ignoreZeroAddr(ignoreZeroAddr),
+ seed(0),
+ earlyExit(false)
 {
 	for(int i=0; i < retinaLength; i++)
 		memoryAddressMapping.push_back(i);
@@ -51,196 +64,1531 @@ WiSARD::WiSARD(int retinaLength,
 		seed = chrono::system_clock::now().time_since_epoch().count();
 		shuffle(begin(memoryAddressMapping), end(memoryAddressMapping), default_random_engine(seed));
 	}
-	
+
+	tupleMapping = TupleMapping(retinaLength, numBitsAddr, memoryAddressMapping);
+
+	if(!isCummulative)
+		bitArena = createBitArena();
+}
+
+/**
+ * O bloco é criado sem slots; cada discriminador adiciona o seu ao ser criado.
+ */
+shared_ptr<BitArena> WiSARD::createBitArena(void) const
+{
+	long long ramSize = (numBitsAddr <= Memory::DENSE_MAX_BITS) ? (1LL << numBitsAddr) : 0;
+	return make_shared<BitArena>(tupleMapping.getNumMemories(), ramSize);
+}
+
+/**
+ * Deleta dinâmicamente todos os objetos "discriminators"
+ * associados a WiSARD criada.
+ */
+WiSARD::~WiSARD(void)
+{
+	clearDiscriminators();
+}
+
+/**
+ * Descarta todos os discriminadores existentes e, em seguida, treina a rede do zero
+ * com as entradas X, através do membro partialFit.
+ */
+void WiSARD::fit(const vector< vector<int> > &X, const vector<string> &y)
+{
+	clearDiscriminators();
+	partialFitRetinas(X, y);
+}
+
+/**
+ * Mesmo comportamento do membro fit para retinas de inteiros.
+ */
+void WiSARD::fit(const vector<BitRetina> &X, const vector<string> &y)
+{
+	clearDiscriminators();
+	partialFitRetinas(X, y);
+}
+
+/**
+ * Mesmo comportamento do membro fit para retinas de inteiros, a partir das posições ativas.
+ */
+void WiSARD::fit(const vector<SparseRetina> &X, const vector<string> &y)
+{
+	checkRetinaLength(X);
+	clearDiscriminators();
+	partialFitRetinas(X, y);
+}
+
+/**
+ * Mesmo comportamento do membro fit para retinas de inteiros; os endereços são calculados
+ * a partir dos atributos, através do codificador associado ao membro interno tupleMapping.
+ */
+void WiSARD::fit(const vector< vector<float> > &X, const vector<string> &y)
+{
+	checkFeatures(X);
+	clearDiscriminators();
+	partialFitRetinas(X, y);
+}
+
+/**
+ * Inicialmente, utiliza um mapa não ordenado para obter valores únicos das labels
+ * representadas pela entrada y. En seguida, cria um objeto Discriminator para cada
+ * label que ainda não possui um, e os armazena no membro interno discriminators,
+ * na posição do índice da label.
+ * Após, treina cada Discriminator com todos as entradas de X associadas à label
+ * daquele Discriminator, a partir dos endereços calculados pelo membro interno tupleMapping,
+ * somando-as ao conteúdo já existente das memórias.
+ * Caso haja um ThreadPool associado à rede, as memórias são divididas em blocos, e cada
+ * thread treina um bloco de memórias de todos os discriminadores, com todas as entradas.
+ * Como cada memória é escrita por uma única thread, na ordem das entradas, o conteúdo
+ * final é idêntico ao do treinamento serial. Nesse caso, os contadores densos são alargados
+ * antes do treinamento para comportar a quantidade de entradas de cada label; no treinamento
+ * serial, um contador só é alargado quando o seu valor deixa de caber na largura corrente.
+ */
+void WiSARD::partialFit(const vector< vector<int> > &X, const vector<string> &y)
+{
+	partialFitRetinas(X, y);
+}
+
+/**
+ * Mesmo comportamento do membro partialFit para retinas de inteiros.
+ */
+void WiSARD::partialFit(const vector<BitRetina> &X, const vector<string> &y)
+{
+	partialFitRetinas(X, y);
+}
+
+/**
+ * Mesmo comportamento do membro partialFit para retinas de inteiros, a partir das posições ativas.
+ * Os endereços dependem apenas das posições ativas, mas toda memória é treinada, no endereço zero
+ * caso não possua posição ativa.
+ */
+void WiSARD::partialFit(const vector<SparseRetina> &X, const vector<string> &y)
+{
+	checkRetinaLength(X);
+	partialFitRetinas(X, y);
+}
+
+/**
+ * Mesmo comportamento do membro partialFit para retinas de inteiros, a partir dos atributos.
+ */
+void WiSARD::partialFit(const vector< vector<float> > &X, const vector<string> &y)
+{
+	checkFeatures(X);
+	partialFitRetinas(X, y);
+}
+
+/**
+ * Cria o discriminador da label, caso ainda não exista, e o treina com uma única entrada.
+ */
+void WiSARD::train(const vector<int> &retina, const string &label)
+{
+	trainRetina(retina, label);
+}
+
+/**
+ * Mesmo comportamento do membro train para retinas de inteiros.
+ */
+void WiSARD::train(const BitRetina &retina, const string &label)
+{
+	trainRetina(retina, label);
+}
+
+/**
+ * Mesmo comportamento do membro train para retinas de inteiros, a partir das posições ativas.
+ */
+void WiSARD::train(const SparseRetina &retina, const string &label)
+{
+	checkRetinaLength(retina);
+	trainRetina(retina, label);
+}
+
+/**
+ * Mesmo comportamento do membro train para retinas de inteiros, a partir dos atributos.
+ */
+void WiSARD::train(const vector<float> &features, const string &label)
+{
+	checkFeatures(features);
+	trainRetina(features, label);
+}
+
+/**
+ * Implementação do membro train, comum aos tipos de retina.
+ */
+template<typename RetinaType>
+void WiSARD::trainRetina(const RetinaType &retina, const string &label)
+{
+	Discriminator *discriminator = discriminators[getOrCreateLabelIndex(label)];
+	LocalProfile profile;
+	clearZeroResponses();
+
+	vector<long long> addresses(tupleMapping.getNumMemories());
+	tupleMapping.computeAddresses(retina, addresses.data());
+	profile.lap(LocalProfile::ADDRESSING_NS);
+	discriminator->addTrainning(addresses.data());
+	profile.lap(LocalProfile::TRAINING_NS);
+
+	profile.count(LocalProfile::TRAINED_SAMPLES, 1);
+	profiler.add(profile);
+}
+
+/**
+ * Cria a família de hash H3 compartilhada por todas as memórias de todos os discriminadores.
+ * Gera um warning e encerra a execução caso a rede já possua discriminadores, cujas memórias
+ * foram criadas com a representação anterior.
+ */
+void WiSARD::setHashedMemories(int numHashes, int numCells, unsigned hashSeed)
+{
+	if(!discriminators.empty())
+	{
+		cout << "WARNING: hashed memories must be set before training" << endl;
+		exit(-1);
+	}
+	hash = make_shared<H3Hash>(numHashes, numCells, numBitsAddr, hashSeed);
+	bitArena.reset();
+}
+
+unsigned WiSARD::getSeed(void) const
+{
+	return seed;
+}
+
+/**
+ * Monta a sequência 0,1,2,3... até retinaLength e a embaralha com a semente, como no construtor.
+ */
+void WiSARD::setSeed(unsigned seed)
+{
+	vector<int> mapping(retinaLength);
+	iota(mapping.begin(), mapping.end(), 0);
+	shuffle(begin(mapping), end(mapping), default_random_engine(seed));
+
+	setMemoryAddressMapping(mapping);
+	randomizePositions = true;
+	this->seed = seed;
+}
+
+const vector<int> &WiSARD::getMemoryAddressMapping(void) const
+{
+	return memoryAddressMapping;
+}
+
+/**
+ * Gera um warning e encerra a execução caso a rede já possua discriminadores, cujas memórias
+ * foram treinadas com o mapeamento anterior, ou caso o mapeamento não seja uma permutação.
+ * O codificador, se houver, é mantido.
+ */
+void WiSARD::setMemoryAddressMapping(const vector<int> &memoryAddressMapping)
+{
+	if(!discriminators.empty())
+	{
+		cout << "WARNING: the input mapping must be set before training" << endl;
+		exit(-1);
+	}
+
+	vector<bool> seen(retinaLength, false);
+	bool valid = (int) memoryAddressMapping.size() == retinaLength;
+	for(int i = 0; valid && i < retinaLength; i++)
+	{
+		int position = memoryAddressMapping[i];
+		valid = position >= 0 && position < retinaLength && !seen[position];
+		if(valid)
+			seen[position] = true;
+	}
+	if(!valid)
+	{
+		cout << "WARNING: the input mapping must be a permutation of the retina positions" << endl;
+		exit(-1);
+	}
+
+	bool hasEncoder = tupleMapping.hasEncoder();
+	Encoder encoder = tupleMapping.getEncoder();
+
+	this->memoryAddressMapping = memoryAddressMapping;
+	tupleMapping = TupleMapping(retinaLength, numBitsAddr, memoryAddressMapping);
+	if(hasEncoder)
+		tupleMapping.setEncoder(encoder);
+}
+
+/**
+ * Valida a compatibilidade das redes antes de alterar qualquer discriminador. Em seguida, cria as
+ * labels ausentes e soma cada discriminador de other ao discriminador de mesma label. Caso haja um
+ * ThreadPool associado à rede, e os discriminadores não compartilhem um bloco de bits, cada
+ * discriminador é somado por uma thread.
+ */
+bool WiSARD::merge(const WiSARD &other)
+{
+	bool compatible = &other != this
+		&& retinaLength == other.retinaLength
+		&& numBitsAddr == other.numBitsAddr
+		&& isCummulative == other.isCummulative
+		&& memoryAddressMapping == other.memoryAddressMapping
+		&& (bool) hash == (bool) other.hash;
+	if(compatible && hash)
+		compatible = hash->getNumHashes() == other.hash->getNumHashes()
+			&& hash->getNumCells() == other.hash->getNumCells()
+			&& hash->getSeed() == other.hash->getSeed();
+	if(!compatible)
+	{
+		cout << "WARNING: networks with different memories can not be merged" << endl;
+		return false;
+	}
+
+	clearZeroResponses();
+	int numOtherLabels = other.getNumLabels();
+	vector<int> targets(numOtherLabels);
+	for(int c = 0; c < numOtherLabels; c++)
+		targets[c] = getOrCreateLabelIndex(other.labels[c]);
+
+	vector<char> merged(numOtherLabels, 0);
+	function<void(int, int, int)> mergeChunk = [&](int begin, int end, int thread)
+	{
+		for(int c = begin; c < end; c++)
+			merged[c] = discriminators[targets[c]]->merge(*other.discriminators[c]);
+	};
+
+	// slots of the same bit arena share bytes, so they are written by a single thread
+	if(threadPool && !bitArena)
+		threadPool->parallelFor(numOtherLabels, 1, mergeChunk);
+	else
+		mergeChunk(0, numOtherLabels, 0);
+
+	for(int c = 0; c < numOtherLabels; c++)
+	{
+		if(!merged[c])
+		{
+			cout << "WARNING: networks with different memories can not be merged" << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Cria uma rede vazia com a mesma configuração e copia o bloco de bits e cada discriminador
+ * (Discriminator::clone), com os seus blocos de contadores, de forma que nenhuma memória ou bloco
+ * é compartilhado entre as duas. A família de hash, imutável, é compartilhada. O ThreadPool não é
+ * repassado: como ThreadPool::parallelFor serializa as suas chamadas, cópias utilizadas por threads
+ * distintas deixariam de executar em paralelo.
+ */
+WiSARD *WiSARD::clone(void) const
+{
+	WiSARD *w = new WiSARD(retinaLength, numBitsAddr, useBleaching, confidenceThreshold,
+						   defaultBleaching_b, false, isCummulative, ignoreZeroAddr);
+	w->randomizePositions = randomizePositions;
+	w->seed = seed;
+	w->earlyExit = earlyExit;
+	w->memoryAddressMapping = memoryAddressMapping;
+	w->tupleMapping = tupleMapping;
+	w->hash = hash;
+	w->bitArena = bitArena ? make_shared<BitArena>(*bitArena) : shared_ptr<BitArena>();
+
+	w->labels = labels;
+	w->labelIndices = labelIndices;
+	for(size_t c = 0; c < discriminators.size(); c++)
+		w->discriminators.push_back(discriminators[c]->clone(w->bitArena));
+	return w;
+}
+
+/**
+ * Carrega os arquivos em paralelo, copiando o seu conteúdo, e os reduz em uma árvore: a cada
+ * rodada, a rede i recebe a rede i + step, para todo i múltiplo de 2 * step, e as redes somadas
+ * são deletadas. Como a soma preserva a ordem de paths, as labels ficam na mesma ordem da soma
+ * sequencial.
+ */
+WiSARD *WiSARD::reduce(const vector<string> &paths, int numThreads)
+{
+	int numShards = (int) paths.size();
+	if(numShards == 0)
+		return NULL;
+
+	ThreadPool pool(numThreads);
+	vector<WiSARD *> shards(numShards, NULL);
+	pool.parallelFor(numShards, 1, [&](int begin, int end, int thread)
+	{
+		for(int i = begin; i < end; i++)
+			shards[i] = load(paths[i], false);
+	});
+
+	bool valid = true;
+	for(int i = 0; i < numShards; i++)
+		valid = valid && shards[i] != NULL;
+
+	for(int step = 1; valid && step < numShards; step *= 2)
+	{
+		int numPairs = (numShards + 2 * step - 1) / (2 * step);
+		vector<char> merged(numPairs, 1);
+		pool.parallelFor(numPairs, 1, [&](int begin, int end, int thread)
+		{
+			for(int p = begin; p < end; p++)
+			{
+				int i = p * 2 * step;
+				if(i + step < numShards)
+					merged[p] = shards[i]->merge(*shards[i + step]);
+			}
+		});
+
+		for(int p = 0; p < numPairs; p++)
+		{
+			int i = p * 2 * step;
+			valid = valid && merged[p];
+			if(i + step < numShards)
+			{
+				delete shards[i + step];
+				shards[i + step] = NULL;
+			}
+		}
+	}
+
+	if(!valid)
+	{
+		for(int i = 0; i < numShards; i++)
+			delete shards[i];
+		return NULL;
+	}
+	return shards[0];
+}
+
+/**
+ * Repassa o codificador ao membro interno tupleMapping, que pré-calcula o intervalo de cada bit
+ * de cada tupla.
+ */
+void WiSARD::setEncoder(const Encoder &encoder)
+{
+	tupleMapping.setEncoder(encoder);
+}
+
+const Encoder &WiSARD::getEncoder(void) const
+{
+	return tupleMapping.getEncoder();
+}
+
+/**
+ * Retorna o índice da label, criando o seu discriminador caso ainda não exista.
+ * Labels novas recebem o próximo índice disponível.
+ */
+int WiSARD::getOrCreateLabelIndex(const string &label)
+{
+	unordered_map<string, int>::iterator it = labelIndices.find(label);
+	if(it != labelIndices.end())
+		return it->second;
+
+	int index = (int) labels.size();
+	labels.push_back(label);
+	labelIndices[label] = index;
+	discriminators.push_back(new Discriminator(retinaLength,
+											   numBitsAddr, 
+											   memoryAddressMapping, 
+											   isCummulative, 
+											   ignoreZeroAddr,
+											   hash,
+											   bitArena));
+	return index;
+}
+
+/**
+ * Deleta todos os discriminadores e esvazia os membros internos de labels.
+ * O bloco de bits, se houver, é substituído por um bloco vazio, sem os slots dos discriminadores deletados.
+ */
+void WiSARD::clearDiscriminators(void)
+{
+	for (int i = 0; i < (int) discriminators.size(); i++)
+	{
+		delete discriminators[i];
+	}
+	discriminators.clear();
+	labels.clear();
+	labelIndices.clear();
+	if(bitArena)
+		bitArena = createBitArena();
+	clearZeroResponses();
+}
+
+/**
+ * Retorna a quantidade de labels conhecidas pela rede.
+ */
+int WiSARD::getNumLabels(void) const
+{
+	return (int) labels.size();
+}
+
+/**
+ * Retorna as labels, na ordem de seus índices.
+ */
+const vector<string> &WiSARD::getLabels(void) const
+{
+	return labels;
+}
+
+/**
+ * Retorna o índice da label, ou -1 caso ela não seja conhecida pela rede.
+ */
+int WiSARD::getLabelIndex(const string &label) const
+{
+	unordered_map<string, int>::const_iterator it = labelIndices.find(label);
+	return (it == labelIndices.end()) ? -1 : it->second;
+}
+
+/**
+ * Implementação do membro partialFit, comum aos dois tipos de retina.
+ */
+template<typename RetinaType>
+void WiSARD::partialFitRetinas(const vector<RetinaType> &X, const vector<string> &y)
+{
+	vector<Discriminator *> sampleDiscriminators(y.size());
+	unordered_map<Discriminator *, long long> samplesPerDiscriminator;
+	for(int i=0; i < (int) y.size(); i++)
+	{
+		sampleDiscriminators[i] = discriminators[getOrCreateLabelIndex(y[i])];
+		samplesPerDiscriminator[sampleDiscriminators[i]]++;
+	}
+
+	int numMemories = tupleMapping.getNumMemories();
+	clearZeroResponses();
+
+	// each chunk of memories is trained by one thread, over all the samples
+	function<void(int, int, int)> trainChunk = [&](int memBegin, int memEnd, int thread)
+	{
+		vector<long long> addresses(numMemories);
+		LocalProfile profile;
+
+		for(int i=0; i < (int) y.size(); i++)
+		{
+			tupleMapping.computeAddresses(X[i], addresses.data(), memBegin, memEnd);
+			profile.lap(LocalProfile::ADDRESSING_NS);
+			sampleDiscriminators[i]->addTrainning(addresses.data(), memBegin, memEnd);
+			profile.lap(LocalProfile::TRAINING_NS);
+		}
+		profiler.add(profile);
+	};
+
+	if(threadPool)
+	{
+		// no counter may be widened while the threads are writing
+		for(auto it = samplesPerDiscriminator.begin(); it != samplesPerDiscriminator.end(); ++it)
+			it->first->reserveTrainings(it->second);
+		threadPool->parallelFor(numMemories, 0, trainChunk);
+	}
+	else
+	{
+		// serially, a counter is widened only when its value no longer fits
+		vector<long long> addresses(numMemories);
+		LocalProfile profile;
+
+		for(int i=0; i < (int) y.size(); i++)
+		{
+			tupleMapping.computeAddresses(X[i], addresses.data());
+			profile.lap(LocalProfile::ADDRESSING_NS);
+			sampleDiscriminators[i]->addTrainning(addresses.data());
+			profile.lap(LocalProfile::TRAINING_NS);
+		}
+		profiler.add(profile);
+	}
+
+	LocalProfile samples;
+	samples.count(LocalProfile::TRAINED_SAMPLES, (long long) y.size());
+	profiler.add(samples);
+}
+
+/**
+ * Utiliza o membro predictScores para obter a porcentagem de memórias ativadas
+ * para cada label de cada entrada e, a partir dela, cria um unordered map para cada entrada,
+ * chaveado pelas labels.
+ */
+vector<unordered_map<string, float>> WiSARD::predictProba(const vector< vector<int> > &X)
+{
+	return predictProbaRetinas(X);
+} 
+
+/**
+ * Mesmo comportamento do membro predictProba para retinas de inteiros.
+ */
+vector<unordered_map<string, float>> WiSARD::predictProba(const vector<BitRetina> &X)
+{
+	return predictProbaRetinas(X);
+}
+
+/**
+ * Mesmo comportamento do membro predictProba para retinas de inteiros, a partir das posições ativas.
+ */
+vector<unordered_map<string, float>> WiSARD::predictProba(const vector<SparseRetina> &X)
+{
+	return predictProbaRetinas(X);
+}
+
+/**
+ * Mesmo comportamento do membro predictProba para retinas de inteiros, a partir dos atributos.
+ */
+vector<unordered_map<string, float>> WiSARD::predictProba(const vector< vector<float> > &X)
+{
+	checkFeatures(X);
+	return predictProbaRetinas(X);
+}
+
+/**
+ * Implementação do membro predictProba, comum aos dois tipos de retina.
+ */
+template<typename RetinaType>
+vector<unordered_map<string, float>> WiSARD::predictProbaRetinas(const vector<RetinaType> &X)
+{
+	int numLabels = getNumLabels();
+	vector<float> scores(X.size() * numLabels);
+	scoreRetinas(X, scores.data(), NULL);
+
+	vector<unordered_map<string, float>> results(X.size());
+	for(int i = 0; i < (int) X.size(); i++)
+	{
+		for(int c = 0; c < numLabels; c++)
+			results[i][labels[c]] = scores[i * numLabels + c];
+	}
+	return results;
+}
+
+/**
+ * Para cada entrada a ser testada, calcula uma única vez os endereços de cada memória, através
+ * do membro interno tupleMapping, e obtém de todos os discriminadores da rede o conteúdo das
+ * memórias nesses endereços. É considerado que uma memória do discriminador
+ * foi ativada caso seu conteúdo endereçado possua valor maior que zero.
+ * A métrica utilizada para a avaliação do discriminador é porcentagem de memórias ativadas,
+ * escrita em scores[i * getNumLabels() + c] para a entrada i e a label de índice c.
+ * Caso o membro interno "useBleaching" seja verdadeiro, aplica o bleaching sobre as porcentagens.
+ */
+void WiSARD::predictScores(const vector< vector<int> > &X, float *scores)
+{
+	scoreRetinas(X, scores, NULL);
+}
+
+/**
+ * Mesmo comportamento do membro predictScores para retinas de inteiros.
+ */
+void WiSARD::predictScores(const vector<BitRetina> &X, float *scores)
+{
+	scoreRetinas(X, scores, NULL);
+}
+
+/**
+ * Mesmo comportamento do membro predictScores para retinas de inteiros, a partir das posições ativas.
+ */
+void WiSARD::predictScores(const vector<SparseRetina> &X, float *scores)
+{
+	scoreRetinas(X, scores, NULL);
+}
+
+/**
+ * Mesmo comportamento do membro predictScores para retinas de inteiros, a partir dos atributos.
+ */
+void WiSARD::predictScores(const vector< vector<float> > &X, float *scores)
+{
+	checkFeatures(X);
+	scoreRetinas(X, scores, NULL);
+}
+
+/**
+ * Seleciona, para cada entrada, a label que obteve maior porcentagem de memórias ativadas
+ * e a converte para string.
+ */
+vector<string> WiSARD::predict(const vector< vector<int> > &X)
+{
+	return labelsFromIndices(predictLabelIndices(X));
+}
+
+/**
+ * Mesmo comportamento do membro predict para retinas de inteiros.
+ */
+vector<string> WiSARD::predict(const vector<BitRetina> &X)
+{
+	return labelsFromIndices(predictLabelIndices(X));
+}
+
+/**
+ * Mesmo comportamento do membro predict para retinas de inteiros, a partir das posições ativas.
+ */
+vector<string> WiSARD::predict(const vector<SparseRetina> &X)
+{
+	return labelsFromIndices(predictLabelIndices(X));
+}
+
+/**
+ * Mesmo comportamento do membro predict para retinas de inteiros, a partir dos atributos.
+ */
+vector<string> WiSARD::predict(const vector< vector<float> > &X)
+{
+	return labelsFromIndices(predictLabelIndices(X));
+}
+
+/**
+ * Seleciona, para cada entrada, o índice da label que obteve maior porcentagem de memórias
+ * ativadas. As porcentagens de cada entrada são calculadas em um vetor temporário, sem que
+ * a matriz completa de porcentagens seja criada.
+ */
+vector<int> WiSARD::predictLabelIndices(const vector< vector<int> > &X)
+{
+	vector<int> result(X.size());
+	scoreRetinas(X, NULL, result.data());
+	return result;
+}
+
+/**
+ * Mesmo comportamento do membro predictLabelIndices para retinas de inteiros.
+ */
+vector<int> WiSARD::predictLabelIndices(const vector<BitRetina> &X)
+{
+	vector<int> result(X.size());
+	scoreRetinas(X, NULL, result.data());
+	return result;
+}
+
+/**
+ * Mesmo comportamento do membro predictLabelIndices para retinas de inteiros, a partir das posições ativas.
+ */
+vector<int> WiSARD::predictLabelIndices(const vector<SparseRetina> &X)
+{
+	vector<int> result(X.size());
+	scoreRetinas(X, NULL, result.data());
+	return result;
+}
+
+/**
+ * Mesmo comportamento do membro predictLabelIndices para retinas de inteiros, a partir dos atributos.
+ */
+vector<int> WiSARD::predictLabelIndices(const vector< vector<float> > &X)
+{
+	checkFeatures(X);
+	vector<int> result(X.size());
+	scoreRetinas(X, NULL, result.data());
+	return result;
+}
+
+void WiSARD::checkFeatures(const vector< vector<float> > &X) const
+{
+	for(size_t i = 0; i < X.size(); i++)
+		checkFeatures(X[i]);
+}
+
+/**
+ * O endereçamento lê diretamente o atributo de cada bit, sem verificar o tamanho da entrada.
+ */
+void WiSARD::checkFeatures(const vector<float> &features) const
+{
+	if(!tupleMapping.hasEncoder())
+	{
+		cout << "WARNING: no encoder to address numeric features" << endl;
+		exit(-1);
+	}
+	if((int) features.size() < tupleMapping.getEncoder().getNumFeatures())
+	{
+		cout << "WARNING: input has " << features.size() << " features, the encoder uses "
+			 << tupleMapping.getEncoder().getNumFeatures() << endl;
+		exit(-1);
+	}
+}
+
+void WiSARD::checkRetinaLength(const vector<SparseRetina> &X) const
+{
+	for(size_t i = 0; i < X.size(); i++)
+		checkRetinaLength(X[i]);
 }
 
-/**
- * Deleta dinâmicamente todos os objetos "discriminators"
- * associados a WiSARD criada.
- */
-WiSARD::~WiSARD(void)
+void WiSARD::checkRetinaLength(const SparseRetina &retina) const
 {
-	for (auto it = discriminators.begin(); it != discriminators.end(); ++it )
+	if(retina.size() != retinaLength)
 	{
-		delete it->second;
+		cout << "WARNING: sparse retina length (" << retina.size()
+			 << ") differs from the retina length (" << retinaLength << ")" << endl;
+		exit(-1);
 	}
 }
 
 /**
- * Inicialmente, utiliza um mapa não ordenado para obter valores únicos das labels
- * representadas pela entrada y. En seguida, cria um objeto Discriminator para cada
- * label e os armazena no membro interno discriminators.
- * Após, treina cada Discriminator com todos as entradas de X associadas à label
- * daquele Discriminator.
+ * Converte índices de labels em labels. O índice -1 (rede sem labels) é convertido na string vazia.
  */
-void WiSARD::fit(const vector< vector<int> > &X, const vector<string> &y)
+vector<string> WiSARD::labelsFromIndices(const vector<int> &indices) const
 {
-	vector<string> labels;
-	unordered_map <string, int> auxMap ;
-	for(int i = 0; i < y.size(); i++)
+	vector<string> vecRes(indices.size());
+
+	for(int i=0; i< (int) indices.size(); i++)
 	{
-		auxMap[y[i]] = 0; 
+		if(indices[i] >= 0)
+			vecRes[i] = labels[indices[i]];
 	}
-	for(auto it = auxMap.begin(); it != auxMap.end(); ++it)
+
+	return vecRes;
+}
+
+/**
+ * Implementação comum dos membros predictScores e predictLabelIndices.
+ * Caso haja um ThreadPool associado à rede, as entradas são divididas em blocos
+ * processados em paralelo; cada resultado é escrito na posição de sua entrada,
+ * preservando a ordem de X.
+ */
+template<typename RetinaType>
+void WiSARD::scoreRetinas(const vector<RetinaType> &X, float *scores, int *labelIndices)
+{
+	int numLabels = getNumLabels();
+
+	function<void(int, int, int)> predictChunk = [&](int begin, int end, int thread)
 	{
-		labels.push_back(it->first);
-	}
+		ScoringBuffers buffers(tupleMapping.getNumMemories());
+		vector<float> rowScores(numLabels);
+
+		//for each retina
+		for(int i = begin; i < end; i++)
+		{
+			float *row = (scores != NULL) ? scores + (size_t) i * numLabels : rowScores.data();
+
+			// the addresses are the same for every discriminator
+			tupleMapping.computeAddresses(X[i], buffers.addresses.data());
+			buffers.profile.lap(LocalProfile::ADDRESSING_NS);
+
+			// only the label is needed: the evaluation may stop before every memory is read
+			if(scores == NULL && earlyExit)
+			{
+				labelIndices[i] = predictEarlyExit(row, buffers);
+				continue;
+			}
+
+			scoreAddresses(row, buffers);
+
+			if(labelIndices != NULL)
+				labelIndices[i] = util::argMax(row, numLabels);
+		}
+
+		buffers.profile.count(LocalProfile::PREDICTED_SAMPLES, end - begin);
+		profiler.add(buffers.profile);
+	};
+
+	if(threadPool)
+		threadPool->parallelFor((int) X.size(), 0, predictChunk);
+	else
+		predictChunk(0, (int) X.size(), 0);
+} 
 
-	for(int i = 0; i < labels.size(); i++ )
+/**
+ * Os endereços de uma memória sem posição ativa são zero, de forma que o seu conteúdo é o
+ * do endereço zero, lido uma única vez após o treinamento (getZeroResponses).
+ * O membro buffers.responses é iniciado com o conteúdo no endereço zero de todas as memórias;
+ * para cada entrada, apenas as memórias com alguma posição ativa são endereçadas e lidas, e a
+ * quantidade de memórias ativadas de cada label é corrigida a partir da quantidade no endereço
+ * zero. Ao final da entrada, essas memórias voltam ao endereço zero e ao seu conteúdo, e o custo
+ * de cada entrada é proporcional à quantidade de posições ativas (exceto pelo bleaching, que
+ * percorre o conteúdo de todas as memórias). O resultado é o mesmo das retinas de inteiros.
+ */
+void WiSARD::scoreRetinas(const vector<SparseRetina> &X, float *scores, int *labelIndices)
+{
+	checkRetinaLength(X);
+
+	int numLabels = getNumLabels();
+	int numMemories = tupleMapping.getNumMemories();
+	shared_ptr<const ZeroResponses> zero = getZeroResponses();
+
+	function<void(int, int, int)> predictChunk = [&](int begin, int end, int thread)
 	{
-		string label = labels[i];
-	
-		Discriminator *d = new Discriminator(retinaLength,
-											 numBitsAddr, 
-											 memoryAddressMapping, 
-											 isCummulative, 
-											 ignoreZeroAddr);
-		discriminators[label] = d;
-	}	
+		ScoringBuffers buffers(numMemories);
+		vector<float> rowScores(numLabels);
+		buffers.responses = zero->responses;
+		buffers.touched.resize(numMemories);
+		buffers.activeCounts.resize(numLabels);
+		long long *addresses = buffers.addresses.data();
+		int *touched = buffers.touched.data();
+
+		for(int i = begin; i < end; i++)
+		{
+			float *row = (scores != NULL) ? scores + (size_t) i * numLabels : rowScores.data();
+
+			int numTouched = tupleMapping.computeTouchedAddresses(X[i], addresses, touched);
+			buffers.profile.lap(LocalProfile::ADDRESSING_NS);
+
+			for(int c = 0; c < numLabels; c++)
+			{
+				int *responses = buffers.responses.data() + (size_t) c * numMemories;
+				const int *zeroRow = zero->responses.data() + (size_t) c * numMemories;
+				discriminators[c]->predict(addresses, responses, touched, numTouched);
+
+				int count = zero->activeCounts[c];
+				for(int k = 0; k < numTouched; k++)
+					count += (responses[touched[k]] > 0) - (zeroRow[touched[k]] > 0);
+				buffers.activeCounts[c] = count;
+			}
+			buffers.profile.lap(LocalProfile::LOOKUP_NS);
+
+			for(int c = 0; c < numLabels; c++)
+				row[c] = (float) buffers.activeCounts[c] / (float) numMemories;
+			if(useBleaching)
+				applyBleaching(row, buffers, buffers.responses.data(), getScoringOptions());
+			if(labelIndices != NULL)
+				labelIndices[i] = util::argMax(row, numLabels);
+			buffers.profile.lap(LocalProfile::SCORING_NS);
+
+			// back to the all-zero address for the next input
+			for(int c = 0; c < numLabels; c++)
+			{
+				int *responses = buffers.responses.data() + (size_t) c * numMemories;
+				const int *zeroRow = zero->responses.data() + (size_t) c * numMemories;
+				for(int k = 0; k < numTouched; k++)
+					responses[touched[k]] = zeroRow[touched[k]];
+			}
+			for(int k = 0; k < numTouched; k++)
+				addresses[touched[k]] = 0;
+		}
+
+		buffers.profile.count(LocalProfile::PREDICTED_SAMPLES, end - begin);
+		profiler.add(buffers.profile);
+	};
+
+	if(threadPool)
+		threadPool->parallelFor((int) X.size(), 0, predictChunk);
+	else
+		predictChunk(0, (int) X.size(), 0);
+}
+
+/**
+ * A leitura é feita por um único chamador; predições concorrentes aguardam e compartilham o resultado.
+ */
+shared_ptr<const WiSARD::ZeroResponses> WiSARD::getZeroResponses(void) const
+{
+	lock_guard<mutex> lock(zeroResponsesMutex);
+	if(zeroResponses)
+		return zeroResponses;
+
+	int numLabels = getNumLabels();
+	int numMemories = tupleMapping.getNumMemories();
+	vector<long long> addresses(numMemories, 0LL);
 
-	for(int i=0; i < y.size(); i++)
+	shared_ptr<ZeroResponses> zero = make_shared<ZeroResponses>();
+	zero->responses.resize((size_t) numLabels * numMemories);
+	zero->activeCounts.resize(numLabels);
+	for(int c = 0; c < numLabels; c++)
 	{
-		string label = y[i];
-		discriminators[label]->addTrainning(X[i]);
-	}	
+		int *row = zero->responses.data() + (size_t) c * numMemories;
+		discriminators[c]->predict(addresses.data(), row);
+		zero->activeCounts[c] = util::countGreater(row, numMemories, 0);
+	}
+
+	zeroResponses = zero;
+	return zeroResponses;
 }
 
 /**
- * Para cada entrada a ser testada, chama o método predict de todos os discriminadores
- * da rede. Este, retorna um vetor com os conteúdos das posições de memória associadas
- * àquela entrada, por aquele discriminador. É considerado que uma memória do discriminador
- * foi ativada caso seu conteúdo endereçado possua valor maior que zero.
- * A métrica utilizada para a avaliação do discriminador é porcentagem de memórias ativadas.
- * Obtendo esta quantidade, é criado um unordered map, result, contendo a porcentagem de memórias
- * ativadas para cada label em relação à retina selecionada.
- * Caso o membro interno "useBleaching" seja verdadeiro, chama o método applyBleaching sobre o result.
- * Em seguida, este result é adicionado ao vetor de resultados a ser retornado.
+ * Predições em andamento mantêm o conteúdo anterior, mas a rede não deve ser treinada durante predições.
  */
-vector<unordered_map<string, float>> WiSARD::predictProba(const vector< vector<int> > &X)
+void WiSARD::clearZeroResponses(void)
+{
+	lock_guard<mutex> lock(zeroResponsesMutex);
+	zeroResponses.reset();
+}
+
+/**
+ * Aloca o vetor de endereços; os demais vetores são dimensionados no primeiro uso.
+ */
+WiSARD::ScoringBuffers::ScoringBuffers(int numMemories)
+:addresses(numMemories)
+{
+}
+
+/**
+ * Obtém de todos os discriminadores o conteúdo das memórias nos endereços em buffers.addresses
+ * e calcula as porcentagens com os parâmetros da própria rede.
+ */
+void WiSARD::scoreAddresses(float *scores, ScoringBuffers &buffers) const
 {
-	vector<unordered_map<string, float>> results;
-	int numMemories =  (int) ceil( (float)retinaLength/ (float) numBitsAddr );
+	fetchResponses(buffers);
+	buffers.profile.lap(LocalProfile::LOOKUP_NS);
+	scoreResponses(scores, buffers, getScoringOptions());
+	buffers.profile.lap(LocalProfile::SCORING_NS);
+}
+
+/**
+ * O conteúdo das memórias do discriminador de índice c é escrito em
+ * buffers.responses[c * numMemories ... (c + 1) * numMemories - 1].
+ * Quando todas as memórias estão no bloco de bits, os bits de todas as labels para o endereço
+ * de uma memória são obtidos em uma única leitura, e distribuídos entre as labels.
+ */
+void WiSARD::fetchResponses(ScoringBuffers &buffers) const
+{
+	int numMemories = tupleMapping.getNumMemories();
+	int numLabels = getNumLabels();
+	buffers.responses.resize((size_t) numLabels * numMemories);
 
-	//for each retina
-	for(int i=0; i < X.size(); i++)
+	if(usesBitSlots())
 	{
-		string label;
+		int *responses = buffers.responses.data();
+		for(int i = 0; i < numMemories; i++)
+		{
+			long long addr = buffers.addresses[i];
+			const uint8_t *slots = bitArena->getSlots(i, addr);
+			bool ignored = ignoreZeroAddr && addr == 0;
+
+			for(int c = 0; c < numLabels; c++)
+				responses[(size_t) c * numMemories + i] = ignored ? 0 : (slots[c >> 3] >> (c & 7)) & 1;
+		}
+		return;
+	}
+
+	for (int c = 0; c < numLabels; c++)
+		discriminators[c]->predict(buffers.addresses.data(), buffers.responses.data() + (size_t) c * numMemories);
+}
+
+/**
+ * As memórias são lidas em blocos de EARLY_EXIT_BLOCK, na ordem das tuplas, e a quantidade de memórias
+ * ativadas de cada label é acumulada; após cada bloco, a quantidade final de uma label está entre o seu
+ * valor atual e esse valor somado às memórias restantes.
+ * Sem bleaching (ou com confidenceThreshold não positivo, quando o bleaching nunca é aplicado), a label
+ * selecionada é a de maior quantidade, com empates resolvidos pelo maior índice, como em util::argMax:
+ * uma label deixa de ser lida quando nem o seu limite superior alcança a líder, e a predição termina
+ * quando resta uma única label.
+ * Com bleaching, qualquer label pode vencer após o bleaching, e nenhuma é descartada; a predição
+ * termina quando a confiança calculada com o limite inferior da líder e o maior limite superior das
+ * demais atinge confidenceThreshold, pois nesse caso applyBleaching não alteraria as porcentagens.
+ * Caso contrário, todas as memórias são lidas e o resultado é o da avaliação completa.
+ */
+int WiSARD::predictEarlyExit(float *scores, ScoringBuffers &buffers) const
+{
+	static const int EARLY_EXIT_BLOCK = 16;
 
-		unordered_map<string, float> result;
-		unordered_map<string, vector<int>> memoryResult;
+	int numMemories = tupleMapping.getNumMemories();
+	int numLabels = getNumLabels();
+	if(numLabels == 0)
+		return -1;
 
-		Discriminator *auxDisc;
-		vector<int> memoryResultAux;
+	bool pruning = !useBleaching || confidenceThreshold <= 0;
+	buffers.responses.resize((size_t) numLabels * numMemories);
+	buffers.activeCounts.assign(numLabels, 0);
+	buffers.candidates.resize(numLabels);
+	for(int c = 0; c < numLabels; c++)
+		buffers.candidates[c] = c;
 
-		//getting a retina
-		vector<int> retina = X[i];
+	int *responses = buffers.responses.data();
+	int *counts = buffers.activeCounts.data();
+	int leader = numLabels - 1;
 
-		// for each discriminator
-		for (auto it = discriminators.begin(); it != discriminators.end(); ++it )
+	for(int memBegin = 0; memBegin < numMemories; memBegin += EARLY_EXIT_BLOCK)
+	{
+		int memEnd = min(memBegin + EARLY_EXIT_BLOCK, numMemories);
+		int remaining = numMemories - memEnd;
+
+		// candidates are in increasing order, so ties go to the largest index
+		leader = -1;
+		for(size_t k = 0; k < buffers.candidates.size(); k++)
 		{
-			label = it->first;
-			auxDisc = it->second;
+			int c = buffers.candidates[k];
+			int *row = responses + (size_t) c * numMemories;
+			discriminators[c]->predict(buffers.addresses.data(), row, memBegin, memEnd);
+			counts[c] += util::countGreater(row + memBegin, memEnd - memBegin, 0);
 
-			memoryResultAux = auxDisc->predict(retina);
-		
-			int sumMemoriesValue = 0;
-			for(int i = 0; i < memoryResultAux.size(); i++)
+			if(leader < 0 || counts[c] >= counts[leader])
+				leader = c;
+		}
+
+		if(pruning)
+		{
+			size_t numAlive = 0;
+			for(size_t k = 0; k < buffers.candidates.size(); k++)
 			{
-				if(memoryResultAux[i] > 0)
-					sumMemoriesValue += 1;
+				int c = buffers.candidates[k];
+				int bound = counts[c] + remaining;
+				if(c == leader || bound > counts[leader] || (bound == counts[leader] && c > leader))
+					buffers.candidates[numAlive++] = c;
 			}
+			buffers.candidates.resize(numAlive);
 
-			// to calc probability, what percentage of memories recognize the element;
-			result[label] = (float)sumMemoriesValue / (float)numMemories;
-			memoryResult[label] = memoryResultAux;
+			if(numAlive == 1)
+			{
+				buffers.profile.lap(LocalProfile::LOOKUP_NS);
+				return leader;
+			}
 		}
-		
+		else if(counts[leader] > 0)
+		{
+			int otherBound = 0;
+			for(int c = 0; c < numLabels; c++)
+			{
+				if(c != leader)
+					otherBound = max(otherBound, counts[c] + remaining);
+			}
 
-		if(useBleaching)
-			result = WiSARD::applyBleaching(result, memoryResult);
+			// same computation as util::calculateConfidence, on the worst case scores
+			float maxScore = (float) counts[leader] / (float) numMemories;
+			float secondScore = (float) otherBound / (float) numMemories;
+			float confidence = 1.0 - (secondScore / maxScore);
+			if(otherBound < counts[leader] && !(confidence < confidenceThreshold))
+			{
+				buffers.profile.lap(LocalProfile::LOOKUP_NS);
+				return leader;
+			}
+		}
+	}
+	buffers.profile.lap(LocalProfile::LOOKUP_NS);
+	if(pruning)
+		return leader;
 
-		results.push_back(result);
-	}	
+	// every memory was read: same result as the complete evaluation
+	for(int c = 0; c < numLabels; c++)
+		scores[c] = (float) counts[c] / (float) numMemories;
+	applyBleaching(scores, buffers, responses, getScoringOptions());
+	buffers.profile.lap(LocalProfile::SCORING_NS);
+	return util::argMax(scores, numLabels);
+}
 
-	return results;
-} 
+/**
+ * Os slots são criados na ordem dos índices das labels, mas um discriminador cujas memórias
+ * não cabem no bloco não possui todas elas no seu slot.
+ */
+bool WiSARD::usesBitSlots(void) const
+{
+	if(!bitArena || bitArena->getNumSlots() != getNumLabels())
+		return false;
+	for(int c = 0; c < getNumLabels(); c++)
+	{
+		if(discriminators[c]->getBitSlot() != c)
+			return false;
+	}
+	return true;
+}
 
 /**
- * Utiliza o membro predictProba para receber uma unordered_map contendo a porcentagem
- * de memórias ativadas para cada label de uma linha do vetor de entrada.
- * Em seguida, seleciona a label que obteve maior porcentagem de memórias ativadas.
- * Após, adiciona esta label ao vetor a ser retornado, de predições.
+ * Para cada discriminador, calcula a porcentagem de memórias cujo conteúdo é maior que zero.
+ * Caso options omita o primeiro endereço e a rede não o faça, o conteúdo das memórias cujo endereço
+ * é zero é considerado nulo, como se a rede tivesse sido criada com ignoreZeroAddr.
+ * Caso options utilize bleaching, aplica o bleaching sobre as porcentagens.
  */
-vector<string> WiSARD::predict(const vector< vector<int> > &X)
+void WiSARD::scoreResponses(float *scores, ScoringBuffers &buffers, const ScoringOptions &options) const
 {
-	vector<string> vecRes;
-	vector<unordered_map<string, float>>  results = WiSARD::predictProba(X);
+	int numMemories = tupleMapping.getNumMemories();
+	int numLabels = getNumLabels();
+	const int *responses = buffers.responses.data();
 
-	for(int i=0; i< results.size(); i++)
+	if(options.ignoreZeroAddr && !ignoreZeroAddr)
 	{
-		unordered_map<string, float> result = results[i];
-		string resultLabel = util::argMax(result);
+		buffers.maskedResponses.assign(buffers.responses.begin(), buffers.responses.end());
+		for(int i = 0; i < numMemories; i++)
+		{
+			if(buffers.addresses[i] != 0)
+				continue;
+			for(int c = 0; c < numLabels; c++)
+				buffers.maskedResponses[(size_t) c * numMemories + i] = 0;
+		}
+		responses = buffers.maskedResponses.data();
+	}
 
+	// activated memories of each discriminator
+	buffers.activeCounts.resize(numLabels);
+	util::countGreater(responses, numLabels, numMemories, 0, buffers.activeCounts.data());
 
-		vecRes.push_back(resultLabel);
+	// for each discriminator
+	for (int c = 0; c < numLabels; c++)
+	{
+		// to calc probability, what percentage of memories recognize the element;
+		scores[c] = (float)buffers.activeCounts[c] / (float)numMemories;
 	}
 
-	return vecRes;
+	if(options.useBleaching)
+		applyBleaching(scores, buffers, responses, options);
+}
+
+/**
+ * Retorna os parâmetros de cálculo das porcentagens utilizados pela rede.
+ */
+WiSARD::ScoringOptions WiSARD::getScoringOptions(void) const
+{
+	ScoringOptions options;
+	options.useBleaching = useBleaching;
+	options.confidenceThreshold = confidenceThreshold;
+	options.defaultBleaching_b = defaultBleaching_b;
+	options.ignoreZeroAddr = ignoreZeroAddr;
+	return options;
+}
+
+/**
+ * Apenas os membros que retornam somente as labels são afetados.
+ */
+void WiSARD::setEarlyExit(bool earlyExit)
+{
+	this->earlyExit = earlyExit;
+}
+
+/**
+ * Retorna verdadeiro caso a interrupção antecipada esteja ativa.
+ */
+bool WiSARD::getEarlyExit(void) const
+{
+	return earlyExit;
+}
+
+/**
+ * Para cada entrada, calcula os endereços e lê o conteúdo das memórias uma única vez;
+ * em seguida, calcula as porcentagens e seleciona a label para cada conjunto de parâmetros.
+ */
+void WiSARD::predictLabelIndices(const vector< vector<int> > &X, const vector<ScoringOptions> &options, int *labelIndices)
+{
+	scoreRetinasOptions(X, options, labelIndices);
+}
+
+/**
+ * Mesmo comportamento do membro predictLabelIndices com vários parâmetros para retinas de inteiros.
+ */
+void WiSARD::predictLabelIndices(const vector<BitRetina> &X, const vector<ScoringOptions> &options, int *labelIndices)
+{
+	scoreRetinasOptions(X, options, labelIndices);
+}
+
+/**
+ * Implementação do membro predictLabelIndices com vários conjuntos de parâmetros.
+ * Caso haja um ThreadPool associado à rede, as entradas são divididas em blocos processados em paralelo.
+ */
+template<typename RetinaType>
+void WiSARD::scoreRetinasOptions(const vector<RetinaType> &X, const vector<ScoringOptions> &options, int *labelIndices)
+{
+	int numLabels = getNumLabels();
+	size_t numOptions = options.size();
+
+	function<void(int, int, int)> predictChunk = [&](int begin, int end, int thread)
+	{
+		ScoringBuffers buffers(tupleMapping.getNumMemories());
+		vector<float> rowScores(numLabels);
+
+		for(int i = begin; i < end; i++)
+		{
+			tupleMapping.computeAddresses(X[i], buffers.addresses.data());
+			buffers.profile.lap(LocalProfile::ADDRESSING_NS);
+			fetchResponses(buffers);
+			buffers.profile.lap(LocalProfile::LOOKUP_NS);
+
+			for(size_t k = 0; k < numOptions; k++)
+			{
+				scoreResponses(rowScores.data(), buffers, options[k]);
+				labelIndices[i * numOptions + k] = util::argMax(rowScores.data(), numLabels);
+			}
+			buffers.profile.lap(LocalProfile::SCORING_NS);
+		}
+
+		buffers.profile.count(LocalProfile::PREDICTED_SAMPLES, end - begin);
+		profiler.add(buffers.profile);
+	};
+
+	if(threadPool)
+		threadPool->parallelFor((int) X.size(), 0, predictChunk);
+	else
+		predictChunk(0, (int) X.size(), 0);
+}
+
+/**
+ * Descarta o ThreadPool atual e, caso numThreads seja diferente de 1, cria um novo
+ * ThreadPool, de uso exclusivo da rede.
+ */
+void WiSARD::setNumThreads(int numThreads)
+{
+	threadPool.reset();
+	if(numThreads != 1)
+		threadPool = make_shared<ThreadPool>(numThreads);
+}
+
+/**
+ * Passa a utilizar o ThreadPool recebido, que pode ser compartilhado com outras redes.
+ */
+void WiSARD::setThreadPool(shared_ptr<ThreadPool> threadPool)
+{
+	this->threadPool = threadPool;
+}
+
+/**
+ * Retorna a quantidade de threads do ThreadPool associado, ou 1 caso não haja.
+ */
+int WiSARD::getNumThreads(void) const
+{
+	return threadPool ? threadPool->getNumThreads() : 1;
+}
+
+shared_ptr<ThreadPool> WiSARD::getThreadPool(void) const
+{
+	return threadPool;
 }
+
 /**
- * Carrega o valor defaultBleaching_b em uma variável interna b. Em seguida, entra em um loop.
- * Nele, realiza o mesmo cálculo que é feito no membro predictProba, com a diferença de que agora as memórias
+ * Se a confiança das porcentagens recebidas já atinge options.confidenceThreshold, retorna sem
+ * percorrer o conteúdo de nenhuma label nem copiar as porcentagens.
+ * Caso contrário, carrega o valor options.defaultBleaching_b em uma variável interna b. Em seguida, entra em um loop.
+ * Nele, realiza o mesmo cálculo que é feito no membro scoreAddresses, com a diferença de que agora as memórias
  * consideradas como ativadas são aquelas cujo conteúdo é maior que b.
- * O membro ficará em loop enquanto a confiança for menor que o membro interno confidenceThresold.
- * A cada loop, o bleaching, representado por b, é incrementado em uma unidade.
+ * O membro ficará em loop enquanto a confiança for menor que options.confidenceThreshold.
  * Se o maior resultado das porcentagens das memórias for muito próximo de zero,
- * para algum dado bleaching no loop, para o loop e retorna o valor inicial sem bleaching
+ * para algum dado bleaching no loop, para o loop e mantém as porcentagens sem bleaching
  * aplicado.
+ * A quantidade de memórias com conteúdo maior que b, e o menor desses conteúdos, são obtidos
+ * em uma única passada vetorizada (util::countGreater) sobre o conteúdo de cada label. Como as
+ * porcentagens só mudam quando b alcança algum dos conteúdos, a cada loop b avança diretamente
+ * para o menor conteúdo maior que b, com o mesmo resultado de incrementá-lo de uma em uma unidade.
  */
-unordered_map<string, float> WiSARD::applyBleaching(unordered_map<string, float> &result,  unordered_map<string, vector<int>> &memoryResult)
+void WiSARD::applyBleaching(float *scores, ScoringBuffers &buffers, const int *responses, const ScoringOptions &options) const
 {
-	unordered_map<string, float> resultFinal = result;
+	int numMemories = tupleMapping.getNumMemories();
+	int numLabels = getNumLabels();
 
-	//apply bleaching
-	vector<int> labelResult;
-	string label;
-	int b = defaultBleaching_b;
-	int numMemories = (int) ceil( (float)retinaLength/ (float) numBitsAddr );
-	
+	float confidence = util::calculateConfidence(scores, numLabels);
 
-	float confidence = util::calculateConfidence(resultFinal);
+	// confident enough: no label is counted again
+	if(confidence >= options.confidenceThreshold)
+		return;
+	buffers.profile.count(LocalProfile::BLEACHING_CALLS, 1);
 
-	while(confidence < confidenceThreshold)
+	vector<float> &resultFinal = buffers.bleachedScores;
+	resultFinal.assign(scores, scores + numLabels);
+
+	//apply bleaching
+	int b = options.defaultBleaching_b;
+
+	while(confidence < options.confidenceThreshold)
 	{
+		int nextB = INT_MAX;
+		buffers.profile.count(LocalProfile::BLEACHING_ITERATIONS, 1);
 
-		for(auto it = resultFinal.begin(); it != resultFinal.end(); ++it )
+		for(int c = 0; c < numLabels; c++)
 		{
-			label = it->first;
-			int sumMemoriesValue = 0;
-		
-			labelResult = memoryResult[label];
+			int minAbove;
+			int numAbove = util::countGreater(responses + (size_t) c * numMemories, numMemories, b, &minAbove);
 
-			for(int i = 0; i < labelResult.size(); i++)
-			{
-				if(labelResult[i] > b)
-					sumMemoriesValue += 1;
-			}
+			resultFinal[c] = ((float) numAbove / (float) numMemories);
 
-			resultFinal[label] = ((float) sumMemoriesValue / (float) numMemories);
+			// the percentages only change when b reaches the next memory content
+			if(numAbove > 0 && minAbove < nextB)
+				nextB = minAbove;
 		}
 
-		// if no memory recognize the pattern, return previous value
-		float maxValue = util::maxValue(resultFinal);
+		// if no memory recognize the pattern, keep the previous value
+		float maxValue = util::maxValue(resultFinal.data(), numLabels);
 		
 		if(maxValue <= 0.000001)  // if is zero
-		{	
-			resultFinal = result;
-			break;
-		}
+			return;
 
-		b ++;
-		confidence = util::calculateConfidence(resultFinal);
+		b = nextB;
+		confidence = util::calculateConfidence(resultFinal.data(), numLabels);
 	}
 	
-	return resultFinal;
+	copy(resultFinal.begin(), resultFinal.end(), scores);
+}
+
+/**
+ * Reúne a ocupação de cada discriminador, na ordem dos índices das labels, e soma os bytes do bloco de bits.
+ */
+WiSARDStats WiSARD::getStats(void) const
+{
+	WiSARDStats stats;
+	stats.numMemories = tupleMapping.getNumMemories();
+	stats.bytes = 0;
+	stats.histogram.assign(MemoryStats::HISTOGRAM_BUCKETS, 0);
+
+	for(size_t c = 0; c < discriminators.size(); c++)
+	{
+		stats.discriminators.push_back(discriminators[c]->getStats());
+		const DiscriminatorStats &discriminator = stats.discriminators.back();
+
+		stats.bytes += discriminator.bytes;
+		for(int k = 0; k < MemoryStats::HISTOGRAM_BUCKETS; k++)
+			stats.histogram[k] += discriminator.histogram[k];
+	}
+	if(bitArena)
+		stats.bytes += bitArena->getBytes();
+	return stats;
+}
+
+RuntimeProfile WiSARD::getProfile(void) const
+{
+	return profiler.snapshot();
+}
+
+void WiSARD::resetProfile(void)
+{
+	profiler.reset();
+}
+
+/** Identificador do início de um arquivo de modelo.*/
+static const char MODEL_MAGIC[8] = {'W','A','N','N','M','O','D','L'};
+/** Versão do formato do arquivo de modelo.*/
+static const uint32_t MODEL_VERSION = 3;
+/** Valor utilizado para detectar arquivos gravados com outra ordem de bytes.*/
+static const uint32_t MODEL_BYTE_ORDER = 0x01020304;
+
+/**
+ * Formato (versão 3, na ordem de bytes da máquina): identificador, versão, marcador de ordem
+ * de bytes, hiperparâmetros, semente, configuração das memórias com hash (flag seguida, caso haja,
+ * da quantidade de funções, de células e da semente), flag do bloco de bits, memoryAddressMapping,
+ * quantidade de labels, para cada label na ordem de seus índices, a label seguida do seu discriminador
+ * e, por fim, o bloco de bits, caso haja.
+ * As versões 1, sem a configuração de hash, e 2, sem o bloco de bits, continuam sendo lidas por load.
+ * O arquivo de destino só é substituído ao final (ModelWriter::commit), de forma que esta ou outra
+ * rede carregada do mesmo caminho com useMmap continua válida.
+ * Retorna falso e gera um warning caso o arquivo não possa ser escrito.
+ */
+bool WiSARD::save(const string &path) const
+{
+	ModelWriter writer(path);
+
+	writer.writeBytes(MODEL_MAGIC, sizeof(MODEL_MAGIC));
+	writer.write(MODEL_VERSION);
+	writer.write(MODEL_BYTE_ORDER);
+
+	writer.write((int32_t) retinaLength);
+	writer.write((int32_t) numBitsAddr);
+	writer.write((uint8_t) useBleaching);
+	writer.write((float) confidenceThreshold);
+	writer.write((int32_t) defaultBleaching_b);
+	writer.write((uint8_t) randomizePositions);
+	writer.write((uint8_t) isCummulative);
+	writer.write((uint8_t) ignoreZeroAddr);
+	writer.write((uint32_t) seed);
+	writer.write((uint8_t) (hash ? 1 : 0));
+	if(hash)
+	{
+		writer.write((int32_t) hash->getNumHashes());
+		writer.write((int32_t) hash->getNumCells());
+		writer.write((uint32_t) hash->getSeed());
+	}
+	writer.write((uint8_t) (bitArena ? 1 : 0));
+	for(int i = 0; i < retinaLength; i++)
+		writer.write((int32_t) memoryAddressMapping[i]);
+
+	writer.write((uint32_t) labels.size());
+	for(size_t i = 0; i < labels.size(); i++)
+	{
+		writer.writeString(labels[i]);
+		discriminators[i]->write(writer);
+	}
+	if(bitArena)
+		bitArena->write(writer);
+
+	if(!writer.commit())
+	{
+		cout << "WARNING: could not write model file " << path << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Mapeia o arquivo em memória e lê o modelo escrito por save. Com useMmap, os contadores densos
+ * continuam sendo lidos diretamente das páginas mapeadas, que são compartilhadas entre processos
+ * que carregam o mesmo arquivo; o mapeamento é mantido enquanto algum discriminador o referenciar,
+ * e cada bloco é copiado para memória própria apenas se for treinado novamente.
+ * Sem useMmap, todo o conteúdo é copiado e o arquivo é liberado ao final da leitura.
+ * Retorna nulo e gera um warning caso o arquivo não exista ou seja inválido.
+ */
+WiSARD *WiSARD::load(const string &path, bool useMmap)
+{
+	shared_ptr<MappedFile> file = make_shared<MappedFile>(path);
+	if(!file->isOpen())
+	{
+		cout << "WARNING: could not open model file " << path << endl;
+		return NULL;
+	}
+
+	ModelReader reader(file->data(), file->size());
+	const char *magic = reader.readBytes(sizeof(MODEL_MAGIC));
+	uint32_t version = 0, byteOrder = 0;
+	reader.read(version);
+	reader.read(byteOrder);
+
+	if(magic == NULL || memcmp(magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0
+	   || version < 1 || version > MODEL_VERSION || byteOrder != MODEL_BYTE_ORDER)
+	{
+		cout << "WARNING: invalid model file " << path << endl;
+		return NULL;
+	}
+
+	int32_t retinaLength = 0, numBitsAddr = 0, defaultBleaching_b = 0;
+	uint8_t useBleaching = 0, randomizePositions = 0, isCummulative = 0, ignoreZeroAddr = 0;
+	float confidenceThreshold = 0.0;
+	uint32_t seed = 0;
+
+	reader.read(retinaLength);
+	reader.read(numBitsAddr);
+	reader.read(useBleaching);
+	reader.read(confidenceThreshold);
+	reader.read(defaultBleaching_b);
+	reader.read(randomizePositions);
+	reader.read(isCummulative);
+	reader.read(ignoreZeroAddr);
+	reader.read(seed);
+
+	// version 1 files have no hashed memories
+	uint8_t hasHash = 0;
+	int32_t numHashes = 0, numCells = 0;
+	uint32_t hashSeed = 0;
+	if(version >= 2)
+		reader.read(hasHash);
+	if(hasHash)
+	{
+		reader.read(numHashes);
+		reader.read(numCells);
+		reader.read(hashSeed);
+	}
+
+	// version 1 and 2 files keep the counters of non-cumulative networks
+	uint8_t hasBitArena = 0;
+	if(version >= 3)
+		reader.read(hasBitArena);
+
+	if(!reader.good() || retinaLength <= 0 || numBitsAddr <= 0
+	   || (hasHash && (numHashes < 1 || numHashes > H3Hash::MAX_HASHES || numCells < 1 || numBitsAddr > 64))
+	   || (hasBitArena && (isCummulative || hasHash)))
+	{
+		cout << "WARNING: invalid model file " << path << endl;
+		return NULL;
+	}
+
+	vector<int> mapping(retinaLength);
+	vector<bool> seen(retinaLength, false);
+	bool valid = true;
+	for(int i = 0; valid && i < retinaLength; i++)
+	{
+		int32_t position = -1;
+		valid = reader.read(position) && position >= 0 && position < retinaLength && !seen[position];
+		if(valid)
+		{
+			mapping[i] = position;
+			seen[position] = true;
+		}
+	}
+
+	uint32_t numLabels = 0;
+	valid = valid && reader.read(numLabels);
+	if(!valid)
+	{
+		cout << "WARNING: invalid model file " << path << endl;
+		return NULL;
+	}
+
+	WiSARD *w = new WiSARD(retinaLength, numBitsAddr, useBleaching, confidenceThreshold,
+						   defaultBleaching_b, false, isCummulative, ignoreZeroAddr);
+	w->randomizePositions = randomizePositions;
+	w->seed = seed;
+	w->memoryAddressMapping = mapping;
+	w->tupleMapping = TupleMapping(retinaLength, numBitsAddr, mapping);
+	if(hasHash)
+		w->hash = make_shared<H3Hash>(numHashes, numCells, numBitsAddr, hashSeed);
+	if(!hasBitArena)
+		w->bitArena.reset();
+
+	shared_ptr<MappedFile> mappedFile = useMmap ? file : shared_ptr<MappedFile>();
+	for(uint32_t i = 0; valid && i < numLabels; i++)
+	{
+		string label;
+		valid = reader.readString(label) && w->labelIndices.count(label) == 0;
+		Discriminator *d = valid ? Discriminator::read(reader, retinaLength, numBitsAddr, mapping,
+														 isCummulative, ignoreZeroAddr, mappedFile, w->hash, w->bitArena)
+								 : NULL;
+		valid = (d != NULL);
+		if(valid)
+		{
+			w->labelIndices[label] = (int) w->labels.size();
+			w->labels.push_back(label);
+			w->discriminators.push_back(d);
+		}
+	}
+	if(valid && w->bitArena)
+		valid = w->bitArena->read(reader);
+
+	if(!valid)
+	{
+		cout << "WARNING: invalid model file " << path << endl;
+		delete w;
+		return NULL;
+	}
+	return w;
 }
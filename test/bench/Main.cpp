@@ -0,0 +1,362 @@
+#include "WiSARD.hpp"
+#include "InferenceEngine.hpp"
+#include "DataLoader.hpp"
+#include "Discriminator.hpp"
+#include "Memory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace wann;
+
+/*
+ * libwann benchmark suite.
+ *
+ * Every measurement prints one CSV line with the columns below; "items" is the number
+ * of operations timed (lookups, samples, ...) and "seconds" is the best of REPEATS runs.
+ *
+ * usage: bench.exe [--quick] [--threads N] [--data DIR]
+ */
+
+static const char *CSV_HEADER =
+    "benchmark,dataset,retina_length,num_bits,num_classes,bleaching,conf_threshold,threads,items,seconds,items_per_second,"
+    "p50_seconds,p99_seconds,mean_batch_size";
+
+static int REPEATS = 3;
+
+// keeps the compiler from discarding lookups whose results are otherwise unused
+static volatile long long sink = 0;
+
+
+struct Config
+{
+    string dataset;
+    int retinaLength;
+    int numBits;
+    int numClasses;
+    bool bleaching;
+    float confThreshold;
+    int threads;
+};
+
+
+void report(const string &benchmark, const Config &config, long long items, double seconds,
+            const LatencyStats *latency=NULL)
+{
+    cout << benchmark << ","
+         << config.dataset << ","
+         << config.retinaLength << ","
+         << config.numBits << ","
+         << config.numClasses << ","
+         << (config.bleaching ? 1 : 0) << ","
+         << config.confThreshold << ","
+         << config.threads << ","
+         << items << ","
+         << seconds << ","
+         << ((seconds > 0.0) ? items / seconds : 0.0) << ",";
+    // request latencies only exist for the inference engine
+    if(latency != NULL)
+        cout << latency->p50Seconds << "," << latency->p99Seconds << "," << latency->meanBatchSize;
+    else
+        cout << ",,";
+    cout << endl;
+}
+
+
+// best wall-clock time, in seconds, of REPEATS runs of body
+double bestOf(const function<void(void)> &body)
+{
+    double best = -1.0;
+    for(int r = 0; r < REPEATS; r++)
+    {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        body();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if(best < 0.0 || seconds < best)
+            best = seconds;
+    }
+    return best;
+}
+
+
+// synthetic dataset: noisy copies of one random prototype per class
+void makeData(int numSamples, int retinaLength, int numClasses, unsigned seed,
+              vector<vector<int>> &X, vector<string> &y)
+{
+    mt19937 rng(seed);
+    vector<vector<int>> prototypes(numClasses, vector<int>(retinaLength));
+
+    for(int c = 0; c < numClasses; c++)
+        for(int j = 0; j < retinaLength; j++)
+            prototypes[c][j] = rng() % 2;
+
+    X.clear();
+    y.clear();
+    for(int i = 0; i < numSamples; i++)
+    {
+        int c = rng() % numClasses;
+        vector<int> retina = prototypes[c];
+        for(int j = 0; j < retinaLength; j++)
+            if(rng() % 100 < 10)
+                retina[j] ^= 1;
+        X.push_back(retina);
+        y.push_back(to_string(c));
+    }
+}
+
+
+bool loadCsv(const string &XFile, const string &yFile, vector<vector<int>> &X, vector<string> &y)
+{
+    ifstream probe(XFile.c_str());
+    if(!probe.is_open())
+        return false;
+    return DataLoader::loadCsv(XFile, X) && DataLoader::loadLabels(yFile, y) && !X.empty() && X.size() == y.size();
+}
+
+
+void benchMemory(int numBits)
+{
+    Config config = {"synthetic", 0, numBits, 0, false, 0.0f, 1};
+    int numOps = 1 << 20;
+    long long mask = (numBits >= 62) ? -1LL : ((1LL << numBits) - 1);
+
+    vector<long long> addrs(numOps);
+    mt19937_64 rng(numBits);
+    for(int i = 0; i < numOps; i++)
+        addrs[i] = (long long) (rng() & (unsigned long long) mask);
+
+    Memory *memory = NULL;
+    double seconds = bestOf([&]()
+    {
+        delete memory;
+        memory = new Memory(numBits, true, false);
+        for(int i = 0; i < numOps; i++)
+            memory->addValue(addrs[i], 1);
+    });
+    report("memory_add_value", config, numOps, seconds);
+
+    long long checksum = 0;
+    seconds = bestOf([&]()
+    {
+        for(int i = 0; i < numOps; i++)
+            checksum += memory->getValue(addrs[i]);
+    });
+    report("memory_get_value", config, numOps, seconds);
+
+    delete memory;
+    sink = checksum;
+}
+
+
+void benchDiscriminator(int retinaLength, int numBits, int numSamples)
+{
+    Config config = {"synthetic", retinaLength, numBits, 1, false, 0.0f, 1};
+    vector<vector<int>> X;
+    vector<string> y;
+    makeData(numSamples, retinaLength, 1, numBits, X, y);
+
+    vector<int> mapping(retinaLength);
+    for(int i = 0; i < retinaLength; i++)
+        mapping[i] = i;
+    shuffle(mapping.begin(), mapping.end(), default_random_engine(numBits));
+
+    Discriminator *d = NULL;
+    double seconds = bestOf([&]()
+    {
+        delete d;
+        d = new Discriminator(retinaLength, numBits, mapping);
+        for(int i = 0; i < numSamples; i++)
+            d->addTrainning(X[i]);
+    });
+    report("discriminator_add_trainning", config, numSamples, seconds);
+
+    long long checksum = 0;
+    seconds = bestOf([&]()
+    {
+        for(int i = 0; i < numSamples; i++)
+            checksum += d->predict(X[i])[0];
+    });
+    report("discriminator_predict", config, numSamples, seconds);
+
+    delete d;
+    sink = checksum;
+}
+
+
+void benchWiSARD(Config config, const vector<vector<int>> &X, const vector<string> &y,
+                 const vector<vector<int>> &T)
+{
+    WiSARD *w = NULL;
+    double seconds = bestOf([&]()
+    {
+        delete w;
+        w = new WiSARD(config.retinaLength, config.numBits, config.bleaching, config.confThreshold);
+        w->setNumThreads(config.threads);
+        w->fit(X, y);
+    });
+    report("wisard_fit", config, X.size(), seconds);
+
+    seconds = bestOf([&]()
+    {
+        vector<string> result = w->predict(T);
+    });
+    report("wisard_predict", config, T.size(), seconds);
+
+    seconds = bestOf([&]()
+    {
+        vector<unordered_map<string, float>> result = w->predictProba(T);
+    });
+    report("wisard_predict_proba", config, T.size(), seconds);
+
+    delete w;
+}
+
+
+// single-retina requests: one predict call per request, then micro-batched by an InferenceEngine
+void benchEngine(Config config, const vector<vector<int>> &X, const vector<string> &y,
+                 const vector<vector<int>> &T)
+{
+    WiSARD w(config.retinaLength, config.numBits, config.bleaching, config.confThreshold);
+    w.fit(X, y);
+
+    double seconds = bestOf([&]()
+    {
+        for(size_t i = 0; i < T.size(); i++)
+        {
+            vector<vector<int>> one(1, T[i]);
+            vector<string> result = w.predict(one);
+        }
+    });
+    report("single_request_predict", config, T.size(), seconds);
+
+    LatencyStats latency;
+    seconds = bestOf([&]()
+    {
+        InferenceEngine engine(w, config.threads);
+        vector<future<string>> results(T.size());
+        for(size_t i = 0; i < T.size(); i++)
+            results[i] = engine.submit(T[i]);
+        for(size_t i = 0; i < T.size(); i++)
+            results[i].get();
+        latency = engine.getLatencyStats();
+    });
+    report("engine_predict", config, T.size(), seconds, &latency);
+}
+
+
+int main(int argc, char **argv)
+{
+    bool quick = false;
+    int maxThreads = (int) thread::hardware_concurrency();
+    string dataDir = "./test/data";
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--quick") == 0)
+            quick = true;
+        else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            maxThreads = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--data") == 0 && i + 1 < argc)
+            dataDir = argv[++i];
+    }
+    if(quick)
+        REPEATS = 1;
+    maxThreads = max(1, maxThreads);
+
+    cout << CSV_HEADER << endl;
+
+    // RAM nodes
+    int memoryBits[] = {8, 16, 24};
+    for(int b : memoryBits)
+        benchMemory(b);
+
+    // single discriminator
+    int discriminatorBits[] = {4, 8, 16, 24};
+    for(int b : discriminatorBits)
+        benchDiscriminator(4096, b, quick ? 200 : 1000);
+
+    // end to end, synthetic retinas
+    int retinaLength = 2048;
+    int numTrain = quick ? 300 : 2000;
+    int numTest = quick ? 300 : 2000;
+    int wisardBits[] = {4, 8, 16, 24};
+    int wisardClasses[] = {2, 10, 50};
+    for(int numClasses : wisardClasses)
+    {
+        vector<vector<int>> X, T;
+        vector<string> y, yT;
+        makeData(numTrain, retinaLength, numClasses, 1, X, y);
+        makeData(numTest, retinaLength, numClasses, 2, T, yT);
+
+        for(int b : wisardBits)
+        {
+            Config noBleaching = {"synthetic", retinaLength, b, numClasses, false, 0.1f, 1};
+            Config bleaching = {"synthetic", retinaLength, b, numClasses, true, 0.1f, 1};
+            Config strictBleaching = {"synthetic", retinaLength, b, numClasses, true, 0.5f, 1};
+            benchWiSARD(noBleaching, X, y, T);
+            benchWiSARD(bleaching, X, y, T);
+            benchWiSARD(strictBleaching, X, y, T);
+        }
+    }
+
+    // end to end, thread scaling
+    {
+        vector<vector<int>> X, T;
+        vector<string> y, yT;
+        makeData(numTrain, 4096, 10, 1, X, y);
+        makeData(numTest, 4096, 10, 2, T, yT);
+        for(int threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            Config config = {"synthetic", 4096, 16, 10, true, 0.1f, threads};
+            benchWiSARD(config, X, y, T);
+        }
+        for(int threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            Config config = {"synthetic", 4096, 16, 10, true, 0.1f, threads};
+            benchEngine(config, X, y, T);
+        }
+    }
+
+    // end to end, datasets of test/data (the X files are not versioned; they are skipped when absent)
+    const char *datasets[] = {"imdb", "new_omd", "new_sts"};
+    for(const char *name : datasets)
+    {
+        vector<vector<int>> X;
+        vector<string> y;
+        string prefix = dataDir + "/" + name;
+        if(!loadCsv(prefix + "_cpp_X.csv", prefix + "_cpp_y.csv", X, y))
+        {
+            cerr << "skipping dataset " << name << ": " << prefix << "_cpp_X.csv not found" << endl;
+            continue;
+        }
+
+        int numClasses = 0;
+        {
+            vector<string> distinct = y;
+            sort(distinct.begin(), distinct.end());
+            numClasses = (int) (unique(distinct.begin(), distinct.end()) - distinct.begin());
+        }
+
+        int wisardDataBits[] = {8, 16, 24};
+        for(int b : wisardDataBits)
+        {
+            Config noBleaching = {name, (int) X[0].size(), b, numClasses, false, 0.1f, 1};
+            Config bleaching = {name, (int) X[0].size(), b, numClasses, true, 0.1f, 1};
+            benchWiSARD(noBleaching, X, y, X);
+            benchWiSARD(bleaching, X, y, X);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,1308 @@
+#include "DataLoader.hpp"
+#include "Discriminator.hpp"
+#include "Encoder.hpp"
+#include "InferenceEngine.hpp"
+#include "ModelHandle.hpp"
+#include "ScoringSession.hpp"
+#include "Sweep.hpp"
+#include "Util.hpp"
+#include "WiSARD.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+using namespace wann;
+
+/*
+ * libwann equivalence tests.
+ *
+ * Every check trains networks on a seeded synthetic dataset and compares an optimized path with
+ * the baseline path it must reproduce exactly; any difference fails the check.
+ *
+ * usage: equivalence.exe [CHECK...]
+ *            runs the named checks (every check when none is given)
+ */
+
+typedef vector<unordered_map<string, float>> Probas;
+
+struct Check
+{
+    const char *name;
+    bool (*run)(string &detail);
+};
+
+
+// synthetic dataset: noisy copies of one random prototype per class
+void makeData(int numSamples, int retinaLength, int numClasses, unsigned seed,
+              vector<vector<int>> &X, vector<string> &y)
+{
+    mt19937 rng(seed);
+    vector<vector<int>> prototypes(numClasses, vector<int>(retinaLength));
+
+    for(int c = 0; c < numClasses; c++)
+        for(int j = 0; j < retinaLength; j++)
+            prototypes[c][j] = rng() % 2;
+
+    X.clear();
+    y.clear();
+    for(int i = 0; i < numSamples; i++)
+    {
+        int c = rng() % numClasses;
+        vector<int> retina = prototypes[c];
+        for(int j = 0; j < retinaLength; j++)
+            if(rng() % 100 < 10)
+                retina[j] ^= 1;
+        X.push_back(retina);
+        y.push_back(to_string(c));
+    }
+}
+
+
+string describe(int numBits, bool isCummulative)
+{
+    return "bits " + to_string(numBits) + (isCummulative ? ", cumulative" : ", non-cumulative");
+}
+
+
+string tempPath(const string &name)
+{
+    return "/tmp/libwann_equivalence_" + to_string(getpid()) + "_" + name;
+}
+
+
+void writeFile(const string &path, const string &content)
+{
+    ofstream output(path.c_str(), ios::out | ios::binary | ios::trunc);
+    output << content;
+}
+
+
+bool sameRetinas(const vector<BitRetina> &a, const vector<BitRetina> &b)
+{
+    if(a.size() != b.size())
+        return false;
+    for(size_t i = 0; i < a.size(); i++)
+        if(a[i].size() != b[i].size() || memcmp(a[i].data(), b[i].data(), a[i].numWords() * sizeof(uint64_t)) != 0)
+            return false;
+    return true;
+}
+
+
+// synthetic numeric dataset: noisy copies of one random prototype per class, with values slightly
+// outside [0, 1) so encoders see out-of-range features
+void makeFeatures(int numSamples, int numFeatures, int numClasses, unsigned seed,
+                  vector<vector<float>> &X, vector<string> &y)
+{
+    mt19937 rng(seed);
+    uniform_real_distribution<float> uniform(-0.2f, 1.2f), noise(-0.15f, 0.15f);
+    vector<vector<float>> prototypes(numClasses, vector<float>(numFeatures));
+
+    for(int c = 0; c < numClasses; c++)
+        for(int j = 0; j < numFeatures; j++)
+            prototypes[c][j] = uniform(rng);
+
+    X.clear();
+    y.clear();
+    for(int i = 0; i < numSamples; i++)
+    {
+        int c = rng() % numClasses;
+        vector<float> features = prototypes[c];
+        for(int j = 0; j < numFeatures; j++)
+            features[j] += noise(rng);
+        X.push_back(features);
+        y.push_back(to_string(c));
+    }
+}
+
+
+// ------------------------------------------------------------------ checks
+
+// threaded predict and predictProba against the serial network
+bool threadedPredict(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 500, 5, 1, X, y);
+    makeData(200, 500, 5, 2, T, yT);
+
+    int bits[] = {4, 8, 16};
+    for(int b = 0; b < 3; b++)
+    {
+        for(int cumulative = 0; cumulative < 2; cumulative++)
+        {
+            WiSARD w(500, bits[b], true, 0.1, 1, true, cumulative);
+            w.fit(X, y);
+
+            Probas serialProba = w.predictProba(T);
+            vector<string> serialLabels = w.predict(T);
+
+            w.setNumThreads(4);
+            if(w.predictProba(T) != serialProba || w.predict(T) != serialLabels)
+            {
+                detail = describe(bits[b], cumulative);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+// threaded fit against serial fit, with the same memories and scores
+bool threadedFit(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 500, 5, 3, X, y);
+    makeData(200, 500, 5, 4, T, yT);
+
+    int bits[] = {4, 8, 16};
+    for(int b = 0; b < 3; b++)
+    {
+        for(int cumulative = 0; cumulative < 2; cumulative++)
+        {
+            WiSARD serial(500, bits[b], true, 0.1, 1, false, cumulative);
+            WiSARD threaded(500, bits[b], true, 0.1, 1, false, cumulative);
+            threaded.setNumThreads(4);
+
+            serial.fit(X, y);
+            threaded.fit(X, y);
+            threaded.setNumThreads(1);
+            if(threaded.predictProba(T) != serial.predictProba(T))
+            {
+                detail = describe(bits[b], cumulative);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+// serial partialFit in batches against train one input at a time: same scores and, as neither
+// path reserves counters, the same counter widths
+bool partialFitBatches(string &detail)
+{
+    mt19937 rng(6);
+    vector<vector<int>> X(1200, vector<int>(512));
+    vector<string> y(X.size());
+    for(size_t i = 0; i < X.size(); i++)
+    {
+        for(int j = 0; j < 512; j++)
+            X[i][j] = rng() % 2;
+        y[i] = to_string(i % 2);
+    }
+
+    WiSARD batches(512, 8, false, 0.1, 1, false, true);
+    WiSARD single(512, 8, false, 0.1, 1, false, true);
+
+    for(size_t begin = 0; begin < X.size(); begin += 100)
+    {
+        vector<vector<int>> batchX(X.begin() + begin, X.begin() + begin + 100);
+        vector<string> batchY(y.begin() + begin, y.begin() + begin + 100);
+        batches.partialFit(batchX, batchY);
+    }
+    for(size_t i = 0; i < X.size(); i++)
+        single.train(X[i], y[i]);
+
+    if(batches.predictProba(X) != single.predictProba(X))
+    {
+        detail = "different scores";
+        return false;
+    }
+    if(batches.getStats().bytes != single.getStats().bytes)
+    {
+        detail = "batches use " + to_string(batches.getStats().bytes) + " bytes, single inputs "
+                 + to_string(single.getStats().bytes);
+        return false;
+    }
+    return true;
+}
+
+
+// a network loaded with mmap keeps predicting after being saved (and trained and saved) over its own file
+bool saveSamePath(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 500, 5, 8, X, y);
+    makeData(200, 500, 5, 9, T, yT);
+    string path = "/tmp/libwann_equivalence_" + to_string(getpid()) + ".wann";
+
+    int bits[] = {8, 16};
+    for(int b = 0; b < 2; b++)
+    {
+        WiSARD w(500, bits[b], true, 0.1, 1, true, true);
+        w.fit(vector<vector<int>>(X.begin(), X.begin() + 300), vector<string>(y.begin(), y.begin() + 300));
+        Probas expected = w.predictProba(T);
+
+        WiSARD *loaded = w.save(path) ? WiSARD::load(path, true) : NULL;
+        bool passed = loaded != NULL && loaded->save(path) && loaded->predictProba(T) == expected;
+
+        // load, partialFit, save back
+        w.partialFit(vector<vector<int>>(X.begin() + 300, X.end()), vector<string>(y.begin() + 300, y.end()));
+        if(passed)
+        {
+            loaded->partialFit(vector<vector<int>>(X.begin() + 300, X.end()), vector<string>(y.begin() + 300, y.end()));
+            passed = loaded->save(path) && loaded->predictProba(T) == w.predictProba(T);
+        }
+
+        WiSARD *reloaded = passed ? WiSARD::load(path, true) : NULL;
+        passed = reloaded != NULL && reloaded->predictProba(T) == w.predictProba(T);
+        delete reloaded;
+        delete loaded;
+        unlink(path.c_str());
+        if(!passed)
+        {
+            detail = describe(bits[b], true);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// bleaching against the reference algorithm: per-memory responses of standalone discriminators,
+// b incremented one unit at a time, scores kept unbleached when no memory passes b
+bool bleachingReference(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 480, 4, 10, X, y);
+    makeData(200, 480, 4, 11, T, yT);
+
+    // the mapping of a network without randomized positions
+    vector<int> identity(480);
+    for(int j = 0; j < 480; j++)
+        identity[j] = j;
+
+    float thresholds[] = {0.05f, 0.1f, 0.5f};
+    int defaultB[] = {0, 1, 3};
+    for(int k = 0; k < 9; k++)
+    {
+        for(int ignoreZeroAddr = 0; ignoreZeroAddr < 2; ignoreZeroAddr++)
+        {
+            float threshold = thresholds[k % 3];
+            int firstB = defaultB[k / 3];
+            WiSARD w(480, 8, true, threshold, firstB, false, true, ignoreZeroAddr);
+            w.fit(X, y);
+
+            unordered_map<string, Discriminator *> reference;
+            for(size_t i = 0; i < X.size(); i++)
+            {
+                if(!reference.count(y[i]))
+                    reference[y[i]] = new Discriminator(480, 8, identity, true, ignoreZeroAddr);
+                reference[y[i]]->addTrainning(X[i]);
+            }
+
+            Probas expected(T.size());
+            for(size_t i = 0; i < T.size(); i++)
+            {
+                unordered_map<string, vector<int>> responses;
+                unordered_map<string, float> result, bleached;
+                for(auto it = reference.begin(); it != reference.end(); ++it)
+                {
+                    responses[it->first] = it->second->predict(T[i]);
+                    const vector<int> &r = responses[it->first];
+                    result[it->first] = (float) count_if(r.begin(), r.end(), [](int v) { return v > 0; }) / (float) r.size();
+                }
+
+                bleached = result;
+                for(int b = firstB; util::calculateConfidence(bleached) < threshold; b++)
+                {
+                    for(auto it = responses.begin(); it != responses.end(); ++it)
+                    {
+                        const vector<int> &r = it->second;
+                        bleached[it->first] = (float) count_if(r.begin(), r.end(), [b](int v) { return v > b; }) / (float) r.size();
+                    }
+                    if(util::maxValue(bleached) <= 0.000001)
+                    {
+                        bleached = result;
+                        break;
+                    }
+                }
+                expected[i] = bleached;
+            }
+            for(auto it = reference.begin(); it != reference.end(); ++it)
+                delete it->second;
+
+            if(w.predictProba(T) != expected)
+            {
+                detail = "threshold " + to_string(threshold) + ", b " + to_string(firstB)
+                         + (ignoreZeroAddr ? ", ignoring address 0" : "");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+// label-indexed score matrix, label indices and predict against predictProba and its argmax,
+// for int and packed retinas
+bool denseScores(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 500, 6, 13, X, y);
+    makeData(200, 500, 6, 14, T, yT);
+    vector<BitRetina> packed(T.begin(), T.end());
+
+    int bits[] = {4, 8, 16};
+    for(int b = 0; b < 3; b++)
+    {
+        for(int cumulative = 0; cumulative < 2; cumulative++)
+        {
+            WiSARD w(500, bits[b], true, 0.1, 1, true, cumulative);
+            w.fit(X, y);
+
+            int numLabels = w.getNumLabels();
+            Probas proba = w.predictProba(T);
+            vector<float> scores(T.size() * numLabels), packedScores(T.size() * numLabels);
+            w.predictScores(T, scores.data());
+            w.predictScores(packed, packedScores.data());
+            vector<int> indices = w.predictLabelIndices(T);
+            vector<string> labels = w.predict(T);
+
+            bool passed = scores == packedScores && indices == w.predictLabelIndices(packed);
+            for(size_t i = 0; passed && i < T.size(); i++)
+            {
+                // argmax of the map, ties resolved to the larger label index
+                int expected = -1;
+                float best = -1;
+                for(auto it = proba[i].begin(); it != proba[i].end(); ++it)
+                {
+                    int c = w.getLabelIndex(it->first);
+                    passed = passed && scores[i * numLabels + c] == it->second;
+                    if(it->second > best || (it->second == best && c > expected))
+                    {
+                        expected = c;
+                        best = it->second;
+                    }
+                }
+                passed = passed && (int) proba[i].size() == numLabels && indices[i] == expected
+                         && labels[i] == w.getLabels()[expected];
+            }
+            if(!passed)
+            {
+                detail = describe(bits[b], cumulative);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+// CSV retinas with "\r\n", blank lines, spaces and signs, as int and packed retinas; malformed and
+// overflowing values are rejected and leave no retinas
+bool csvLoader(string &detail)
+{
+    string path = tempPath("retinas.csv");
+    writeFile(path, "1,0,+1, -1\r\n\r\n  \n0 ,2147483647,-2147483648,0\n\n1,1,0,0");
+    vector<vector<int>> expected = {{1, 0, 1, -1}, {0, 2147483647, -2147483648, 0}, {1, 1, 0, 0}};
+
+    vector<vector<int>> X;
+    vector<BitRetina> packed;
+    bool passed = DataLoader::loadCsv(path, X) && X == expected && DataLoader::loadCsv(path, packed)
+                  && sameRetinas(packed, vector<BitRetina>(expected.begin(), expected.end()));
+    if(!passed)
+        detail = "valid file";
+
+    const char *invalid[] = {"1,2147483648\n", "1,-2147483649\n", "1,,0\n", "1,0x1\n", "1,+\n", "1,2 3\n"};
+    for(int k = 0; passed && k < 6; k++)
+    {
+        writeFile(path, string("0,1\n") + invalid[k]);
+        passed = !DataLoader::loadCsv(path, X) && X.empty() && !DataLoader::loadCsv(path, packed) && packed.empty();
+        if(!passed)
+            detail = string("accepted ") + invalid[k];
+    }
+
+    writeFile(path, "");
+    passed = passed && DataLoader::loadCsv(path, X) && X.empty();
+    unlink(path.c_str());
+    return passed;
+}
+
+
+// labels separated by commas and line breaks, with "\r", spaces and empty fields dropped
+bool labelLoader(string &detail)
+{
+    string path = tempPath("labels.csv");
+    writeFile(path, "a, b\r\nc,\n\n  dog ,e\r\n,f");
+    vector<string> y;
+    bool passed = DataLoader::loadLabels(path, y) && y == vector<string>({"a", "b", "c", "dog", "e", "f"});
+    unlink(path.c_str());
+    if(!passed)
+        detail = "unexpected labels";
+    return passed;
+}
+
+
+// saveRetinas / loadRetinas round trip on several lengths, and headers whose retina count does not
+// fit the file are rejected before allocating
+bool retinaFile(string &detail)
+{
+    string path = tempPath("retinas.bin");
+    mt19937 rng(40);
+    int lengths[] = {1, 63, 64, 65, 200};
+    for(int l = 0; l < 5; l++)
+    {
+        vector<BitRetina> X;
+        for(int i = 0; i < 37; i++)
+        {
+            vector<int> retina(lengths[l]);
+            for(size_t j = 0; j < retina.size(); j++)
+                retina[j] = rng() % 2;
+            X.push_back(BitRetina(retina));
+        }
+        vector<BitRetina> loaded;
+        if(!DataLoader::saveRetinas(path, X) || !DataLoader::loadRetinas(path, loaded) || !sameRetinas(loaded, X))
+        {
+            detail = "length " + to_string(lengths[l]);
+            unlink(path.c_str());
+            return false;
+        }
+    }
+
+    // empty retinas can not be saved, and a header declaring any of them is invalid
+    vector<BitRetina> loaded;
+    bool passed = !DataLoader::saveRetinas(path, vector<BitRetina>(3, BitRetina(0)))
+                  && DataLoader::saveRetinas(path, vector<BitRetina>());
+    ifstream input(path.c_str(), ios::binary);
+    string header((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+    int64_t huge = (int64_t) 1 << 50;
+    passed = passed && header.size() >= 28 && DataLoader::loadRetinas(path, loaded) && loaded.empty();
+    for(int32_t length = 0; passed && length <= 64; length += 64)
+    {
+        string corrupted = header;
+        memcpy(&corrupted[16], &length, sizeof(length));
+        memcpy(&corrupted[20], &huge, sizeof(huge));
+        writeFile(path, corrupted);
+        passed = !DataLoader::loadRetinas(path, loaded) && loaded.empty();
+    }
+    unlink(path.c_str());
+    if(!passed)
+        detail = "invalid header accepted";
+    return passed;
+}
+
+
+// numeric inputs addressed through the encoder against the retinas built by Encoder::encode, for
+// thermometer, one-hot and threshold encoders; tuple widths with and without a rest tuple
+bool encoderFused(string &detail)
+{
+    vector<vector<float>> X, T;
+    vector<string> y, yT;
+    makeFeatures(600, 40, 5, 41, X, y);
+    makeFeatures(200, 40, 5, 42, T, yT);
+
+    Encoder encoders[] = {Encoder::thermometer(40, 7, 0.0f, 1.0f), Encoder::oneHot(40, 5, 0.0f, 1.0f),
+                          Encoder::threshold(vector<float>(40, 0.5f))};
+    const char *names[] = {"thermometer", "one-hot", "threshold"};
+    int bits[] = {3, 8, 13};
+    for(int e = 0; e < 3; e++)
+    {
+        const Encoder &encoder = encoders[e];
+        int retinaLength = encoder.getRetinaLength();
+        vector<BitRetina> encodedX, encodedT;
+        for(size_t i = 0; i < X.size(); i++)
+            encodedX.push_back(encoder.encode(X[i]));
+        for(size_t i = 0; i < T.size(); i++)
+            encodedT.push_back(encoder.encode(T[i]));
+
+        for(int b = 0; b < 3; b++)
+        {
+            for(int cumulative = 0; cumulative < 2; cumulative++)
+            {
+                WiSARD fused(retinaLength, bits[b], true, 0.1, 1, false, cumulative);
+                WiSARD encoded(retinaLength, bits[b], true, 0.1, 1, false, cumulative);
+                fused.setEncoder(encoder);
+
+                fused.fit(X, y);
+                encoded.fit(encodedX, y);
+                Probas expected = encoded.predictProba(encodedT);
+                if(fused.predictProba(T) != expected || fused.predictProba(encodedT) != expected
+                   || fused.predict(T) != encoded.predict(encodedT))
+                {
+                    detail = string(names[e]) + ", " + describe(bits[b], cumulative);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+// accuracy of a network trained from scratch with a single sweep configuration
+float retrainedAccuracy(int retinaLength, int numBits, const WiSARD::ScoringOptions &option, bool cumulative,
+                        const vector<vector<int>> &XTrain, const vector<string> &yTrain,
+                        const vector<vector<int>> &XTest, const vector<string> &yTest)
+{
+    WiSARD wisard(retinaLength, numBits, option.useBleaching, option.confidenceThreshold,
+                  option.defaultBleaching_b, false, cumulative, option.ignoreZeroAddr);
+    wisard.fit(XTrain, yTrain);
+    vector<string> predicted = wisard.predict(XTest);
+
+    long long hits = 0;
+    for(size_t i = 0; i < yTest.size(); i++)
+        hits += (predicted[i] == yTest[i]);
+    return (float) hits / (float) yTest.size();
+}
+
+// one trained network per number of bits scoring every configuration against a network retrained per
+// configuration; crossValidate against the same folds retrained by hand, and repeatable for a seed
+bool sweepRetrained(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(300, 96, 4, 51, X, y);
+    makeData(120, 96, 4, 52, T, yT);
+
+    int bits[] = {4, 8};
+    vector<int> numBits(bits, bits + 2);
+    vector<WiSARD::ScoringOptions> options = Sweep::grid({false, true}, {0.0f, 0.1f, 0.5f}, {1, 3}, {false, true});
+    const int numFolds = 3;
+    const unsigned seed = 53;
+
+    // folds of crossValidate: consecutive slices of the shuffled order
+    vector<int> order(X.size());
+    for(size_t i = 0; i < order.size(); i++)
+        order[i] = (int) i;
+    shuffle(order.begin(), order.end(), default_random_engine(seed));
+    vector<int> folds(X.size());
+    for(size_t k = 0; k < order.size(); k++)
+        folds[order[k]] = (int) (k * numFolds / order.size());
+    vector<vector<vector<int>>> XTrainFolds(numFolds), XTestFolds(numFolds);
+    vector<vector<string>> yTrainFolds(numFolds), yTestFolds(numFolds);
+    for(size_t i = 0; i < X.size(); i++)
+    {
+        for(int f = 0; f < numFolds; f++)
+        {
+            vector<vector<int>> &XFold = (f == folds[i]) ? XTestFolds[f] : XTrainFolds[f];
+            vector<string> &yFold = (f == folds[i]) ? yTestFolds[f] : yTrainFolds[f];
+            XFold.push_back(X[i]);
+            yFold.push_back(y[i]);
+        }
+    }
+
+    for(int cumulative = 0; cumulative < 2; cumulative++)
+    {
+        Sweep sweep(96, numBits, options, false, cumulative);
+        sweep.setNumThreads(4);
+        vector<SweepResult> evaluated = sweep.evaluate(X, y, T, yT);
+        vector<SweepResult> validated = sweep.crossValidate(X, y, numFolds, seed);
+        vector<SweepResult> repeated = sweep.crossValidate(X, y, numFolds, seed);
+        if(evaluated.size() != numBits.size() * options.size() || validated.size() != evaluated.size())
+        {
+            detail = "unexpected number of results";
+            return false;
+        }
+
+        for(size_t n = 0; n < numBits.size(); n++)
+        {
+            for(size_t k = 0; k < options.size(); k++)
+            {
+                const SweepResult &result = evaluated[n * options.size() + k];
+                detail = describe(numBits[n], cumulative) + ", option " + to_string(k);
+                if(result.accuracy != retrainedAccuracy(96, numBits[n], options[k], cumulative, X, y, T, yT))
+                    return false;
+
+                const SweepResult &folds = validated[n * options.size() + k];
+                float accuracy = 0.0f;
+                for(int f = 0; f < numFolds; f++)
+                {
+                    float expected = retrainedAccuracy(96, numBits[n], options[k], cumulative, XTrainFolds[f],
+                                                       yTrainFolds[f], XTestFolds[f], yTestFolds[f]);
+                    if(folds.foldAccuracies[f] != expected)
+                    {
+                        detail += ", fold " + to_string(f);
+                        return false;
+                    }
+                    accuracy += expected / numFolds;
+                }
+                if(folds.accuracy != accuracy || repeated[n * options.size() + k].foldAccuracies != folds.foldAccuracies)
+                {
+                    detail += ", cross validation";
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+// hashed memories ignoring address 0: all-zero inputs, which address 0 in every memory, must not
+// change any score
+bool hashedZeroAddress(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 480, 4, 16, X, y);
+    makeData(200, 480, 4, 17, T, yT);
+
+    vector<vector<int>> withZeros(X);
+    vector<string> yWithZeros(y);
+    for(int i = 0; i < 200; i++)
+    {
+        withZeros.push_back(vector<int>(480, 0));
+        yWithZeros.push_back(y[i]);
+    }
+
+    int bits[] = {12, 16, 24};
+    for(int b = 0; b < 3; b++)
+    {
+        for(int cumulative = 0; cumulative < 2; cumulative++)
+        {
+            WiSARD clean(480, bits[b], true, 0.1, 1, false, cumulative, true);
+            WiSARD zeros(480, bits[b], true, 0.1, 1, false, cumulative, true);
+            clean.setHashedMemories(2, 64, 19);
+            zeros.setHashedMemories(2, 64, 19);
+
+            clean.fit(X, y);
+            zeros.fit(withZeros, yWithZeros);
+            if(clean.predictProba(T) != zeros.predictProba(T))
+            {
+                detail = describe(bits[b], cumulative);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+// countGreater, with the instruction set selected for this processor, against a scalar loop, on
+// every length up to a few vectors, unaligned starts and extreme values
+bool countGreaterReference(string &detail)
+{
+    mt19937 rng(20);
+    vector<int> values(4096 + 16);
+    for(size_t k = 0; k < values.size(); k++)
+    {
+        int kind = rng() % 8;
+        values[k] = kind == 0 ? INT_MAX : kind == 1 ? INT_MIN : kind == 2 ? -(int) (rng() % 4) : (int) (rng() % 6);
+    }
+
+    int thresholds[] = {INT_MIN, -1, 0, 1, 2, 5, INT_MAX - 1, INT_MAX};
+    for(int length = 0; length <= 4096; length = length < 80 ? length + 1 : length * 2)
+    {
+        for(int offset = 0; offset < 4; offset++)
+        {
+            const int *row = values.data() + offset;
+            for(int t = 0; t < 8; t++)
+            {
+                int expected = 0, expectedMin = INT_MAX;
+                for(int k = 0; k < length; k++)
+                {
+                    if(row[k] > thresholds[t])
+                    {
+                        expected++;
+                        expectedMin = min(expectedMin, row[k]);
+                    }
+                }
+
+                int minAbove, count[3];
+                bool passed = util::countGreater(row, length, thresholds[t]) == expected
+                              && util::countGreater(row, length, thresholds[t], &minAbove) == expected
+                              && minAbove == expectedMin;
+                util::countGreater(row, 3, length / 3, thresholds[t], count);
+                for(int r = 0; passed && r < 3; r++)
+                    passed = count[r] == (int) count_if(row + r * (length / 3), row + (r + 1) * (length / 3),
+                                                        [&](int v) { return v > thresholds[t]; });
+                if(!passed)
+                {
+                    detail = string(util::getSimdInstructionSet()) + ", length " + to_string(length)
+                             + ", offset " + to_string(offset) + ", threshold " + to_string(thresholds[t]);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+// profile of a library built with PROFILE=1: bleachingCalls counts only the inputs whose scores
+// were below confidenceThreshold (nothing to check otherwise)
+bool bleachingCalls(string &detail)
+{
+    if(!Profiler::isEnabled())
+        return true;
+
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 500, 5, 37, X, y);
+    makeData(200, 500, 5, 38, T, yT);
+
+    float thresholds[] = {0.05f, 0.3f, 0.9f};
+    for(int k = 0; k < 3; k++)
+    {
+        WiSARD bleached(500, 8, true, thresholds[k], 1, false, true);
+        WiSARD plain(500, 8, false, thresholds[k], 1, false, true);
+        bleached.fit(X, y);
+        plain.fit(X, y);
+
+        Probas scores = plain.predictProba(T);
+        long long expected = 0;
+        for(size_t i = 0; i < T.size(); i++)
+            expected += util::calculateConfidence(scores[i]) < thresholds[k];
+
+        bleached.resetProfile();
+        bleached.predictProba(T);
+        if(bleached.getProfile().bleachingCalls != expected)
+        {
+            detail = "threshold " + to_string(thresholds[k]) + ": " + to_string(bleached.getProfile().bleachingCalls)
+                     + " calls, " + to_string(expected) + " inputs below it";
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// compressed memories saved and loaded back, and groups whose values are out of order, repeated or
+// do not match their cardinality rejected on load
+bool compressedFile(string &detail)
+{
+    // 20 bits without randomized positions: address bit j is retina position j
+    WiSARD w(20, 20, true, 0.1, 1, false, false);
+    vector<vector<int>> X;
+    vector<string> y;
+    vector<int> zeros(20, 0), middle(20, 0);
+    middle[9] = middle[10] = 1;
+    X.push_back(zeros);
+    X.push_back(middle);
+    y.push_back("array");
+    y.push_back("array");
+    // more addresses than an array group holds, all in group 1
+    const int numBitmapAddrs = 4201;
+    for(int k = 0; k < numBitmapAddrs; k++)
+    {
+        vector<int> retina(20, 0);
+        for(int j = 0; j < 16; j++)
+            retina[j] = (k >> j) & 1;
+        retina[16] = 1;
+        X.push_back(retina);
+        y.push_back("bitmap");
+    }
+    w.fit(X, y);
+    Probas expected = w.predictProba(X);
+
+    string path = tempPath("compressed.wann");
+    WiSARD *loaded = w.save(path) ? WiSARD::load(path, true) : NULL;
+    bool passed = loaded != NULL && loaded->predictProba(X) == expected;
+    delete loaded;
+    if(!passed)
+    {
+        detail = "round trip";
+        unlink(path.c_str());
+        return false;
+    }
+
+    ifstream input(path.c_str(), ios::in | ios::binary);
+    string saved((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+
+    // group headers: key, bitmap flag and cardinality
+    char arrayGroup[17], bitmapGroup[13];
+    int64_t key = 0;
+    uint8_t isBitmap = 0;
+    int32_t cardinality = 2;
+    uint16_t values[2] = {0, 0x600};
+    memcpy(arrayGroup, &key, 8);
+    memcpy(arrayGroup + 8, &isBitmap, 1);
+    memcpy(arrayGroup + 9, &cardinality, 4);
+    memcpy(arrayGroup + 13, values, 4);
+    key = 1;
+    isBitmap = 1;
+    cardinality = numBitmapAddrs;
+    memcpy(bitmapGroup, &key, 8);
+    memcpy(bitmapGroup + 8, &isBitmap, 1);
+    memcpy(bitmapGroup + 9, &cardinality, 4);
+
+    size_t arrayAt = saved.find(string(arrayGroup, 17));
+    size_t bitmapAt = saved.find(string(bitmapGroup, 13));
+    if(arrayAt == string::npos || bitmapAt == string::npos)
+    {
+        detail = "groups not found in the saved file";
+        unlink(path.c_str());
+        return false;
+    }
+
+    const char *corruptions[] = {"unsorted array", "repeated array value", "bitmap cardinality"};
+    for(int c = 0; c < 3; c++)
+    {
+        string corrupted = saved;
+        if(c == 0)
+            corrupted.replace(arrayAt + 13, 4, saved.substr(arrayAt + 15, 2) + saved.substr(arrayAt + 13, 2));
+        else if(c == 1)
+            corrupted.replace(arrayAt + 13, 2, saved.substr(arrayAt + 15, 2));
+        else // address 0x1FFFF, never trained
+            corrupted[bitmapAt + 13 + 1023 * 8 + 7] |= (char) 0x80;
+        writeFile(path, corrupted);
+
+        loaded = WiSARD::load(path, true);
+        if(loaded != NULL)
+        {
+            detail = corruptions[c];
+            delete loaded;
+            unlink(path.c_str());
+            return false;
+        }
+    }
+    unlink(path.c_str());
+    return true;
+}
+
+
+// predict and predictLabelIndices with early exit against the exhaustive evaluation, with many
+// classes, with and without bleaching
+bool earlyExitPredict(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(1200, 512, 40, 21, X, y);
+    makeData(300, 512, 40, 22, T, yT);
+    vector<BitRetina> packed(T.begin(), T.end());
+
+    int bits[] = {4, 8, 16};
+    for(int b = 0; b < 3; b++)
+    {
+        for(int cumulative = 0; cumulative < 2; cumulative++)
+        {
+            for(int bleaching = 0; bleaching < 2; bleaching++)
+            {
+                WiSARD w(512, bits[b], bleaching, 0.1, 1, true, cumulative);
+                w.fit(X, y);
+
+                vector<int> exhaustive = w.predictLabelIndices(T);
+                vector<string> labels = w.predict(T);
+                w.setEarlyExit(true);
+                bool passed = w.predictLabelIndices(T) == exhaustive && w.predictLabelIndices(packed) == exhaustive
+                              && w.predict(T) == labels;
+                w.setNumThreads(4);
+                passed = passed && w.predictLabelIndices(T) == exhaustive;
+                if(!passed)
+                {
+                    detail = describe(bits[b], cumulative) + (bleaching ? ", bleaching" : "");
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+// merge of networks trained on disjoint shards against one network trained on all the data; the
+// last shard lacks a label, which merge must create
+bool mergeShards(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(900, 500, 5, 24, X, y);
+    makeData(200, 500, 5, 25, T, yT);
+
+    vector<vector<vector<int>>> shardX(3);
+    vector<vector<string>> shardY(3);
+    for(size_t i = 0; i < X.size(); i++)
+    {
+        int shard = (y[i] == "0") ? i % 2 : i % 3;
+        shardX[shard].push_back(X[i]);
+        shardY[shard].push_back(y[i]);
+    }
+
+    int bits[] = {4, 8, 16, 24};
+    for(int b = 0; b < 4; b++)
+    {
+        for(int cumulative = 0; cumulative < 2; cumulative++)
+        {
+            WiSARD whole(500, bits[b], true, 0.1, 1, true, cumulative);
+            whole.setSeed(26);
+            whole.fit(X, y);
+
+            WiSARD merged(500, bits[b], true, 0.1, 1, true, cumulative);
+            merged.setSeed(26);
+            bool passed = true;
+            for(int k = 0; k < 3; k++)
+            {
+                WiSARD shard(500, bits[b], true, 0.1, 1, true, cumulative);
+                shard.setMemoryAddressMapping(whole.getMemoryAddressMapping());
+                shard.fit(shardX[k], shardY[k]);
+                passed = passed && merged.merge(shard);
+            }
+            if(!passed || merged.predictProba(T) != whole.predictProba(T))
+            {
+                detail = describe(bits[b], cumulative);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+// labels delivered by an InferenceEngine, in submission order, against WiSARD::predict, for several
+// worker counts, batch sizes and a queue small enough to make submit wait; requests are submitted by
+// several threads at once
+bool enginePredict(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 256, 5, 61, X, y);
+    makeData(400, 256, 5, 62, T, yT);
+
+    WiSARD w(256, 8, true, 0.1, 1, true, true);
+    w.setSeed(63);
+    w.fit(X, y);
+    vector<string> expected = w.predict(T);
+
+    int workers[] = {1, 4};
+    int batchSizes[] = {1, 7, 64};
+    const int numProducers = 4;
+    for(int n = 0; n < 2; n++)
+    {
+        for(int b = 0; b < 3; b++)
+        {
+            vector<future<string>> results(T.size());
+            InferenceEngine engine(w, workers[n], batchSizes[b], 0.0002, 16);
+            vector<thread> producers;
+            for(int p = 0; p < numProducers; p++)
+            {
+                producers.push_back(thread([&, p]()
+                {
+                    for(size_t i = p; i < T.size(); i += numProducers)
+                        results[i] = engine.submit(T[i]);
+                }));
+            }
+            for(size_t p = 0; p < producers.size(); p++)
+                producers[p].join();
+
+            for(size_t i = 0; i < T.size(); i++)
+            {
+                if(results[i].get() != expected[i])
+                {
+                    detail = to_string(workers[n]) + " workers, batches of " + to_string(batchSizes[b])
+                             + ", input " + to_string(i);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+// same representation and content per memory; bytes may differ, as copied containers drop spare capacity
+bool sameStorage(const WiSARDStats &a, const WiSARDStats &b)
+{
+    if(a.histogram != b.histogram || a.discriminators.size() != b.discriminators.size())
+        return false;
+    for(size_t c = 0; c < a.discriminators.size(); c++)
+    {
+        const DiscriminatorStats &x = a.discriminators[c], &z = b.discriminators[c];
+        if(x.numTrainings != z.numTrainings || x.usedCells != z.usedCells || x.memories.size() != z.memories.size())
+            return false;
+        for(size_t m = 0; m < x.memories.size(); m++)
+            if(x.memories[m].kind != z.memories[m].kind)
+                return false;
+    }
+    return true;
+}
+
+
+// a clone scores exactly like its source, with the same storage, and training it leaves the source
+// unchanged; sources with hashed memories or loaded with mmap included
+bool cloneSource(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 500, 5, 27, X, y);
+    makeData(200, 500, 5, 28, T, yT);
+    string path = "/tmp/libwann_equivalence_" + to_string(getpid()) + ".wann";
+
+    int bits[] = {4, 8, 16, 24};
+    for(int b = 0; b < 4; b++)
+    {
+        for(int variant = 0; variant < 6; variant++)
+        {
+            bool cumulative = variant % 2;
+            WiSARD *source = new WiSARD(500, bits[b], true, 0.1, 1, true, cumulative);
+            source->setSeed(29);
+            if(variant >= 4)
+                source->setHashedMemories(2, 256, 30);
+            source->fit(X, y);
+            if(variant >= 2 && variant < 4)
+            {
+                // loaded with mmap
+                WiSARD *loaded = source->save(path) ? WiSARD::load(path, true) : NULL;
+                delete source;
+                source = loaded;
+            }
+
+            WiSARD *copy = source ? source->clone() : NULL;
+            bool passed = copy != NULL;
+            if(passed)
+            {
+                Probas expected = source->predictProba(T);
+                passed = copy->predictProba(T) == expected && copy->getLabels() == source->getLabels()
+                         && sameStorage(copy->getStats(), source->getStats());
+
+                copy->partialFit(T, yT);
+                passed = passed && source->predictProba(T) == expected;
+            }
+            delete copy;
+            delete source;
+            unlink(path.c_str());
+            if(!passed)
+            {
+                detail = describe(bits[b], cumulative) + (variant >= 4 ? ", hashed" : variant >= 2 ? ", mmap" : "");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+// versions published by a ModelHandle, read by several threads while the writer trains with its own
+// pool, against a network trained serially with the same batches; published versions hold no pool
+bool modelHandleVersions(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(800, 256, 5, 71, X, y);
+    makeData(100, 256, 5, 72, T, yT);
+    const int numBatches = 4;
+    size_t batchSize = X.size() / numBatches;
+
+    WiSARD reference(256, 8, true, 0.1, 1, true, true);
+    reference.setSeed(73);
+    vector<Probas> expected(1, reference.predictProba(T));
+    for(int k = 0; k < numBatches; k++)
+    {
+        reference.partialFit(vector<vector<int>>(X.begin() + k * batchSize, X.begin() + (k + 1) * batchSize),
+                             vector<string>(y.begin() + k * batchSize, y.begin() + (k + 1) * batchSize));
+        expected.push_back(reference.predictProba(T));
+    }
+
+    WiSARD *initial = new WiSARD(256, 8, true, 0.1, 1, true, true);
+    initial->setSeed(73);
+    initial->setNumThreads(4);
+    ModelHandle handle(initial);
+
+    vector<int> mismatches(4, 0);
+    vector<thread> readers;
+    for(int r = 0; r < 4; r++)
+    {
+        readers.push_back(thread([&, r]()
+        {
+            for(long long last = -1; last < numBatches; )
+            {
+                ModelHandle::Snapshot snapshot = handle.acquire();
+                last = snapshot.getVersion();
+                if(snapshot->getThreadPool() || snapshot->predictProba(T) != expected[last])
+                    mismatches[r]++;
+            }
+        }));
+    }
+    for(int k = 0; k < numBatches; k++)
+        handle.partialFit(vector<vector<int>>(X.begin() + k * batchSize, X.begin() + (k + 1) * batchSize),
+                          vector<string>(y.begin() + k * batchSize, y.begin() + (k + 1) * batchSize));
+    for(size_t r = 0; r < readers.size(); r++)
+        readers[r].join();
+
+    for(int r = 0; r < 4; r++)
+    {
+        if(mismatches[r] > 0)
+        {
+            detail = to_string(mismatches[r]) + " mismatching snapshots in reader " + to_string(r);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// sparse retinas against the same inputs as dense retinas: training, scores and labels, including
+// training after a prediction (the cached address-zero contents must be refreshed)
+bool sparseAgainstDense(string &detail)
+{
+    mt19937 rng(31);
+    vector<vector<int>> X(800, vector<int>(600, 0)), T(200, vector<int>(600, 0));
+    vector<string> y(X.size());
+    for(size_t i = 0; i < X.size() + T.size(); i++)
+    {
+        vector<int> &retina = i < X.size() ? X[i] : T[i - X.size()];
+        int c = rng() % 4;
+        // about 3% active positions, concentrated in a band per class
+        for(int k = 0; k < 18; k++)
+            retina[(c * 150 + rng() % 150 + (rng() % 4 == 0 ? rng() % 600 : 0)) % 600] = 1;
+        if(i < X.size())
+            y[i] = to_string(c);
+    }
+    vector<SparseRetina> sparseX(X.begin(), X.end()), sparseT(T.begin(), T.end());
+
+    int bits[] = {4, 8, 16, 24};
+    for(int b = 0; b < 4; b++)
+    {
+        for(int variant = 0; variant < 4; variant++)
+        {
+            bool cumulative = variant % 2, ignoreZeroAddr = variant / 2;
+            WiSARD dense(600, bits[b], true, 0.1, 1, true, cumulative, ignoreZeroAddr);
+            WiSARD sparse(600, bits[b], true, 0.1, 1, true, cumulative, ignoreZeroAddr);
+            dense.setSeed(32);
+            sparse.setSeed(32);
+
+            dense.fit(vector<vector<int>>(X.begin(), X.begin() + 400), vector<string>(y.begin(), y.begin() + 400));
+            sparse.fit(vector<SparseRetina>(sparseX.begin(), sparseX.begin() + 400), vector<string>(y.begin(), y.begin() + 400));
+            bool passed = sparse.predictProba(sparseT) == dense.predictProba(T);
+
+            for(size_t i = 400; i < X.size(); i++)
+            {
+                dense.train(X[i], y[i]);
+                sparse.train(sparseX[i], y[i]);
+            }
+            int numLabels = dense.getNumLabels();
+            vector<float> denseScores(T.size() * numLabels), sparseScores(T.size() * numLabels);
+            dense.predictScores(T, denseScores.data());
+            sparse.predictScores(sparseT, sparseScores.data());
+            passed = passed && sparseScores == denseScores && sparse.predict(sparseT) == dense.predict(T);
+
+            sparse.setNumThreads(4);
+            passed = passed && sparse.predictLabelIndices(sparseT) == dense.predictLabelIndices(T);
+            if(!passed)
+            {
+                detail = describe(bits[b], cumulative) + (ignoreZeroAddr ? ", ignoring address 0" : "");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+// scoring session after each of many flips (some positions repeated) against predictProba of the
+// current input, starting from int, packed and sparse resets
+bool sessionFlips(string &detail)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(600, 500, 5, 33, X, y);
+    makeData(20, 500, 5, 34, T, yT);
+
+    int bits[] = {4, 8, 16};
+    for(int b = 0; b < 3; b++)
+    {
+        for(int variant = 0; variant < 4; variant++)
+        {
+            bool cumulative = variant % 2, ignoreZeroAddr = variant / 2;
+            WiSARD w(500, bits[b], true, 0.1, 1, true, cumulative, ignoreZeroAddr);
+            w.setSeed(35);
+            w.fit(X, y);
+
+            mt19937 rng(36 + variant);
+            ScoringSession session(w);
+            bool passed = true;
+            for(size_t t = 0; passed && t < T.size(); t++)
+            {
+                vector<int> current = T[t];
+                if(t % 3 == 0)
+                    session.reset(current);
+                else if(t % 3 == 1)
+                    session.reset(BitRetina(current));
+                else
+                    session.reset(SparseRetina(current));
+
+                for(int step = 0; passed && step < 50; step++)
+                {
+                    vector<int> positions(1 + rng() % 5);
+                    for(size_t k = 0; k < positions.size(); k++)
+                    {
+                        positions[k] = (k > 0 && rng() % 4 == 0) ? positions[k - 1] : (int) (rng() % 500);
+                        current[positions[k]] ^= 1;
+                    }
+                    session.flip(positions);
+
+                    vector<vector<int>> input(1, current);
+                    passed = session.predictProba() == w.predictProba(input)[0]
+                             && session.predictLabelIndex() == w.predictLabelIndices(input)[0];
+                }
+            }
+            if(!passed)
+            {
+                detail = describe(bits[b], cumulative) + (ignoreZeroAddr ? ", ignoring address 0" : "");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+static const Check CHECKS[] =
+{
+    {"threaded_predict", &threadedPredict},
+    {"threaded_fit", &threadedFit},
+    {"partial_fit_batches", &partialFitBatches},
+    {"save_same_path", &saveSamePath},
+    {"bleaching_reference", &bleachingReference},
+    {"dense_scores", &denseScores},
+    {"csv_loader", &csvLoader},
+    {"label_loader", &labelLoader},
+    {"retina_file", &retinaFile},
+    {"encoder_fused", &encoderFused},
+    {"sweep", &sweepRetrained},
+    {"hashed_zero_address", &hashedZeroAddress},
+    {"count_greater", &countGreaterReference},
+    {"bleaching_calls", &bleachingCalls},
+    {"compressed_file", &compressedFile},
+    {"early_exit", &earlyExitPredict},
+    {"merge_shards", &mergeShards},
+    {"engine_predict", &enginePredict},
+    {"clone", &cloneSource},
+    {"model_handle", &modelHandleVersions},
+    {"sparse_retina", &sparseAgainstDense},
+    {"session_flips", &sessionFlips},
+};
+
+
+int main(int argc, char **argv)
+{
+    int numChecks = sizeof(CHECKS) / sizeof(CHECKS[0]);
+    int numRun = 0, numFailed = 0;
+
+    for(int k = 0; k < numChecks; k++)
+    {
+        bool selected = argc < 2;
+        for(int i = 1; i < argc; i++)
+            selected = selected || strcmp(argv[i], CHECKS[k].name) == 0;
+        if(!selected)
+            continue;
+
+        string detail;
+        bool passed = CHECKS[k].run(detail);
+        numRun++;
+        numFailed += !passed;
+        cout << (passed ? "ok   " : "FAIL ") << CHECKS[k].name;
+        if(!passed && !detail.empty())
+            cout << " (" << detail << ")";
+        cout << endl;
+    }
+
+    cout << numRun - numFailed << " of " << numRun << " checks passed" << endl;
+    return (numFailed == 0 && numRun > 0) ? 0 : 1;
+}
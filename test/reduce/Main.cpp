@@ -0,0 +1,208 @@
+#include "WiSARD.hpp"
+#include "DataLoader.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace wann;
+
+/*
+ * libwann sharded training driver.
+ *
+ * Every shard is trained by its own process (or machine) with the same seed, so all shards share
+ * the input mapping, and saved with WiSARD::save; the shards are then summed by WiSARD::reduce.
+ *
+ * usage: reduce.exe train X.csv y.csv SHARD NUM_SHARDS OUT.wann [--bits N] [--seed S] [--non-cumulative]
+ *            trains the rows i with i % NUM_SHARDS == SHARD
+ *        reduce.exe merge OUT.wann SHARD.wann... [--threads N]
+ *            sums the shards into OUT.wann
+ *        reduce.exe demo [--shards N] [--bits N] [--non-cumulative]
+ *            forks N processes that train shards of a synthetic dataset, reduces them and
+ *            compares the result with a network trained on the whole dataset
+ */
+
+struct Options
+{
+    int numBits;
+    unsigned seed;
+    bool isCummulative;
+    int numThreads;
+    int numShards;
+};
+
+
+// synthetic dataset: noisy copies of one random prototype per class
+void makeData(int numSamples, int retinaLength, int numClasses, unsigned seed,
+              vector<vector<int>> &X, vector<string> &y)
+{
+    mt19937 rng(seed);
+    vector<vector<int>> prototypes(numClasses, vector<int>(retinaLength));
+
+    for(int c = 0; c < numClasses; c++)
+        for(int j = 0; j < retinaLength; j++)
+            prototypes[c][j] = rng() % 2;
+
+    X.clear();
+    y.clear();
+    for(int i = 0; i < numSamples; i++)
+    {
+        int c = rng() % numClasses;
+        vector<int> retina = prototypes[c];
+        for(int j = 0; j < retinaLength; j++)
+            if(rng() % 100 < 10)
+                retina[j] ^= 1;
+        X.push_back(retina);
+        y.push_back(to_string(c));
+    }
+}
+
+
+// trains the rows of one shard with the shared seed and saves the network
+bool trainShard(const vector<vector<int>> &X, const vector<string> &y, int shard, int numShards,
+                const string &outPath, const Options &options)
+{
+    vector<vector<int>> shardX;
+    vector<string> shardY;
+    for(size_t i = shard; i < X.size(); i += numShards)
+    {
+        shardX.push_back(X[i]);
+        shardY.push_back(y[i]);
+    }
+
+    WiSARD w((int) X[0].size(), options.numBits, true, 0.1, 1, true, options.isCummulative);
+    w.setSeed(options.seed);
+    w.fit(shardX, shardY);
+    return w.save(outPath);
+}
+
+
+bool mergeShards(const string &outPath, const vector<string> &shardPaths, const Options &options)
+{
+    WiSARD *w = WiSARD::reduce(shardPaths, options.numThreads);
+    if(w == NULL)
+        return false;
+    bool saved = w->save(outPath);
+    delete w;
+    return saved;
+}
+
+
+int demo(const Options &options)
+{
+    vector<vector<int>> X, T;
+    vector<string> y, yT;
+    makeData(4000, 1024, 10, 1, X, y);
+    makeData(1000, 1024, 10, 2, T, yT);
+
+    vector<string> shardPaths;
+    vector<pid_t> workers;
+    for(int s = 0; s < options.numShards; s++)
+    {
+        string path = "/tmp/libwann_shard_" + to_string(getpid()) + "_" + to_string(s) + ".wann";
+        shardPaths.push_back(path);
+
+        pid_t pid = fork();
+        if(pid == 0)
+            _exit(trainShard(X, y, s, options.numShards, path, options) ? 0 : 1);
+        workers.push_back(pid);
+    }
+
+    bool trained = true;
+    for(size_t s = 0; s < workers.size(); s++)
+    {
+        int status = 0;
+        trained = waitpid(workers[s], &status, 0) == workers[s] && WIFEXITED(status)
+                  && WEXITSTATUS(status) == 0 && trained;
+    }
+
+    WiSARD *reduced = trained ? WiSARD::reduce(shardPaths, options.numThreads) : NULL;
+    for(size_t s = 0; s < shardPaths.size(); s++)
+        unlink(shardPaths[s].c_str());
+    if(reduced == NULL)
+    {
+        cerr << "could not train or reduce the shards" << endl;
+        return 1;
+    }
+
+    WiSARD whole((int) X[0].size(), options.numBits, true, 0.1, 1, true, options.isCummulative);
+    whole.setSeed(options.seed);
+    whole.fit(X, y);
+
+    vector<unordered_map<string, float>> expected = whole.predictProba(T);
+    vector<unordered_map<string, float>> actual = reduced->predictProba(T);
+    int numDifferent = 0;
+    for(size_t i = 0; i < T.size(); i++)
+        numDifferent += (expected[i] != actual[i]);
+
+    cout << "shards: " << options.numShards
+         << ", labels: " << reduced->getNumLabels()
+         << ", inputs with different scores: " << numDifferent << endl;
+    delete reduced;
+    return numDifferent == 0 ? 0 : 1;
+}
+
+
+int main(int argc, char **argv)
+{
+    Options options = {16, 0, true, 0, 4};
+    vector<string> positional;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--bits") == 0 && i + 1 < argc)
+            options.numBits = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            options.seed = (unsigned) strtoul(argv[++i], NULL, 10);
+        else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            options.numThreads = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--shards") == 0 && i + 1 < argc)
+            options.numShards = max(1, atoi(argv[++i]));
+        else if(strcmp(argv[i], "--non-cumulative") == 0)
+            options.isCummulative = false;
+        else
+            positional.push_back(argv[i]);
+    }
+
+    string mode = positional.empty() ? "demo" : positional[0];
+    if(mode == "demo")
+        return demo(options);
+
+    if(mode == "train" && positional.size() == 6)
+    {
+        vector<vector<int>> X;
+        vector<string> y;
+        if(!DataLoader::loadCsv(positional[1], X) || !DataLoader::loadLabels(positional[2], y)
+           || X.empty() || X.size() != y.size())
+        {
+            cerr << "could not load " << positional[1] << " and " << positional[2] << endl;
+            return 1;
+        }
+        int numShards = atoi(positional[4].c_str());
+        int shard = atoi(positional[3].c_str());
+        if(numShards < 1 || shard < 0 || shard >= numShards)
+        {
+            cerr << "invalid shard " << shard << " of " << numShards << endl;
+            return 1;
+        }
+        return trainShard(X, y, shard, numShards, positional[5], options) ? 0 : 1;
+    }
+
+    if(mode == "merge" && positional.size() >= 3)
+    {
+        vector<string> shardPaths(positional.begin() + 2, positional.end());
+        return mergeShards(positional[1], shardPaths, options) ? 0 : 1;
+    }
+
+    cerr << "usage: reduce.exe train X.csv y.csv SHARD NUM_SHARDS OUT.wann [--bits N] [--seed S] [--non-cumulative]" << endl
+         << "       reduce.exe merge OUT.wann SHARD.wann... [--threads N]" << endl
+         << "       reduce.exe demo [--shards N] [--bits N] [--non-cumulative]" << endl;
+    return 1;
+}
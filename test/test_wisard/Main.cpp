@@ -1,4 +1,5 @@
-#include <WiSARD>
+#include "WiSARD.hpp"
+#include "DataLoader.hpp"
 #include <algorithm>
 #include <iostream>
 #include <vector>
@@ -12,62 +13,16 @@
 #include <map>
 
 using namespace std;
+using namespace wann;
 
 
-vector<int> split(string str, char delimiter) 
-{
-    vector<int> internal;
-    stringstream ss(str); // Turn the string into a stream.
-    string tok;
-  
-    while(getline(ss, tok, delimiter)) 
-    {
-        internal.push_back( stoi(tok));
-    }
-  
-    return internal;
-}
-
-
-vector<string> split_str(string str, char delimiter) 
-{
-    vector<string> internal;
-    stringstream ss(str); // Turn the string into a stream.
-    string tok;
-  
-    while(getline(ss, tok, delimiter)) 
-    {
-        internal.push_back( tok );
-    }
-
-    return internal;
-}
-
 tuple< vector<vector<int>>, vector<string>> loadData(string XFile, string yFile)
 {
- 
-    string line;
-
-    ifstream input(XFile);
-    ifstream annotation (yFile);
-
     vector<vector<int>> X;
     vector<string> y;
 
-    //reading X
-    if (input.is_open())
-    {
-        while(getline(input, line))
-        {
-            X.push_back(split(line, ','));
-        }
-
-        input.close();
-    }
-
-    //reading y
-    getline(annotation, line);
-    y = split_str(line, ',');
+    DataLoader::loadCsv(XFile, X);
+    DataLoader::loadLabels(yFile, y);
 
     return make_tuple(X,y);
 }